@@ -0,0 +1,157 @@
+/**
+	\file
+	\brief
+		This is the source file for the board configuration. It has the tables of the pins,
+		interruptions and peripheral clocks of the project, and the pass that applies them.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "BRDCFG.h"
+#include "GPIO.h"
+#include "NVIC.h"
+#include "CLKMGR.h"
+#include "TMRWHL.h"
+#include "MTRCTRL.h"
+#include "MTRSCH.h"
+#include "GlobalFunctions.h"
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*Ports that can be configured (GPIOA to GPIOE)*/
+#define BOARDCONFIG_PORTS (GPIOE + 1)
+/*Clock gating of the peripherals used by the processes: PIT (wave generator, timer wheel and motor
+ * control loop), PDB (wave generator), DMA (wave generator and motor ramps), FTM0 (motor PWM) and
+ * FTM1 (motor encoder); The DACs are gated by DAC_init*/
+#define BOARDCONFIG_SCGC6 (SIM_SCGC6_PIT_MASK | SIM_SCGC6_PDB_MASK | SIM_SCGC6_DMAMUX_MASK | SIM_SCGC6_FTM0_MASK | SIM_SCGC6_FTM1_MASK)
+#define BOARDCONFIG_SCGC7 (SIM_SCGC7_DMA_MASK)
+
+/*Clock gating of each port, indexed by GPIO_portNameType*/
+static const uint32 portClockGating[BOARDCONFIG_PORTS] = {
+		GPIO_CLOCK_GATING_PORTA, GPIO_CLOCK_GATING_PORTB, GPIO_CLOCK_GATING_PORTC,
+		GPIO_CLOCK_GATING_PORTD, GPIO_CLOCK_GATING_PORTE
+};
+
+/*Pins of the board*/
+static const BOARDCONFIG_PinType pins[] = {
+		/*SW3, wave generator; Pull up, falling edge*/
+		{GPIOA, BIT4,  GPIO_MUX1|GPIO_PS|GPIO_PE|INTR_FALLING_EDGE, GPIO_INPUT, BIT_OFF, GPIO_DEBOUNCE_MS(30)},
+		/*Motor encoder, phases A and B of the FTM1 quadrature decoder (ALT6)*/
+		{GPIOB, BIT0,  GPIO_MUX6, GPIO_INPUT, BIT_OFF, 0},
+		{GPIOB, BIT1,  GPIO_MUX6, GPIO_INPUT, BIT_OFF, 0},
+		/*Keyboard data lines (MM74C922 D, C, B, A)*/
+		{GPIOB, BIT2,  GPIO_MUX1, GPIO_INPUT, BIT_OFF, 0},
+		{GPIOB, BIT3,  GPIO_MUX1, GPIO_INPUT, BIT_OFF, 0},
+		{GPIOB, BIT10, GPIO_MUX1, GPIO_INPUT, BIT_OFF, 0},
+		{GPIOB, BIT11, GPIO_MUX1, GPIO_INPUT, BIT_OFF, 0},
+		/*Keyboard data available, rising edge; The encoder debounces the keys, the lockout only
+		 * discards glitches*/
+		{GPIOB, BIT20, GPIO_MUX1|INTR_RISING_EDGE, GPIO_INPUT, BIT_OFF, GPIO_DEBOUNCE_LOCKOUT|GPIO_DEBOUNCE_MS(50)},
+		/*Password LEDs, incorrect and correct*/
+		{GPIOB, BIT18, GPIO_MUX1, GPIO_OUTPUT, BIT_OFF, 0},
+		{GPIOB, BIT19, GPIO_MUX1, GPIO_OUTPUT, BIT_OFF, 0},
+		/*LED RGB blue and red, turned off (active low)*/
+		{GPIOB, BIT21, GPIO_MUX1, GPIO_OUTPUT, BIT_ON, 0},
+		{GPIOB, BIT22, GPIO_MUX1, GPIO_OUTPUT, BIT_ON, 0},
+		/*Motor output, driven by the FTM0 channel 0 (ALT4)*/
+		{GPIOC, BIT1,  GPIO_MUX4, GPIO_OUTPUT, BIT_OFF, 0},
+#if MOTORCONTROL_MOTORS > 1
+		/*Auxiliary motor output, driven by the FTM0 channel 1 (ALT4)*/
+		{GPIOC, BIT2,  GPIO_MUX4, GPIO_OUTPUT, BIT_OFF, 0},
+#endif
+		/*SW2, motor control; Pull up, falling edge*/
+		{GPIOC, BIT6,  GPIO_MUX1|GPIO_PS|GPIO_PE|INTR_FALLING_EDGE, GPIO_INPUT, BIT_OFF, GPIO_DEBOUNCE_MS(30)},
+#if MOTORCONTROL_MOTORS > 1
+		/*Auxiliary motor LEDs 1 and 2*/
+		{GPIOC, BIT8,  GPIO_MUX1, GPIO_OUTPUT, BIT_OFF, 0},
+		{GPIOC, BIT9,  GPIO_MUX1, GPIO_OUTPUT, BIT_OFF, 0},
+#endif
+		/*Wave generator LEDs 1 and 2*/
+		{GPIOC, BIT10, GPIO_MUX1, GPIO_OUTPUT, BIT_OFF, 0},
+		{GPIOC, BIT11, GPIO_MUX1, GPIO_OUTPUT, BIT_OFF, 0},
+		/*Motor control LEDs 1 and 2*/
+		{GPIOC, BIT16, GPIO_MUX1, GPIO_OUTPUT, BIT_OFF, 0},
+		{GPIOC, BIT17, GPIO_MUX1, GPIO_OUTPUT, BIT_OFF, 0},
+		/*LED RGB green, turned off (active low)*/
+		{GPIOE, BIT26, GPIO_MUX1, GPIO_OUTPUT, BIT_ON, 0}
+};
+
+/*Interruptions of the board; The priorities must match the ones given to EVENTQUEUE_setHandler*/
+static const BOARDCONFIG_InterruptType interrupts[] = {
+		/*Keyboard, always on*/
+		{PORTB_IRQ, PRIORITY_6, TRUE},
+		/*Timer wheel, always on; PIT2 is started by the first timer*/
+		{PIT_CH2_IRQ, TIMERWHEEL_PRIORITY, TRUE},
+		/*Wave generator: samples, SW3 and buffer refill*/
+		{PIT_CH0_IRQ, PRIORITY_9, FALSE},
+		{PORTA_IRQ, PRIORITY_10, FALSE},
+		{DAC0_IRQ, PRIORITY_9, FALSE},
+		/*Motor control: SW2, the control loop and the motor scheduler (PIT1 and PIT3 are started
+		 * by the motors)*/
+		{PORTC_IRQ, PRIORITY_9, FALSE},
+		{PIT_CH1_IRQ, MOTORCONTROL_CONTROL_PRIORITY, TRUE},
+		{PIT_CH3_IRQ, MOTORSCHEDULER_PRIORITY, TRUE}
+};
+
+/*Running time of the core at BOARDCONFIG_init, and boot time (ns)*/
+static uint32 bootStart = 0;
+static uint32 bootNanoseconds = 0;
+
+void BOARDCONFIG_init(){
+	uint32 scgc5 = 0;
+	uint32 outputs[BOARDCONFIG_PORTS] = {0};
+	uint32 levels[BOARDCONFIG_PORTS] = {0};
+	uint8 index;
+	uint8 port;
+
+	/*The boot goes through the reset, 120MHz and VLPR clocks (CLOCKMANAGER_init and
+	 * POWERGOVERNOR_init), so the time is counted with each one*/
+	cycleCounterInit();
+	bootStart = CLOCKMANAGER_coreNanoseconds();
+
+	/*Clock gating of the ports and the peripherals, a single write for each register*/
+	for(index = 0; index < sizeof(pins)/sizeof(pins[0]); index++){
+		scgc5 |= portClockGating[pins[index].port];
+	}
+	SIM_SCGC5 |= scgc5;
+	SIM->SCGC6 |= BOARDCONFIG_SCGC6;
+	SIM->SCGC7 |= BOARDCONFIG_SCGC7;
+
+	/*Pin control registers and debouncing; The levels and directions are gathered by port*/
+	for(index = 0; index < sizeof(pins)/sizeof(pins[0]); index++){
+		GPIO_pinControlRegister(pins[index].port, pins[index].pin, &pins[index].pinControl);
+		if(pins[index].debounce){
+			GPIO_debounceConfig(pins[index].port, pins[index].pin, &pins[index].debounce);
+		}
+		if(pins[index].direction == GPIO_OUTPUT){
+			outputs[pins[index].port] |= GPIO_PIN_MASK(pins[index].pin);
+			if(pins[index].level){
+				levels[pins[index].port] |= GPIO_PIN_MASK(pins[index].pin);
+			}
+		}
+	}
+
+	/*The levels are written before the directions, so each output starts with its value*/
+	for(port = 0; port < BOARDCONFIG_PORTS; port++){
+		if(outputs[port]){
+			GPIO_writePINS((GPIO_portNameType)port, outputs[port], levels[port]);
+			GPIO_dataDirectionPORT((GPIO_portNameType)port, outputs[port]);
+		}
+	}
+
+	for(index = 0; index < sizeof(interrupts)/sizeof(interrupts[0]); index++){
+		if(interrupts[index].enabled){
+			NVIC_enableInterruptAndPriority(interrupts[index].interrupt, interrupts[index].priority);
+		} else {
+			NVIC_SetPriority(interrupts[index].interrupt, interrupts[index].priority);
+		}
+	}
+}
+
+void BOARDCONFIG_ready(){
+	bootNanoseconds = CLOCKMANAGER_coreNanoseconds() - bootStart;
+}
+
+uint32 BOARDCONFIG_bootNanoseconds(){
+	return bootNanoseconds;
+}
@@ -0,0 +1,82 @@
+/**
+	\file
+	\brief
+		This is the header file for the board configuration. The pins used by the processes
+		(RGB LED, keyboard, SW2, SW3, LEDs and motor output), their interruptions and the clock
+		gating of the peripherals are described in constant tables (BRDCFG.c), that are
+		applied in one pass at the start of main:
+			- The clock gating of all the ports and peripherals is written once per register.
+			- Each PCR is written once, with its mux, pull resistor and interruption edge.
+			- The initial levels and the directions are written once per port (PSOR/PCOR and
+			  PDDR), levels first, so the outputs start with a safe value.
+			- The NVIC priorities are set, and the interruptions that are always on are enabled.
+		The processes only register their event handlers and configure their peripherals.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_BRDCFG_H_
+#define SOURCES_BRDCFG_H_
+
+#include "DataTypeDefinitions.h"
+#include "GPIO.h"
+#include "NVIC.h"
+
+/*Struct that contains the configuration of a pin*/
+typedef struct{
+	/*port, of the pin*/
+	GPIO_portNameType port;
+	/*pin, number in the port*/
+	uint8 pin;
+	/*pinControl, PCR value: mux, pull resistor and interruption (GPIO_MUX1, GPIO_PE, INTR_...)*/
+	uint32 pinControl;
+	/*direction, GPIO_INPUT or GPIO_OUTPUT*/
+	uint8 direction;
+	/*level, initial value of an output (BIT_ON or BIT_OFF)*/
+	uint8 level;
+	/*debounce, configuration of an input (GPIO_DEBOUNCE_MS, GPIO_DEBOUNCE_LOCKOUT), 0 if none*/
+	uint32 debounce;
+}BOARDCONFIG_PinType;
+
+/*Struct that contains the configuration of an interruption*/
+typedef struct{
+	/*interrupt, number*/
+	InterruptType interrupt;
+	/*priority, of the interruption*/
+	PriorityLevelType priority;
+	/*enabled, TRUE if it is enabled at the start; Otherwise, its process enables it*/
+	BooleanType enabled;
+}BOARDCONFIG_InterruptType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function applies the board configuration tables, and starts the cycle
+ 	 	 counter to measure the boot time. It must be the first function called in main.
+ 	 \return void
+ */
+void BOARDCONFIG_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function records the boot time; It is called in main, when the processes
+ 	 	 are initialized, right before the interruptions are enabled.
+ 	 \return void
+ */
+void BOARDCONFIG_ready();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the boot time, from BOARDCONFIG_init to BOARDCONFIG_ready,
+ 	 	 with the cycles of each core clock converted with that clock (CLOCKMANAGER_coreNanoseconds).
+ 	 	 The startup code before main isn't included.
+ 	 \return Boot time (ns)
+ */
+uint32 BOARDCONFIG_bootNanoseconds();
+
+#endif /* SOURCES_BRDCFG_H_ */
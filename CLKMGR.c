@@ -0,0 +1,273 @@
+/**
+	\file
+	\brief
+		This is the source file for the clock manager. The MCG can't go directly from FEI to
+		PEE: the external clock is selected first (FBE), then the PLL is enabled and locked
+		while the MCG output is still the external clock (PBE), and at last the PLL output is
+		selected (PEE). The VLPR mode can only be entered in BLPI mode (the fast internal
+		reference, with the FLL and the PLL disabled), and it is left before the MCG leaves
+		BLPI. The SIM dividers are always changed while the MCG output is the lowest of both
+		profiles, so the core, bus and flash clocks never exceed their maximums.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "CLKMGR.h"
+#include "GlobalFunctions.h"
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*FLL output in FEI mode: slow internal reference (32.768kHz) multiplied by 640*/
+#define FLL_CLOCK 20971520
+/*External clock of the board (EXTAL0), and internal references*/
+#define EXTERNAL_CLOCK 50000000
+#define FAST_IRC_CLOCK 4000000
+#define SLOW_IRC_CLOCK 32768
+/*Clock source of the MCG output (C1[CLKS] and S[CLKST])*/
+#define CLKS_FLL_PLL 0
+#define CLKS_INTERNAL 1
+#define CLKS_EXTERNAL 2
+#define CLKST_FLL 0
+#define CLKST_INTERNAL 1
+#define CLKST_EXTERNAL 2
+#define CLKST_PLL 3
+/*Frequency range of the external clock: very high (8 to 32MHz and above, for external clocks)*/
+#define EXTERNAL_RANGE_VERY_HIGH 2
+/*FLL external reference divider 1280: 50MHz/1280 = 39kHz, in the range of the FLL, even if the
+ * FLL isn't used in FBE mode*/
+#define EXTERNAL_FRDIV_1280 7
+/*PLL: 50MHz/20 = 2.5MHz reference (2 to 4MHz), multiplied by 48 (VDIV0 + 24) = 120MHz*/
+#define PLL_PRDIV_20 19
+#define PLL_VDIV_48 24
+#define PLL_VDIV_OFFSET 24
+/*Fast internal reference without division, 4MHz*/
+#define FAST_IRC_DIVIDER_1 0
+/*Run modes of the SMC (PMCTRL[RUNM]), and the status of VLPR (PMSTAT)*/
+#define RUN_MODE_RUN 0
+#define RUN_MODE_VLPR 2
+#define PMSTAT_RUN 0x01
+#define PMSTAT_VLPR 0x04
+
+/*Clock profiles, indexed by CLOCKMANAGER_ProfileType*/
+static const CLOCKMANAGER_ProfileConfigType profiles[CLOCKMANAGER_PROFILES] = {
+		/*FEI, the reset dividers: core and bus /1, FlexBus and flash /2*/
+		{CLOCKMANAGER_MODE_FEI, FALSE,
+				SIM_CLKDIV1_OUTDIV1(0) | SIM_CLKDIV1_OUTDIV2(0) | SIM_CLKDIV1_OUTDIV3(1) | SIM_CLKDIV1_OUTDIV4(1),
+				FLL_CLOCK, FLL_CLOCK, FLL_CLOCK/2},
+		/*PEE: core /1, bus /2, FlexBus /3, flash /5*/
+		{CLOCKMANAGER_MODE_PEE, FALSE,
+				SIM_CLKDIV1_OUTDIV1(0) | SIM_CLKDIV1_OUTDIV2(1) | SIM_CLKDIV1_OUTDIV3(2) | SIM_CLKDIV1_OUTDIV4(4),
+				120000000, 60000000, 24000000},
+		/*BLPI and VLPR: core, bus and FlexBus /1, flash /5*/
+		{CLOCKMANAGER_MODE_BLPI, TRUE,
+				SIM_CLKDIV1_OUTDIV1(0) | SIM_CLKDIV1_OUTDIV2(0) | SIM_CLKDIV1_OUTDIV3(0) | SIM_CLKDIV1_OUTDIV4(4),
+				FAST_IRC_CLOCK, FAST_IRC_CLOCK, FAST_IRC_CLOCK/5}
+};
+
+/*Current profile; The MCU starts in FEI mode*/
+static CLOCKMANAGER_ProfileType currentProfile = CLOCKMANAGER_FEI_21MHZ;
+/*Functions called after a clock change*/
+static void (*listeners[CLOCKMANAGER_LISTENERS])();
+static uint8 listenerCount = 0;
+/*Duration of a change: cycle counter and core clock at the start of the current step, and
+ * time of the previous steps; The cycle counter starts from 0 with the reset clock*/
+static uint32 stepStart = 0;
+static uint32 stepClock = FLL_CLOCK;
+static uint32 changeNanoseconds;
+static uint32 changeMicroseconds = 0;
+/*Running time of the core, the steps before the current one (ns)*/
+static uint32 coreNanoseconds = 0;
+
+static uint8 CLOCKMANAGER_clockStatus(){
+	return (MCG->S & MCG_S_CLKST_MASK) >> MCG_S_CLKST_SHIFT;
+}
+
+static uint32 CLOCKMANAGER_mcgCoreClock(){
+	/*Core clock given by the MCG output selected now, and the core divider*/
+	uint32 mcgOutput;
+	switch(CLOCKMANAGER_clockStatus()){
+		case CLKST_PLL:
+			mcgOutput = (EXTERNAL_CLOCK/((MCG->C5 & MCG_C5_PRDIV0_MASK) + 1))*((MCG->C6 & MCG_C6_VDIV0_MASK) + PLL_VDIV_OFFSET);
+			break;
+		case CLKST_EXTERNAL:
+			mcgOutput = EXTERNAL_CLOCK;
+			break;
+		case CLKST_INTERNAL:
+			mcgOutput = (MCG->S & MCG_S_IRCST_MASK)?(FAST_IRC_CLOCK >> ((MCG->SC & MCG_SC_FCRDIV_MASK) >> MCG_SC_FCRDIV_SHIFT)):(SLOW_IRC_CLOCK);
+			break;
+		default:
+			mcgOutput = FLL_CLOCK;
+			break;
+	}
+	return mcgOutput/(((SIM->CLKDIV1 & SIM_CLKDIV1_OUTDIV1_MASK) >> SIM_CLKDIV1_OUTDIV1_SHIFT) + 1);
+}
+
+static void CLOCKMANAGER_step(){
+	/*The cycles since the previous step were counted with the core clock of that step*/
+	uint32 cycles = cycleCounter();
+	uint32 nanoseconds = (uint32)(((uint64)(cycles - stepStart)*1000000000ULL)/stepClock);
+	changeNanoseconds += nanoseconds;
+	coreNanoseconds += nanoseconds;
+	stepStart = cycles;
+	stepClock = CLOCKMANAGER_mcgCoreClock();
+}
+
+static void CLOCKMANAGER_setDividers(CLOCKMANAGER_ProfileType profile){
+	SIM->CLKDIV1 = profiles[profile].clockDividers;
+	CLOCKMANAGER_step();
+}
+
+static void CLOCKMANAGER_selectPll(){
+	/*PBE to PEE: the PLL is locked, and its output is selected*/
+	while(!(MCG->S & MCG_S_LOCK0_MASK)){
+	}
+	MCG->C1 = (MCG->C1 & ~MCG_C1_CLKS_MASK) | MCG_C1_CLKS(CLKS_FLL_PLL);
+	while(CLOCKMANAGER_clockStatus() != CLKST_PLL){
+	}
+}
+
+static void CLOCKMANAGER_leavePee(){
+	/*PEE to PBE: the external clock is the MCG output again*/
+	MCG->C1 = (MCG->C1 & ~MCG_C1_CLKS_MASK) | MCG_C1_CLKS(CLKS_EXTERNAL);
+	while(CLOCKMANAGER_clockStatus() != CLKST_EXTERNAL){
+	}
+	CLOCKMANAGER_step();
+	/*PBE to FBE: the PLL is disabled*/
+	MCG->C6 &= ~MCG_C6_PLLS_MASK;
+	while(MCG->S & MCG_S_PLLST_MASK){
+	}
+}
+
+static void CLOCKMANAGER_leaveBlpi(){
+	/*VLPR to RUN, that is needed to leave BLPI; Then BLPI to FBI*/
+	SMC_PMCTRL = (SMC_PMCTRL & ~SMC_PMCTRL_RUNM_MASK) | SMC_PMCTRL_RUNM(RUN_MODE_RUN);
+	while(SMC_PMSTAT != PMSTAT_RUN){
+	}
+	MCG->C2 &= ~MCG_C2_LP_MASK;
+}
+
+static void CLOCKMANAGER_toPee(){
+	/*FEI, FBI or FBE to FBE: the external clock (no crystal, EREFS = 0) is the MCG output and
+	 * the FLL reference*/
+	MCG->C7 &= ~MCG_C7_OSCSEL_MASK;
+	MCG->C2 = (MCG->C2 & ~(MCG_C2_RANGE_MASK | MCG_C2_EREFS_MASK)) | MCG_C2_RANGE(EXTERNAL_RANGE_VERY_HIGH);
+	MCG->C1 = MCG_C1_CLKS(CLKS_EXTERNAL) | MCG_C1_FRDIV(EXTERNAL_FRDIV_1280);
+	while((MCG->S & MCG_S_IREFST_MASK) || CLOCKMANAGER_clockStatus() != CLKST_EXTERNAL){
+	}
+	CLOCKMANAGER_step();
+	/*FBE to PBE: the PLL is enabled, and the MCG output is still the external clock*/
+	MCG->C5 = MCG_C5_PRDIV0(PLL_PRDIV_20);
+	MCG->C6 = MCG_C6_PLLS_MASK | MCG_C6_VDIV0(PLL_VDIV_48);
+	while(!(MCG->S & MCG_S_PLLST_MASK)){
+	}
+	CLOCKMANAGER_selectPll();
+	CLOCKMANAGER_step();
+}
+
+static void CLOCKMANAGER_toFei(){
+	/*FBE or FBI to FEI: the FLL, with the slow internal reference*/
+	MCG->C1 = MCG_C1_CLKS(CLKS_FLL_PLL) | MCG_C1_IREFS_MASK;
+	while(!(MCG->S & MCG_S_IREFST_MASK) || CLOCKMANAGER_clockStatus() != CLKST_FLL){
+	}
+	CLOCKMANAGER_step();
+}
+
+static void CLOCKMANAGER_toBlpi(){
+	/*FEI or FBE to FBI: the fast internal reference, without division*/
+	MCG->SC = (MCG->SC & ~MCG_SC_FCRDIV_MASK) | MCG_SC_FCRDIV(FAST_IRC_DIVIDER_1);
+	MCG->C2 |= MCG_C2_IRCS_MASK;
+	while(!(MCG->S & MCG_S_IRCST_MASK)){
+	}
+	MCG->C1 = MCG_C1_CLKS(CLKS_INTERNAL) | MCG_C1_IREFS_MASK;
+	while(!(MCG->S & MCG_S_IREFST_MASK) || CLOCKMANAGER_clockStatus() != CLKST_INTERNAL){
+	}
+	CLOCKMANAGER_step();
+	/*FBI to BLPI: the FLL is disabled*/
+	MCG->C2 |= MCG_C2_LP_MASK;
+}
+
+void CLOCKMANAGER_init(CLOCKMANAGER_ProfileType profile){
+	CLOCKMANAGER_setProfile(profile);
+}
+
+void CLOCKMANAGER_setProfile(CLOCKMANAGER_ProfileType profile){
+	uint8 listener;
+
+	if(profile >= CLOCKMANAGER_PROFILES || profile == currentProfile){
+		return;
+	}
+	/*The cycles until now were counted with the current core clock*/
+	CLOCKMANAGER_step();
+	changeNanoseconds = 0;
+
+	/*The current mode is left to FEI, FBE or FBI, where the MCG output isn't above 50MHz*/
+	if(profiles[currentProfile].mode == CLOCKMANAGER_MODE_PEE){
+		CLOCKMANAGER_leavePee();
+	} else if(profiles[currentProfile].mode == CLOCKMANAGER_MODE_BLPI){
+		CLOCKMANAGER_leaveBlpi();
+	}
+
+	if(profiles[profile].mode == CLOCKMANAGER_MODE_PEE){
+		/*The dividers of the faster profile are set before the PLL is selected*/
+		CLOCKMANAGER_setDividers(profile);
+		CLOCKMANAGER_toPee();
+	} else if(profiles[profile].mode == CLOCKMANAGER_MODE_BLPI){
+		/*The dividers of the slower profiles are set after the MCG output is lowered; VLPR is
+		 * entered with the VLPR clocks*/
+		CLOCKMANAGER_toBlpi();
+		CLOCKMANAGER_setDividers(profile);
+		SMC_PMCTRL = (SMC_PMCTRL & ~SMC_PMCTRL_RUNM_MASK) | SMC_PMCTRL_RUNM(RUN_MODE_VLPR);
+		while(SMC_PMSTAT != PMSTAT_VLPR){
+		}
+	} else {
+		CLOCKMANAGER_toFei();
+		CLOCKMANAGER_setDividers(profile);
+	}
+	currentProfile = profile;
+
+	for(listener = 0; listener < listenerCount; listener++){
+		listeners[listener]();
+	}
+	CLOCKMANAGER_step();
+	changeMicroseconds = changeNanoseconds/1000;
+}
+
+CLOCKMANAGER_ProfileType CLOCKMANAGER_profile(){
+	return currentProfile;
+}
+
+uint32 CLOCKMANAGER_changeMicroseconds(){
+	return changeMicroseconds;
+}
+
+uint32 CLOCKMANAGER_coreNanoseconds(){
+	CLOCKMANAGER_step();
+	return coreNanoseconds;
+}
+
+BooleanType CLOCKMANAGER_addListener(void(*listener)()){
+	if(listenerCount >= CLOCKMANAGER_LISTENERS){
+		return FALSE;
+	}
+	listeners[listenerCount++] = listener;
+	return TRUE;
+}
+
+void CLOCKMANAGER_wakeUp(){
+	/*The stop modes leave the MCG in PBE mode, with the PLL enabled*/
+	if(profiles[currentProfile].mode == CLOCKMANAGER_MODE_PEE && CLOCKMANAGER_clockStatus() != CLKST_PLL){
+		CLOCKMANAGER_selectPll();
+	}
+}
+
+uint32 CLOCKMANAGER_coreClock(){
+	return profiles[currentProfile].coreClock;
+}
+
+uint32 CLOCKMANAGER_busClock(){
+	return profiles[currentProfile].busClock;
+}
+
+uint32 CLOCKMANAGER_flashClock(){
+	return profiles[currentProfile].flashClock;
+}
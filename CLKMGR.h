@@ -0,0 +1,166 @@
+/**
+	\file
+	\brief
+		This is the header file for the clock manager. It configures the MCG and the clock
+		dividers of the SIM (SIM_CLKDIV1) with a clock profile, and publishes the resulting
+		core, bus and flash clocks; The modules that count with a clock (PIT, PDB, cycle
+		counter) take its frequency from here, instead of a constant.
+			- FEI: the FLL with the slow internal reference (32.768kHz x 640), the reset mode;
+			  20.97MHz core and bus clocks.
+			- PEE: the PLL with the 50MHz external clock of the board (EXTAL0, the clock of the
+			  Ethernet PHY of the FRDM-K64F) divided by 20 and multiplied by 48; 120MHz core,
+			  60MHz bus and 24MHz flash clocks, the maximum of the K64 in RUN mode.
+			- BLPI: the 4MHz fast internal reference, with the FLL and the PLL disabled, in the
+			  very low power run mode (VLPR); 4MHz core and bus, and 800kHz flash clocks, the
+			  maximum of the K64 in VLPR mode.
+		The profile can be changed at run time: the modules that depend on the bus clock
+		register a function that is called after each change, and load their timers again.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_CLKMGR_H_
+#define SOURCES_CLKMGR_H_
+
+#include "DataTypeDefinitions.h"
+
+/*Functions that can be called after a clock change*/
+#define CLOCKMANAGER_LISTENERS 4
+
+/*! This enumerated constant are used to select a clock profile*/
+typedef enum {CLOCKMANAGER_FEI_21MHZ,  /*!< FLL, internal reference: 20.97MHz core and bus */
+			  CLOCKMANAGER_PEE_120MHZ, /*!< PLL, external clock: 120MHz core, 60MHz bus, 24MHz flash */
+			  CLOCKMANAGER_VLPR_4MHZ,  /*!< Fast internal reference, VLPR: 4MHz core and bus, 800kHz flash */
+			  CLOCKMANAGER_PROFILES
+			 }CLOCKMANAGER_ProfileType;
+
+/*! This enumerated constant are used to select a mode of the MCG*/
+typedef enum {CLOCKMANAGER_MODE_FEI,  /*!< FLL engaged, internal reference */
+			  CLOCKMANAGER_MODE_PEE,  /*!< PLL engaged, external clock */
+			  CLOCKMANAGER_MODE_BLPI  /*!< Internal reference bypassed, low power (FLL and PLL disabled) */
+			 }CLOCKMANAGER_McgModeType;
+
+/*Struct that contains a clock profile*/
+typedef struct{
+	/*mode, of the MCG*/
+	CLOCKMANAGER_McgModeType mode;
+	/*veryLowPower, TRUE if the MCU runs in VLPR mode; Otherwise, it runs in RUN mode*/
+	BooleanType veryLowPower;
+	/*clockDividers, SIM_CLKDIV1 value: core (OUTDIV1), bus (OUTDIV2), FlexBus (OUTDIV3) and
+	 * flash (OUTDIV4) dividers of the MCG output*/
+	uint32 clockDividers;
+	/*coreClock, busClock and flashClock, in Hz*/
+	uint32 coreClock;
+	uint32 busClock;
+	uint32 flashClock;
+}CLOCKMANAGER_ProfileConfigType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function brings the MCU up with a clock profile. It must be called at the
+ 	 	 start of main, before the timers are configured.
+ 	 \param[in] profile Clock profile
+ 	 \return void
+ */
+void CLOCKMANAGER_init(CLOCKMANAGER_ProfileType profile);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function changes the clock profile, going through the MCG modes in the
+ 	 	 order required by the K64 (FEI, FBE, PBE, PEE, or FBI and BLPI), and entering or
+ 	 	 leaving the VLPR mode; Then it calls the registered functions with the new clocks. It
+ 	 	 waits for the MCG in each step, so it isn't called from an interruption. The VLPR mode
+ 	 	 must be allowed before (IDLEMANAGER_init).
+ 	 \param[in] profile Clock profile
+ 	 \return void
+ */
+void CLOCKMANAGER_setProfile(CLOCKMANAGER_ProfileType profile);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the duration of the last profile change, from the first
+ 	 	 register write to the end of the registered functions. It is measured with the cycle
+ 	 	 counter, and each step is converted with the core clock it ran with.
+ 	 \return Duration of the last change (us)
+ */
+uint32 CLOCKMANAGER_changeMicroseconds();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the running time of the core, measured with the cycle counter;
+ 	 	 The cycles counted with each core clock are converted with that clock, so an interval
+ 	 	 can span clock changes. The cycle counter must be enabled, and this function must be
+ 	 	 called at least once each 2^32 cycles (35 s at 120MHz). The time doesn't advance while
+ 	 	 the core sleeps, and only the difference between two values, as uint32, is meaningful
+ 	 	 (up to 4.29 s).
+ 	 \return Running time of the core (ns)
+ */
+uint32 CLOCKMANAGER_coreNanoseconds();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the current clock profile
+ 	 \return Clock profile
+ */
+CLOCKMANAGER_ProfileType CLOCKMANAGER_profile();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function registers a function that is called after each clock change, to
+ 	 	 load again the timers counted with the bus clock.
+ 	 \param[in] listener Function called after the change; The new clocks can be read in it
+ 	 \return TRUE if there was space for the function
+ */
+BooleanType CLOCKMANAGER_addListener(void(*listener)());
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function restores the PEE mode after a stop mode: the MCG leaves the stop
+ 	 	 modes in PBE mode if it entered them in PEE mode. It is called right after the wake up,
+ 	 	 before the interruptions are attended. The clocks don't change.
+ 	 \return void
+ */
+void CLOCKMANAGER_wakeUp();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the core clock, that clocks the cycle counter
+ 	 \return Core clock (Hz)
+ */
+uint32 CLOCKMANAGER_coreClock();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the bus clock, that clocks the PIT and the PDB
+ 	 \return Bus clock (Hz)
+ */
+uint32 CLOCKMANAGER_busClock();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the flash clock
+ 	 \return Flash clock (Hz)
+ */
+uint32 CLOCKMANAGER_flashClock();
+
+#endif /* SOURCES_CLKMGR_H_ */
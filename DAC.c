@@ -1,9 +1,9 @@
 /**
 	\file
 	\brief
-		This is the source file for the DAC in the Kinetis 64F. Includes the needed
-		functions to use the DAC0 (initialize, enable, disable, loadValues). The
-		output of the DAC, is DAC0_OUT
+		This is the source file for the DACs in the Kinetis 64F. Includes the needed
+		functions to use the DAC0 and the DAC1 (initialize, enable, disable, loadValues),
+		and their 16 words data buffer. The outputs of the DACs, are DAC0_OUT and DAC1_OUT
 	\author Patricio Gomez Garca
 	\date	22/09/2016
  */
@@ -11,40 +11,111 @@
 #include "MK64F12.h"
 #include "DAC.h"
 #include "DataTypeDefinitions.h"
+#include "WVGN.h"
+#include "PRFL.h"
+#include "GlobalFunctions.h"
 
+/*Clock gating bit in System Clock Gating 2 of each DAC, indexed by DAC_NameType*/
+static const uint32 DAC_clockGating[] = {DAC0_CLOCK_GATING, DAC1_CLOCK_GATING};
 
-void DAC_init(){
+void DAC_init(DAC_NameType dacName){
 
-	/*Enable the clock gating in System Clock Gating 2 for DAC0*/
-	SIM_SCGC2 |= DAC0_CLOCK_GATING;
+	/*Enable the clock gating in System Clock Gating 2 for the DAC*/
+	SIM_SCGC2 |= DAC_clockGating[dacName];
 
-	/*Enable the DAC0_C0, and set DACREF2 as the reference voltage*/
-	DAC0_C0 = DAC_ENABLE | DAC_REFERENCE_SELECT;
+	/*Enable the DAC (C0), and set DACREF2 as the reference voltage*/
+	DAC_base[dacName]->C0 = DAC_ENABLE | DAC_REFERENCE_SELECT;
 
 	/*Load an initial value of 0, in the DAC output*/
-	DAC_loadValues(FALSE);
+	DAC_loadValues(dacName,FALSE);
 }
 
-void DAC_enable(){
-	/*Enable the DAC0_C0*/
-	DAC0_C0 |= DAC_ENABLE;
+void DAC_enable(DAC_NameType dacName){
+	/*Enable the DAC (C0)*/
+	DAC_base[dacName]->C0 |= DAC_ENABLE;
 }
 
 
-void DAC_disable(){
-	/*Disable the DAC0_C0*/
-	DAC0_C0 &= ~(DAC_ENABLE);
+void DAC_disable(DAC_NameType dacName){
+	/*Disable the DAC (C0)*/
+	DAC_base[dacName]->C0 &= ~(DAC_ENABLE);
 }
 
 
-void DAC_loadValues(uint16 signal_value){
+void DAC_loadValues(DAC_NameType dacName, uint16 signal_value){
+	/*Loads the low part (8 bits) and the high part (4 bits) of the output voltage value, in a
+	 * single 16 bits store*/
+	DAC_fastLoadValue(dacName,signal_value);
+}
+
+void DAC_bufferInit(DAC_NameType dacName, DAC_BufferModeType bufferMode, DAC_WatermarkType watermark, uint8 upperLimit, DAC_TriggerType trigger){
+	/*Selects the trigger; The rest of the C0 configuration is kept*/
+	if(trigger == DAC_TRIGGER_SOFTWARE){
+		DAC_base[dacName]->C0 |= DAC_TRIGGER_SELECT;
+	} else {
+		DAC_base[dacName]->C0 &= ~(DAC_TRIGGER_SELECT);
+	}
+
+	/*Upper limit of the buffer, and the read pointer starts at zero*/
+	DAC_base[dacName]->C2 = DAC_C2_DACBFUP(upperLimit) | DAC_C2_DACBFRP(0);
+
+	/*Clears any old flag*/
+	DAC_bufferClearFlags(dacName,DAC_BUFFER_WATERMARK | DAC_BUFFER_TOP | DAC_BUFFER_BOTTOM);
+
+	/*Watermark, work mode, and enables the buffer*/
+	DAC_base[dacName]->C1 = DAC_C1_DACBFWM(watermark) | DAC_C1_DACBFMD(bufferMode) | DAC_BUFFER_ENABLE;
+}
 
-	/*Loads the low part of the output voltage value; By doing a mask, of 'and' with
-	 * 0x00FF, we obtain the lower part (8 bits)	*/
-	DAC0_DAT0L = signal_value & (0x00FF);
+void DAC_bufferDisable(DAC_NameType dacName){
+	/*Disables the buffer, and its interruptions*/
+	DAC_base[dacName]->C1 &= ~(DAC_BUFFER_ENABLE);
+	DAC_bufferInterruptDisable(dacName,DAC_BUFFER_WATERMARK | DAC_BUFFER_TOP | DAC_BUFFER_BOTTOM);
+}
 
-	/*Loads the high part of the output voltage value; By doing a mask, of 'and' with
-	 * 0x0F00, we obtain the higher part (4 bits)*/
-	DAC0_DAT0H = (signal_value & (0x0F00))>>8;
+void DAC_bufferLoadValue(DAC_NameType dacName, uint8 index, uint16 signal_value){
+	/*Same as DAC_loadValues, but in the word 'index' of the buffer*/
+	if(index < DAC_BUFFER_SIZE){
+		DAC_fastBufferLoadValue(dacName,index,signal_value);
+	}
 }
 
+uint8 DAC_bufferReadPointer(DAC_NameType dacName){
+	/*The read pointer is in the upper 4 bits of C2*/
+	return (DAC_base[dacName]->C2 & DAC_C2_DACBFRP_MASK) >> DAC_C2_DACBFRP_SHIFT;
+}
+
+void DAC_bufferInterruptEnable(DAC_NameType dacName, uint8 interrupts){
+	DAC_base[dacName]->C0 |= interrupts;
+}
+
+void DAC_bufferInterruptDisable(DAC_NameType dacName, uint8 interrupts){
+	DAC_base[dacName]->C0 &= ~(interrupts);
+}
+
+RAM_FUNCTION void DAC_bufferClearFlags(DAC_NameType dacName, uint8 flags){
+	/*The flags are cleared by writing 0 to them*/
+	DAC_base[dacName]->SR &= ~(flags);
+}
+
+void DAC_softwareTrigger(DAC_NameType dacName){
+	DAC_base[dacName]->C0 |= DAC_SOFTWARE_TRIGGER;
+}
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function attends the DAC0 interruption, it clears the buffer flags that caused
+ 	 	 the interruption, and has a functionality according to this project. It is placed in
+ 	 	 SRAM, with the buffer refill (RAM_FUNCTION)
+ 	 \return void
+ */
+RAM_FUNCTION void DAC0_IRQHandler(){
+	PROFILER_START(PROFILER_DAC0);
+	/*Only the flags with the interruption enabled are taken on account*/
+	uint8 flags = DAC0_SR & DAC0_C0 & (DAC_BUFFER_WATERMARK | DAC_BUFFER_TOP | DAC_BUFFER_BOTTOM);
+	DAC_bufferClearFlags(DAC_0,flags);
+	/*project functionality added to the DAC0 interruption*/
+	WAVEGEN_bufferRefill(flags);
+	PROFILER_STOP(PROFILER_DAC0);
+}
@@ -1,9 +1,9 @@
 /**
 	\file
 	\brief
-		This is the header file for the DAC in the Kinetis 64F. Includes the needed
-		functions to use the DAC0 (initialize, enable, disable, loadValues). The
-		output of the DAC, is DAC0_OUT
+		This is the header file for the DACs in the Kinetis 64F. Includes the needed
+		functions to use the DAC0 and the DAC1 (initialize, enable, disable, loadValues),
+		and their 16 words data buffer. The outputs of the DACs, are DAC0_OUT and DAC1_OUT
 	\author Patricio Gomez Garca
 	\date	22/09/2016
  */
@@ -12,6 +12,7 @@
 #define SOURCES_DAC_H_
 
 #include "DataTypeDefinitions.h"
+#include "MK64F12.h"
 
 /*Constant that enables de DAC*/
 #define DAC_ENABLE 0x00000080
@@ -19,6 +20,54 @@
 #define DAC_REFERENCE_SELECT 0x00000040
 /*Constant that enables de clock gating for the DAC0*/
 #define DAC0_CLOCK_GATING 0x00001000
+/*Constant that enables de clock gating for the DAC1*/
+#define DAC1_CLOCK_GATING 0x00002000
+/*Constant that selects the software trigger instead of the hardware trigger (PDB)*/
+#define DAC_TRIGGER_SELECT 0x00000020
+/*Constant that produces a software trigger, when the software trigger is selected*/
+#define DAC_SOFTWARE_TRIGGER 0x00000010
+/*Constant that enables the data buffer*/
+#define DAC_BUFFER_ENABLE 0x00000001
+/*Constant with the number of words in the data buffer*/
+#define DAC_BUFFER_SIZE 16
+/*Constant with the 12 bits of a data word*/
+#define DAC_DATA_MASK 0x0FFF
+
+/*Constants for the buffer interruptions (DACx_C0) and for its flags (DACx_SR); Both registers use the
+ * same bit for each event, so the same constant is used to enable the interruption and to check the flag*/
+/*Read pointer reached the watermark (upper limit minus the watermark words)*/
+#define DAC_BUFFER_WATERMARK 0x00000004
+/*Read pointer is zero (top of the buffer)*/
+#define DAC_BUFFER_TOP 0x00000002
+/*Read pointer is equal to the upper limit (bottom of the buffer)*/
+#define DAC_BUFFER_BOTTOM 0x00000001
+
+/*! These constants are used to select a DAC in the different API functions*/
+typedef enum {DAC_0, /*!< Definition to select DAC0 */
+			  DAC_1  /*!< Definition to select DAC1 */
+			 }DAC_NameType;
+
+/** Registers of each DAC, indexed by DAC_NameType; It is defined here, so the compiler knows the
+ * address of a constant DAC in the inline functions */
+static DAC_Type* const DAC_base[] = {DAC0, DAC1};
+
+/*! These constants are used to select the work mode of the data buffer*/
+typedef enum {DAC_BUFFER_NORMAL, /*!< The read pointer goes back to zero after the upper limit */
+			  DAC_BUFFER_SWING,  /*!< The read pointer goes up and down between zero and the upper limit */
+			  DAC_BUFFER_ONE_TIME_SCAN /*!< The read pointer stops at the upper limit */
+			 }DAC_BufferModeType;
+
+/*! These constants are used to select how many words before the upper limit the watermark flag is set*/
+typedef enum {DAC_WATERMARK_1_WORD,
+			  DAC_WATERMARK_2_WORDS,
+			  DAC_WATERMARK_3_WORDS,
+			  DAC_WATERMARK_4_WORDS
+			 }DAC_WatermarkType;
+
+/*! These constants are used to select what advances the read pointer of the data buffer*/
+typedef enum {DAC_TRIGGER_HARDWARE, /*!< The PDB DAC interval trigger */
+			  DAC_TRIGGER_SOFTWARE  /*!< DAC_softwareTrigger() */
+			 }DAC_TriggerType;
 
 /********************************************************************************************/
 /********************************************************************************************/
@@ -26,32 +75,35 @@
 /*!
  	 \brief
  	 	 This function configure the DAC clock gating, enable and reference select
+ 	 \param[in] dacName DAC_0 or DAC_1
  	 \return void
 
  */
-void DAC_init();
+void DAC_init(DAC_NameType dacName);
 
 /********************************************************************************************/
 /********************************************************************************************/
 /********************************************************************************************/
 /*!
  	 \brief
- 	 	 This function enables the DAC0, by putting a 1 in the DAC Enable bit
+ 	 	 This function enables a DAC, by putting a 1 in the DAC Enable bit
+ 	 \param[in] dacName DAC_0 or DAC_1
  	 \return void
 
  */
-void DAC_enable();
+void DAC_enable(DAC_NameType dacName);
 
 /********************************************************************************************/
 /********************************************************************************************/
 /********************************************************************************************/
 /*!
  	 \brief
- 	 	 This function disables the DAC0 by putting a 0 in the DAC Enable bit
+ 	 	 This function disables a DAC by putting a 0 in the DAC Enable bit
+ 	 \param[in] dacName DAC_0 or DAC_1
  	 \return void
 
  */
-void DAC_disable();
+void DAC_disable(DAC_NameType dacName);
 
 /********************************************************************************************/
 /********************************************************************************************/
@@ -59,11 +111,137 @@ void DAC_disable();
 /*!
  	 \brief
  	 	 This function loads the output voltage value, by putting the 12 bits value in the high and low part
- 	 	 of the DAC0 data
+ 	 	 of the DAC data
+ 	 \param[in] dacName DAC_0 or DAC_1
  	 \param[in] signal_value, output voltage value (12 bits)
  	 \return void
 
  */
-void DAC_loadValues(uint16 signal_value);
+void DAC_loadValues(DAC_NameType dacName, uint16 signal_value);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function enables the data buffer of a DAC; Each trigger moves the read pointer, and the
+ 	 	 output is the value of the buffer word pointed by it. The read pointer starts at zero.
+ 	 \param[in] dacName DAC_0 or DAC_1
+ 	 \param[in] bufferMode normal, swing or one-time-scan
+ 	 \param[in] watermark words before the upper limit, where the watermark flag is set
+ 	 \param[in] upperLimit last word of the buffer to be used (0 to DAC_BUFFER_SIZE - 1)
+ 	 \param[in] trigger hardware (PDB) or software trigger
+ 	 \return void
+
+ */
+void DAC_bufferInit(DAC_NameType dacName, DAC_BufferModeType bufferMode, DAC_WatermarkType watermark, uint8 upperLimit, DAC_TriggerType trigger);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function disables the data buffer of a DAC, the output is DAT0 again
+ 	 \param[in] dacName DAC_0 or DAC_1
+ 	 \return void
+
+ */
+void DAC_bufferDisable(DAC_NameType dacName);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function loads a 12 bits value in a word of the data buffer
+ 	 \param[in] dacName DAC_0 or DAC_1
+ 	 \param[in] index word of the buffer (0 to DAC_BUFFER_SIZE - 1)
+ 	 \param[in] signal_value output voltage value (12 bits)
+ 	 \return void
+
+ */
+void DAC_bufferLoadValue(DAC_NameType dacName, uint8 index, uint16 signal_value);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function returns the current read pointer of the data buffer
+ 	 \param[in] dacName DAC_0 or DAC_1
+ 	 \return read pointer (0 to DAC_BUFFER_SIZE - 1)
+
+ */
+uint8 DAC_bufferReadPointer(DAC_NameType dacName);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function enables the buffer interruptions
+ 	 \param[in] dacName DAC_0 or DAC_1
+ 	 \param[in] interrupts DAC_BUFFER_WATERMARK, DAC_BUFFER_TOP and/or DAC_BUFFER_BOTTOM
+ 	 \return void
+
+ */
+void DAC_bufferInterruptEnable(DAC_NameType dacName, uint8 interrupts);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function disables the buffer interruptions
+ 	 \param[in] dacName DAC_0 or DAC_1
+ 	 \param[in] interrupts DAC_BUFFER_WATERMARK, DAC_BUFFER_TOP and/or DAC_BUFFER_BOTTOM
+ 	 \return void
+
+ */
+void DAC_bufferInterruptDisable(DAC_NameType dacName, uint8 interrupts);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function clears buffer flags
+ 	 \param[in] dacName DAC_0 or DAC_1
+ 	 \param[in] flags DAC_BUFFER_WATERMARK, DAC_BUFFER_TOP and/or DAC_BUFFER_BOTTOM
+ 	 \return void
+
+ */
+void DAC_bufferClearFlags(DAC_NameType dacName, uint8 flags);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function moves the read pointer of the data buffer, when the software trigger is
+ 	 	 selected
+ 	 \param[in] dacName DAC_0 or DAC_1
+ 	 \return void
+
+ */
+void DAC_softwareTrigger(DAC_NameType dacName);
+
+/*Inline versions of the data functions, for the interruption handlers. DATnL and DATnH are
+ * written at once with a 16 bits store, as the DMA does; They don't check the index, so it must
+ * be 0 to DAC_BUFFER_SIZE - 1, and with a constant index the address is computed by the compiler*/
+static inline void DAC_fastBufferLoadValue(DAC_NameType dacName, uint8 index, uint16 signal_value){
+	*(volatile uint16*)&DAC_base[dacName]->DAT[index].DATL = signal_value & DAC_DATA_MASK;
+}
+
+static inline void DAC_fastLoadValue(DAC_NameType dacName, uint16 signal_value){
+	DAC_fastBufferLoadValue(dacName,0,signal_value);
+}
+
+/*Both outputs are loaded with two consecutive stores, so the skew between them is of a few bus
+ * cycles; The values must be computed before*/
+static inline void DAC_fastLoadValues(uint16 dac0_value, uint16 dac1_value){
+	DAC_fastBufferLoadValue(DAC_0,0,dac0_value);
+	DAC_fastBufferLoadValue(DAC_1,0,dac1_value);
+}
 
 #endif /* SOURCES_DAC_H_ */
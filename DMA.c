@@ -0,0 +1,111 @@
+/**
+	\file
+	\brief
+		This is the source file for the eDMA and DMAMUX in the Kinetis 64F. It has the
+		functions needed to configure a DMA channel (transfer control descriptor), route
+		a request source to it, and enable or disable its hardware requests. A channel can
+		also run a chain of descriptors kept in memory (scatter gather).
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "MK64F12.h"
+#include "DMA.h"
+#include "DataTypeDefinitions.h"
+
+
+void DMA_clockGating(){
+	/*Enable the clock gating for the DMAMUX and for the eDMA*/
+	SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+	SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+}
+
+void DMA_muxConfig(DMA_ChannelType channel, uint8 source, BooleanType periodicTrigger){
+	/*The channel must be disabled in the DMAMUX before changing its source*/
+	DMAMUX->CHCFG[channel] = 0;
+	if(periodicTrigger){
+		DMAMUX->CHCFG[channel] = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_TRIG_MASK | DMAMUX_CHCFG_SOURCE(source);
+	} else {
+		DMAMUX->CHCFG[channel] = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(source);
+	}
+}
+
+void DMA_channelConfig(DMA_ChannelType channel, const DMA_TransferConfigType* config){
+	/*Source and destination addresses, and the offsets applied after each read and write*/
+	DMA0->TCD[channel].SADDR = (uint32)(uintptr_t)config->sourceAddress;
+	DMA0->TCD[channel].SOFF = config->sourceOffset;
+	DMA0->TCD[channel].DADDR = (uint32)(uintptr_t)config->destinationAddress;
+	DMA0->TCD[channel].DOFF = config->destinationOffset;
+	/*Same size for the reads and the writes*/
+	DMA0->TCD[channel].ATTR = DMA_ATTR_SSIZE(config->transferSize) | DMA_ATTR_DSIZE(config->transferSize);
+	/*Bytes moved per request (minor loop)*/
+	DMA0->TCD[channel].NBYTES_MLNO = config->bytesPerRequest;
+	/*Requests per major loop; current and beginning counters must be equal*/
+	DMA0->TCD[channel].CITER_ELINKNO = DMA_CITER_ELINKNO_CITER(config->majorLoopCount);
+	DMA0->TCD[channel].BITER_ELINKNO = DMA_BITER_ELINKNO_BITER(config->majorLoopCount);
+	/*Adjustments done when the major loop completes*/
+	DMA0->TCD[channel].SLAST = config->sourceLastAdjust;
+	DMA0->TCD[channel].DLAST_SGA = config->destinationLastAdjust;
+	/*No interruptions and no channel linking; The requests are kept enabled after the major loop,
+	 * so the transfer repeats for ever, unless it is a single major loop*/
+	DMA0->TCD[channel].CSR = (config->singleMajorLoop)?(DMA_CSR_DREQ_MASK):(FALSE);
+}
+
+void DMA_setSourceAddress(DMA_ChannelType channel, const void* sourceAddress){
+	/*Save if the channel was receiving requests*/
+	uint32 requestEnabled = DMA0->ERQ & (BIT_ON << channel);
+	/*Stop the requests, and wait for any minor loop in progress*/
+	DMA0->CERQ = channel;
+	while(DMA0->TCD[channel].CSR & DMA_CSR_ACTIVE_MASK);
+	/*New source, and the major loop starts again from the first element*/
+	DMA0->TCD[channel].SADDR = (uint32)(uintptr_t)sourceAddress;
+	DMA0->TCD[channel].CITER_ELINKNO = DMA0->TCD[channel].BITER_ELINKNO;
+	/*Restore the requests*/
+	if(requestEnabled){
+		DMA0->SERQ = channel;
+	}
+}
+
+void DMA_descriptorConfig(DMA_DescriptorType* descriptor, const DMA_TransferConfigType* config, const DMA_DescriptorType* next){
+	/*The same fields as DMA_channelConfig, in the layout of a TCD*/
+	descriptor->sourceAddress = (uint32)(uintptr_t)config->sourceAddress;
+	descriptor->sourceOffset = config->sourceOffset;
+	descriptor->attributes = DMA_ATTR_SSIZE(config->transferSize) | DMA_ATTR_DSIZE(config->transferSize);
+	descriptor->bytesPerRequest = config->bytesPerRequest;
+	descriptor->sourceLastAdjust = config->sourceLastAdjust;
+	descriptor->destinationAddress = (uint32)(uintptr_t)config->destinationAddress;
+	descriptor->destinationOffset = config->destinationOffset;
+	descriptor->majorLoopCount = DMA_CITER_ELINKNO_CITER(config->majorLoopCount);
+	descriptor->beginningMajorLoopCount = DMA_BITER_ELINKNO_BITER(config->majorLoopCount);
+	/*The scatter gather address takes the place of the destination adjustment*/
+	descriptor->nextDescriptor = (uint32)(uintptr_t)next;
+	descriptor->controlStatus = (config->singleMajorLoop)?(DMA_CSR_ESG_MASK | DMA_CSR_DREQ_MASK):(DMA_CSR_ESG_MASK);
+}
+
+void DMA_loadDescriptor(DMA_ChannelType channel, const DMA_DescriptorType* descriptor){
+	/*Wait for any minor loop in progress*/
+	while(DMA0->TCD[channel].CSR & DMA_CSR_ACTIVE_MASK);
+	DMA0->TCD[channel].SADDR = descriptor->sourceAddress;
+	DMA0->TCD[channel].SOFF = descriptor->sourceOffset;
+	DMA0->TCD[channel].ATTR = descriptor->attributes;
+	DMA0->TCD[channel].NBYTES_MLNO = descriptor->bytesPerRequest;
+	DMA0->TCD[channel].SLAST = descriptor->sourceLastAdjust;
+	DMA0->TCD[channel].DADDR = descriptor->destinationAddress;
+	DMA0->TCD[channel].DOFF = descriptor->destinationOffset;
+	DMA0->TCD[channel].CITER_ELINKNO = descriptor->majorLoopCount;
+	DMA0->TCD[channel].BITER_ELINKNO = descriptor->beginningMajorLoopCount;
+	DMA0->TCD[channel].DLAST_SGA = descriptor->nextDescriptor;
+	/*DONE must be cleared before ESG is set*/
+	DMA0->TCD[channel].CSR = 0;
+	DMA0->TCD[channel].CSR = descriptor->controlStatus;
+}
+
+void DMA_requestEnable(DMA_ChannelType channel){
+	/*Set the enable request bit of the channel*/
+	DMA0->SERQ = channel;
+}
+
+void DMA_requestDisable(DMA_ChannelType channel){
+	/*Clear the enable request bit of the channel*/
+	DMA0->CERQ = channel;
+}
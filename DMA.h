@@ -0,0 +1,182 @@
+/**
+	\file
+	\brief
+		This is the header file for the eDMA and DMAMUX in the Kinetis 64F. It has the
+		functions needed to configure a DMA channel (transfer control descriptor), route
+		a request source to it, and enable or disable its hardware requests. A channel can
+		also run a chain of descriptors kept in memory (scatter gather): each one is loaded
+		by the channel itself when the major loop of the previous one completes.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_DMA_H_
+#define SOURCES_DMA_H_
+
+#include "DataTypeDefinitions.h"
+
+/*DMAMUX request source that is always enabled; Combined with the periodic trigger of
+ * DMA channels 0 to 3, the request is issued each time the PIT channel with the same number
+ * expires*/
+#define DMA_SOURCE_ALWAYS_ENABLED 60
+/*Other always enabled sources (61 to 63), for other periodic channels; A source is routed to a
+ * single channel*/
+#define DMA_SOURCE_ALWAYS_ENABLED_2 61
+
+/*! This enumerated constant are used to select the DMA channel to be used*/
+typedef enum {DMA_CH0, DMA_CH1, DMA_CH2, DMA_CH3, DMA_CH4, DMA_CH5, DMA_CH6, DMA_CH7,
+			  DMA_CH8, DMA_CH9, DMA_CH10, DMA_CH11, DMA_CH12, DMA_CH13, DMA_CH14, DMA_CH15
+			 }DMA_ChannelType;
+
+/*! This enumerated constant are used to select the size of each read and write of a transfer*/
+typedef enum {DMA_TRANSFER_8BIT,  /*!< Transfers of 1 byte */
+			  DMA_TRANSFER_16BIT, /*!< Transfers of 2 bytes */
+			  DMA_TRANSFER_32BIT  /*!< Transfers of 4 bytes */
+			 }DMA_TransferSizeType;
+
+/*Struct that contains the data needed to fill the transfer control descriptor (TCD) of a channel*/
+typedef struct{
+	/*sourceAddress, address of the first element to be read*/
+	const void* sourceAddress;
+	/*destinationAddress, address of the first element to be written*/
+	volatile void* destinationAddress;
+	/*sourceOffset, bytes added to the source address after each read*/
+	sint16 sourceOffset;
+	/*destinationOffset, bytes added to the destination address after each write*/
+	sint16 destinationOffset;
+	/*transferSize, size of each read and write*/
+	DMA_TransferSizeType transferSize;
+	/*bytesPerRequest, bytes transferred each time the channel receives a request (minor loop)*/
+	uint32 bytesPerRequest;
+	/*majorLoopCount, number of requests needed to complete the major loop*/
+	uint16 majorLoopCount;
+	/*sourceLastAdjust, bytes added to the source address when the major loop completes; Using
+	 * minus the size of the buffer, the channel goes back to the beginning (circular transfer)*/
+	sint32 sourceLastAdjust;
+	/*destinationLastAdjust, bytes added to the destination address when the major loop completes*/
+	sint32 destinationLastAdjust;
+	/*singleMajorLoop, TRUE to disable the hardware requests when the major loop completes, so the
+	 * transfer is done once; Otherwise, it repeats for ever*/
+	BooleanType singleMajorLoop;
+}DMA_TransferConfigType;
+
+/*Struct that contains a transfer control descriptor, as the TCD of a channel, to be loaded by the
+ * channel from memory at the end of a major loop (scatter gather); The channel needs it aligned to
+ * 32 bytes*/
+typedef struct{
+	/*sourceAddress, sourceOffset, attributes, bytesPerRequest and sourceLastAdjust, as SADDR, SOFF,
+	 * ATTR, NBYTES and SLAST*/
+	uint32 sourceAddress;
+	sint16 sourceOffset;
+	uint16 attributes;
+	uint32 bytesPerRequest;
+	sint32 sourceLastAdjust;
+	/*destinationAddress and destinationOffset, as DADDR and DOFF*/
+	uint32 destinationAddress;
+	sint16 destinationOffset;
+	/*majorLoopCount, as CITER*/
+	uint16 majorLoopCount;
+	/*nextDescriptor, as DLAST_SGA: address of the descriptor loaded when the major loop completes*/
+	uint32 nextDescriptor;
+	/*controlStatus, as CSR*/
+	uint16 controlStatus;
+	/*beginningMajorLoopCount, as BITER*/
+	uint16 beginningMajorLoopCount;
+}__attribute__((aligned(32))) DMA_DescriptorType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function enables the clock gating of the eDMA and the DMAMUX
+ 	 \return void
+ */
+void DMA_clockGating();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function routes a request source to a DMA channel in the DMAMUX
+ 	 \param[in] channel DMA channel to be configured
+ 	 \param[in] source DMAMUX request source (see the K64 reference manual, DMA request sources)
+ 	 \param[in] periodicTrigger TRUE to gate the requests with the PIT channel with the same number
+ 	 	 as the DMA channel (only DMA channels 0 to 3)
+ 	 \return void
+ */
+void DMA_muxConfig(DMA_ChannelType channel, uint8 source, BooleanType periodicTrigger);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function loads the transfer control descriptor of a DMA channel. The hardware
+ 	 	 requests of the channel are not enabled by this function.
+ 	 \param[in] channel DMA channel to be configured
+ 	 \param[in] config Pointer to the transfer configuration
+ 	 \return void
+ */
+void DMA_channelConfig(DMA_ChannelType channel, const DMA_TransferConfigType* config);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function changes the source address of a DMA channel, and restarts its major
+ 	 	 loop. The hardware requests are stopped during the change, and its previous state is
+ 	 	 restored.
+ 	 \param[in] channel DMA channel to be modified
+ 	 \param[in] sourceAddress New source address
+ 	 \return void
+ */
+void DMA_setSourceAddress(DMA_ChannelType channel, const void* sourceAddress);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function fills a descriptor of a chain with a transfer configuration. When its
+ 	 	 major loop completes, the channel loads the next descriptor, instead of applying the
+ 	 	 destination adjustment; A chain that goes back to its first descriptor repeats for
+ 	 	 ever, without the CPU.
+ 	 \param[out] descriptor Descriptor to be filled
+ 	 \param[in] config Pointer to the transfer configuration; destinationLastAdjust isn't used
+ 	 \param[in] next Descriptor loaded after this one
+ 	 \return void
+ */
+void DMA_descriptorConfig(DMA_DescriptorType* descriptor, const DMA_TransferConfigType* config, const DMA_DescriptorType* next);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function loads a descriptor of a chain in a DMA channel, so its next request
+ 	 	 runs that descriptor. The hardware requests of the channel must be disabled; A minor
+ 	 	 loop in progress ends before the descriptor is loaded.
+ 	 \param[in] channel DMA channel
+ 	 \param[in] descriptor Descriptor to be loaded
+ 	 \return void
+ */
+void DMA_loadDescriptor(DMA_ChannelType channel, const DMA_DescriptorType* descriptor);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function enables the hardware requests of a DMA channel
+ 	 \param[in] channel DMA channel
+ 	 \return void
+ */
+void DMA_requestEnable(DMA_ChannelType channel);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function disables the hardware requests of a DMA channel
+ 	 \param[in] channel DMA channel
+ 	 \return void
+ */
+void DMA_requestDisable(DMA_ChannelType channel);
+
+#endif /* SOURCES_DMA_H_ */
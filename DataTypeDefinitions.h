@@ -57,10 +57,12 @@ typedef char sint8;
 typedef unsigned short int uint16;
 /*! This data type is 16-bit signed integer*/
 typedef short int sint16;
-/*! This data type is 32-bit unsigned integer*/
-typedef unsigned long int uint32;
-/*! This data type is 16-bit signed integer*/
-typedef long int sint32;
+/*! This data type is 32-bit unsigned integer; int is 32 bits both in the K64 and in a 64 bits host*/
+typedef unsigned int uint32;
+/*! This data type is 32-bit signed integer*/
+typedef int sint32;
+/*! This data type is 64-bit unsigned integer*/
+typedef unsigned long long uint64;
 
 
 #endif /* SOURCES_DATATYPEDEFINITIONS_H_ */
@@ -0,0 +1,144 @@
+/**
+	\file
+	\brief
+		This is the source file for the input event queues between the interruption handlers
+		and the main loop. Each source has a single producer (its interruption handler) and a
+		single consumer (the main loop): only the producer writes the tail, and only the
+		consumer writes the head, so no critical section is needed.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include <stddef.h>
+#include "EVNTQ.h"
+#include "NVIC.h"
+#include "GlobalFunctions.h"
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*Mask to get the position of an index in the buffer*/
+#define EVENTQUEUE_MASK (EVENTQUEUE_SIZE - 1)
+
+/*Struct that contains the ring buffer of a source*/
+typedef struct{
+	/*events, stored events; Each one is written before the tail moves*/
+	volatile EVENTQUEUE_EventType events[EVENTQUEUE_SIZE];
+	/*head, index of the next event to be taken; Only written by the main loop. The indexes
+	 * count for ever, the difference tail - head is the number of events*/
+	volatile uint8 head;
+	/*tail, index of the next event to be stored; Only written by the interruption handler*/
+	volatile uint8 tail;
+	/*stats, of the queue; Only written by the interruption handler*/
+	EVENTQUEUE_StatsType stats;
+	/*fptrHandler, function that attends the events*/
+	void(*fptrHandler)(uint8);
+	/*priority, masked while the handler runs*/
+	PriorityLevelType priority;
+}EVENTQUEUE_QueueType;
+
+static EVENTQUEUE_QueueType queues[EVENTQUEUE_SOURCES];
+
+void EVENTQUEUE_init(){
+	uint8 source;
+	for(source = 0; source < EVENTQUEUE_SOURCES; source++){
+		queues[source].head = 0;
+		queues[source].tail = 0;
+		queues[source].stats.pushed = 0;
+		queues[source].stats.overflows = 0;
+		queues[source].stats.maximumLevel = 0;
+		queues[source].fptrHandler = NULL;
+	}
+	/*Timestamps of the events*/
+	cycleCounterInit();
+}
+
+void EVENTQUEUE_setHandler(EVENTQUEUE_SourceType source, void(*handler)(uint8), PriorityLevelType priority){
+	queues[source].fptrHandler = handler;
+	queues[source].priority = priority;
+}
+
+BooleanType EVENTQUEUE_push(EVENTQUEUE_SourceType source, uint8 data){
+	EVENTQUEUE_QueueType* queue = &queues[source];
+	uint8 tail = queue->tail;
+	uint8 level = (uint8)(tail - queue->head);
+
+	if(level >= EVENTQUEUE_SIZE){
+		queue->stats.overflows++;
+		return FALSE;
+	}
+	/*The event is completed before the tail makes it visible to the main loop*/
+	queue->events[tail & EVENTQUEUE_MASK].timestamp = cycleCounter();
+	queue->events[tail & EVENTQUEUE_MASK].source = source;
+	queue->events[tail & EVENTQUEUE_MASK].data = data;
+	queue->tail = tail + 1;
+
+	queue->stats.pushed++;
+	if(level + 1 > queue->stats.maximumLevel){
+		queue->stats.maximumLevel = level + 1;
+	}
+	return TRUE;
+}
+
+BooleanType EVENTQUEUE_pop(EVENTQUEUE_EventType* event){
+	uint32 now = cycleCounter();
+	uint32 oldestAge = 0;
+	EVENTQUEUE_QueueType* oldest = NULL;
+	uint8 source;
+
+	/*The oldest event is the first of one of the queues; The age is right even if the cycle
+	 * counter overflowed*/
+	for(source = 0; source < EVENTQUEUE_SOURCES; source++){
+		EVENTQUEUE_QueueType* queue = &queues[source];
+		uint8 head = queue->head;
+		if(head != queue->tail){
+			uint32 age = now - queue->events[head & EVENTQUEUE_MASK].timestamp;
+			if(oldest == NULL || age > oldestAge){
+				oldest = queue;
+				oldestAge = age;
+			}
+		}
+	}
+	if(oldest == NULL){
+		return FALSE;
+	}
+
+	/*The event is copied before the head releases its place to the interruption handler*/
+	event->timestamp = oldest->events[oldest->head & EVENTQUEUE_MASK].timestamp;
+	event->source = oldest->events[oldest->head & EVENTQUEUE_MASK].source;
+	event->data = oldest->events[oldest->head & EVENTQUEUE_MASK].data;
+	oldest->head++;
+	return TRUE;
+}
+
+BooleanType EVENTQUEUE_isEmpty(){
+	uint8 source;
+	for(source = 0; source < EVENTQUEUE_SOURCES; source++){
+		if(queues[source].head != queues[source].tail){
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+uint8 EVENTQUEUE_dispatch(){
+	EVENTQUEUE_EventType event;
+	uint8 attended = 0;
+	uint32 basePri;
+
+	while(EVENTQUEUE_pop(&event)){
+		if(queues[event.source].fptrHandler){
+			/*The handler runs with the same interruptions masked as when it was called from the
+			 * interruption handler of the source*/
+			basePri = __get_BASEPRI();
+			NVIC_setBASEPRI_threshold(queues[event.source].priority);
+			queues[event.source].fptrHandler(event.data);
+			__set_BASEPRI(basePri);
+		}
+		attended++;
+	}
+	return attended;
+}
+
+const EVENTQUEUE_StatsType* EVENTQUEUE_stats(EVENTQUEUE_SourceType source){
+	return &queues[source].stats;
+}
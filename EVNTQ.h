@@ -0,0 +1,129 @@
+/**
+	\file
+	\brief
+		This is the header file for the input event queues between the interruption handlers
+		and the main loop. Each event source (keyboard, SW2, SW3, and the blocks of the
+		synthesizer to render) is produced by a single interruption handler and consumed by
+		the main loop, so each source has its own lock free, single producer / single
+		consumer ring buffer. The handlers only push a timestamped event; the main loop pops
+		the events in the order they happened and calls the handler registered for its
+		source.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_EVNTQ_H_
+#define SOURCES_EVNTQ_H_
+
+#include "DataTypeDefinitions.h"
+#include "NVIC.h"
+
+/*Events stored by each source; It must be a power of two, up to 128*/
+#define EVENTQUEUE_SIZE 16
+
+/*! This enumerated constant are used to select the source of an event*/
+typedef enum {EVENTQUEUE_KEYPAD, /*!< Key code from the keyboard (PORTB_IRQHandler) */
+			  EVENTQUEUE_SW2,    /*!< SW2 press (PORTC_IRQHandler) */
+			  EVENTQUEUE_SW3,    /*!< SW3 press (PORTA_IRQHandler) */
+			  EVENTQUEUE_SYNTH,  /*!< Block of the synthesizer consumed (PIT0_IRQHandler, or DAC0_IRQHandler in the buffered mode) */
+			  EVENTQUEUE_SOURCES
+			 }EVENTQUEUE_SourceType;
+
+/*Struct that contains an input event*/
+typedef struct{
+	/*timestamp, cycle counter when the event was pushed*/
+	uint32 timestamp;
+	/*source, of the event*/
+	EVENTQUEUE_SourceType source;
+	/*data, of the event: the key code, the pin of the switch, or the block*/
+	uint8 data;
+}EVENTQUEUE_EventType;
+
+/*Struct that contains the statistics of the queue of a source*/
+typedef struct{
+	/*pushed, events stored*/
+	uint32 pushed;
+	/*overflows, events lost because the queue was full*/
+	uint32 overflows;
+	/*maximumLevel, most events waiting at once in the queue*/
+	uint8 maximumLevel;
+}EVENTQUEUE_StatsType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function empties the queues and enables the cycle counter used for the
+ 	 	 timestamps. It must be called before the processes are initialized.
+ 	 \return void
+ */
+void EVENTQUEUE_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function registers the function that attends the events of a source, in
+ 	 	 the main loop.
+ 	 \param[in] source Event source
+ 	 \param[in] handler Function called with the data of each event
+ 	 \param[in] priority Priority of the interruption that used to attend the source; While the
+ 	 	 handler runs, the interruptions with this priority or lower are masked (BASEPRI), as they
+ 	 	 were when the handler was called from that interruption
+ 	 \return void
+ */
+void EVENTQUEUE_setHandler(EVENTQUEUE_SourceType source, void(*handler)(uint8), PriorityLevelType priority);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function stores an event; It is only called from the interruption handler of
+ 	 	 the source. It never waits: if the queue is full, the event is lost and counted.
+ 	 \param[in] source Event source
+ 	 \param[in] data Data of the event
+ 	 \return TRUE if the event was stored
+ */
+BooleanType EVENTQUEUE_push(EVENTQUEUE_SourceType source, uint8 data);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function takes the oldest event of all the sources; It is only called from
+ 	 	 the main loop.
+ 	 \param[out] event Oldest event
+ 	 \return TRUE if there was an event
+ */
+BooleanType EVENTQUEUE_pop(EVENTQUEUE_EventType* event);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function indicates if there are no events waiting in any source
+ 	 \return TRUE if all the queues are empty
+ */
+BooleanType EVENTQUEUE_isEmpty();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function attends all the stored events, calling the handler of its source.
+ 	 	 It is called from the main loop.
+ 	 \return Number of events attended
+ */
+uint8 EVENTQUEUE_dispatch();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the statistics of the queue of a source
+ 	 \param[in] source Event source
+ 	 \return Pointer to the statistics
+ */
+const EVENTQUEUE_StatsType* EVENTQUEUE_stats(EVENTQUEUE_SourceType source);
+
+#endif /* SOURCES_EVNTQ_H_ */
@@ -0,0 +1,89 @@
+/**
+	\file
+	\brief
+		This is the source file for the FlexTimers (FTM) in the Kinetis 64F. It has the
+		functions needed to use a FlexTimer as an edge aligned PWM generator, counted with
+		the bus clock, or as a quadrature decoder.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "MK64F12.h"
+#include "FTM.h"
+#include "DataTypeDefinitions.h"
+
+/*Bus clock as the clock source of the FTM counter*/
+#define FTM_SYSTEM_CLOCK 1
+/*Modulo of a free running counter*/
+#define FTM_FREE_RUNNING 0xFFFF
+
+/*Clock gating of each FlexTimer, in SIM_SCGC6 (FTM0 to FTM2) or SIM_SCGC3 (FTM3), indexed by FTM_NameType*/
+static volatile uint32* const FTM_clockGatingRegister[] = {&SIM_SCGC6, &SIM_SCGC6, &SIM_SCGC6, &SIM_SCGC3};
+static const uint32 FTM_clockGatingMask[] = {SIM_SCGC6_FTM0_MASK, SIM_SCGC6_FTM1_MASK, SIM_SCGC6_FTM2_MASK, SIM_SCGC3_FTM3_MASK};
+
+void FTM_clockGating(FTM_NameType ftmName){
+	*FTM_clockGatingRegister[ftmName] |= FTM_clockGatingMask[ftmName];
+}
+
+void FTM_pwmInit(FTM_NameType ftmName, FTM_PrescalerType prescaler, uint16 modulo){
+	FTM_Type* ftm = FTM_base[ftmName];
+
+	/*The counter is stopped while it is configured*/
+	ftm->SC = 0;
+	/*TPM compatible mode, without write protection: CnV is taken at the reload point*/
+	ftm->MODE = FTM_MODE_WPDIS_MASK;
+	ftm->CNTIN = 0;
+	ftm->CNT = 0;
+	ftm->MOD = modulo;
+	/*Up counter (edge aligned), with the bus clock*/
+	ftm->SC = FTM_SC_CLKS(FTM_SYSTEM_CLOCK) | FTM_SC_PS(prescaler);
+}
+
+void FTM_pwmChannelInit(FTM_NameType ftmName, FTM_ChannelType channel, BooleanType dmaRequest){
+	FTM_Type* ftm = FTM_base[ftmName];
+
+	/*The output is low until the first duty is loaded*/
+	ftm->CONTROLS[channel].CnV = 0;
+	/*Edge aligned PWM, high true: high from the reload point to the match. The match requests the
+	 * DMA only if the channel interruption is enabled too*/
+	if(dmaRequest){
+		ftm->CONTROLS[channel].CnSC = FTM_CnSC_MSB_MASK | FTM_CnSC_ELSB_MASK | FTM_CnSC_CHIE_MASK | FTM_CnSC_DMA_MASK;
+	} else {
+		ftm->CONTROLS[channel].CnSC = FTM_CnSC_MSB_MASK | FTM_CnSC_ELSB_MASK;
+	}
+}
+
+void FTM_clearChannelFlag(FTM_NameType ftmName, FTM_ChannelType channel){
+	/*CHF is cleared writing 0 after reading it*/
+	FTM_base[ftmName]->CONTROLS[channel].CnSC &= ~(FTM_CnSC_CHF_MASK);
+}
+
+void FTM_setModulo(FTM_NameType ftmName, uint16 modulo){
+	FTM_Type* ftm = FTM_base[ftmName];
+	uint32 clock = ftm->SC & (FTM_SC_CLKS_MASK | FTM_SC_PS_MASK);
+
+	/*In the TPM compatible mode, MOD is written at once while the counter is stopped*/
+	ftm->SC = 0;
+	ftm->CNT = 0;
+	ftm->MOD = modulo;
+	ftm->SC = clock;
+}
+
+void FTM_stop(FTM_NameType ftmName){
+	FTM_base[ftmName]->SC &= ~(FTM_SC_CLKS_MASK);
+}
+
+void FTM_quadratureInit(FTM_NameType ftmName){
+	FTM_Type* ftm = FTM_base[ftmName];
+
+	/*The decoder needs the FTM mode (FTMEN), and QDCTRL is write protected*/
+	ftm->SC = 0;
+	ftm->MODE = FTM_MODE_FTMEN_MASK | FTM_MODE_WPDIS_MASK;
+	ftm->CNTIN = 0;
+	ftm->MOD = FTM_FREE_RUNNING;
+	ftm->CNT = 0;
+	/*Phase A and phase B encoding; The counter is clocked by the phases, but the FTM still needs a
+	 * clock source to run*/
+	ftm->QDCTRL = FTM_QDCTRL_QUADEN_MASK;
+	ftm->SC = FTM_SC_CLKS(FTM_SYSTEM_CLOCK);
+}
@@ -0,0 +1,152 @@
+/**
+	\file
+	\brief
+		This is the header file for the FlexTimers (FTM) in the Kinetis 64F. It has the
+		functions needed to use a FlexTimer as an edge aligned PWM generator, counted with
+		the bus clock. The FTM is used in its TPM compatible mode (FTMEN = 0): a new duty
+		(CnV) is taken at the reload point, when the counter goes from the modulo back to 0,
+		so each duty lasts whole PWM periods and the output never glitches. A channel can
+		request the DMA on each match, once per period, to load the duty of the next period.
+		A FlexTimer can also count the edges of a quadrature encoder (phases A and B), as a
+		free running 16 bits counter that goes up or down with the direction.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_FTM_H_
+#define SOURCES_FTM_H_
+
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*DMAMUX request source of the channel 0 of the FTM0; The sources of the channels 1 to 7 follow it*/
+#define FTM_DMA_SOURCE_FTM0_CH0 20
+
+/*! These constants are used to select a FlexTimer in the different API functions*/
+typedef enum {FTM_0, /*!< FTM0, 8 channels */
+			  FTM_1, /*!< FTM1, 2 channels */
+			  FTM_2, /*!< FTM2, 2 channels */
+			  FTM_3  /*!< FTM3, 8 channels */
+			 }FTM_NameType;
+
+/** Registers of each FlexTimer, indexed by FTM_NameType; It is defined here, so the compiler knows
+ * the address of a constant FTM in the inline functions */
+static FTM_Type* const FTM_base[] = {FTM0, FTM1, FTM2, FTM3};
+
+/*! This enumerated constant are used to select a channel of a FlexTimer*/
+typedef enum {FTM_CH0, FTM_CH1, FTM_CH2, FTM_CH3, FTM_CH4, FTM_CH5, FTM_CH6, FTM_CH7
+			 }FTM_ChannelType;
+
+/*! This enumerated constant are used to select the division of the bus clock for the FTM counter*/
+typedef enum {FTM_PRESCALER_1, FTM_PRESCALER_2, FTM_PRESCALER_4, FTM_PRESCALER_8,
+			  FTM_PRESCALER_16, FTM_PRESCALER_32, FTM_PRESCALER_64, FTM_PRESCALER_128
+			 }FTM_PrescalerType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function enables the clock gating of a FlexTimer
+ 	 \param[in] ftmName FlexTimer
+ 	 \return void
+ */
+void FTM_clockGating(FTM_NameType ftmName);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures a FlexTimer as an up counter from 0 to the modulo, and
+ 	 	 starts it with the bus clock; A PWM period is modulo + 1 counts. The channels aren't
+ 	 	 configured by this function.
+ 	 \param[in] ftmName FlexTimer
+ 	 \param[in] prescaler division of the bus clock for the FTM counter
+ 	 \param[in] modulo last count of the period
+ 	 \return void
+ */
+void FTM_pwmInit(FTM_NameType ftmName, FTM_PrescalerType prescaler, uint16 modulo);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures a channel as an edge aligned, high true PWM output, with
+ 	 	 a duty of 0. The pin must be routed to the channel in its PCR.
+ 	 \param[in] ftmName FlexTimer
+ 	 \param[in] channel Channel
+ 	 \param[in] dmaRequest TRUE to request the DMA on each match of the channel, instead of an
+ 	 	 interruption; The DMAMUX source is FTM_DMA_SOURCE_FTM0_CH0 plus the channel, for the FTM0
+ 	 \return void
+ */
+void FTM_pwmChannelInit(FTM_NameType ftmName, FTM_ChannelType channel, BooleanType dmaRequest);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function clears the flag of a channel, set by each match; With the DMA request
+ 	 	 enabled, a flag left set requests the DMA as soon as its requests are enabled.
+ 	 \param[in] ftmName FlexTimer
+ 	 \param[in] channel Channel
+ 	 \return void
+ */
+void FTM_clearChannelFlag(FTM_NameType ftmName, FTM_ChannelType channel);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function changes the modulo of a FlexTimer, keeping the prescaler; It is used
+ 	 	 after a bus clock change. The counter restarts from 0 with the new period.
+ 	 \param[in] ftmName FlexTimer
+ 	 \param[in] modulo last count of the period
+ 	 \return void
+ */
+void FTM_setModulo(FTM_NameType ftmName, uint16 modulo);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function stops the counter of a FlexTimer; The outputs keep their level.
+ 	 \param[in] ftmName FlexTimer
+ 	 \return void
+ */
+void FTM_stop(FTM_NameType ftmName);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures a FlexTimer as a quadrature decoder, in the phase A and
+ 	 	 phase B encoding mode: the counter counts the 4 edges of each encoder line, up or down
+ 	 	 with the direction, from 0 to 0xFFFF and around. The phase pins must be routed to the
+ 	 	 decoder in its PCR.
+ 	 \param[in] ftmName FlexTimer (FTM1 or FTM2, the ones with a decoder)
+ 	 \return void
+ */
+void FTM_quadratureInit(FTM_NameType ftmName);
+
+/*Inline counter function, for the interruption handlers; The difference of two readings, as a
+ * sint16, is the number of encoder edges between them, while it is less than 2^15*/
+static inline uint16 FTM_readCounter(FTM_NameType ftmName){
+	return (uint16)FTM_base[ftmName]->CNT;
+}
+
+/*Inline duty functions, for the interruption handlers. The duty is in counts of the FTM counter:
+ * 0 is a low output, and modulo + 1 or more is a high output. A new duty is taken at the next
+ * reload point, so it can be written at any moment of the period*/
+static inline void FTM_fastSetDuty(FTM_NameType ftmName, FTM_ChannelType channel, uint16 duty){
+	FTM_base[ftmName]->CONTROLS[channel].CnV = duty;
+}
+
+static inline uint16 FTM_readDuty(FTM_NameType ftmName, FTM_ChannelType channel){
+	return (uint16)FTM_base[ftmName]->CONTROLS[channel].CnV;
+}
+
+/*Address of the duty register of a channel, as the destination of a DMA transfer*/
+static inline volatile void* FTM_dutyRegister(FTM_NameType ftmName, FTM_ChannelType channel){
+	return &FTM_base[ftmName]->CONTROLS[channel].CnV;
+}
+
+#endif /* SOURCES_FTM_H_ */
@@ -10,269 +10,185 @@
 #include "MK64F12.h"
 #include "GPIO.h"
 #include "DataTypeDefinitions.h"
+#include "GlobalFunctions.h"
+#include "LPTMR.h"
+
+/*Digital filter clocked by the LPO (1kHz), so its width is in ms*/
+#define DIGITAL_FILTER_LPO 0x00000001
+
+/*Struct that contains a pin debounced with a timestamp lockout*/
+typedef struct{
+	/*portName and pin, of the debounced pin*/
+	GPIO_portNameType portName;
+	uint8 pin;
+	/*window, milliseconds where the edges after an accepted one are ignored*/
+	uint32 window;
+	/*lastAccepted, LPTMR time base of the last accepted edge; The cycle counter isn't used, as
+	 * it stops while the core sleeps*/
+	uint32 lastAccepted;
+}GPIO_lockoutType;
+
+/*PORT registers of each port; All of them have the passive digital filter*/
+static PORT_Type* const portBase[] = {PORTA, PORTB, PORTC, PORTD, PORTE};
+/*Clock gating bit of each port in SIM_SCGC5*/
+static const uint32 clockGatingMask[] = {GPIO_CLOCK_GATING_PORTA, GPIO_CLOCK_GATING_PORTB, GPIO_CLOCK_GATING_PORTC,
+										 GPIO_CLOCK_GATING_PORTD, GPIO_CLOCK_GATING_PORTE};
+/*Pins debounced with the timestamp lockout*/
+static GPIO_lockoutType lockoutPins[GPIO_DEBOUNCE_LOCKOUT_PINS];
+static uint8 lockoutPinsCount = 0;
 
 
 void GPIO_clearInterrupt(GPIO_portNameType portName){
-	switch(portName){
-		case GPIOA:
-			PORTA_ISFR=0xFFFFFFFF;
-			break;
-		case GPIOB:
-			PORTB_ISFR=0xFFFFFFFF;
-			break;
-		case GPIOC:
-			PORTC_ISFR=0xFFFFFFFF;
-			break;
-		case GPIOD:
-			PORTD_ISFR=0xFFFFFFFF;
-			break;
-		case GPIOE:
-			PORTE_ISFR=0xFFFFFFFF;
-			break;
-		default:
-			break;
+	if(portName <= GPIOE){
+		portBase[portName]->ISFR = 0xFFFFFFFF;
 	}
 }
 
 uint8 GPIO_clockGating(GPIO_portNameType portName){
-	switch(portName){
-		case GPIOA:
-			SIM_SCGC5 |= GPIO_CLOCK_GATING_PORTA;
-			break;
-		case GPIOB:
-			SIM_SCGC5 |= GPIO_CLOCK_GATING_PORTB;
-			break;
-		case GPIOC:
-			SIM_SCGC5 |= GPIO_CLOCK_GATING_PORTC;
-			break;
-		case GPIOD:
-			SIM_SCGC5 |= GPIO_CLOCK_GATING_PORTD;
-			break;
-		case GPIOE:
-			SIM_SCGC5 |= GPIO_CLOCK_GATING_PORTE;
-			break;
-		default:
-			return FALSE;
+	if(portName > GPIOE){
+		return FALSE;
 	}
+	SIM_SCGC5 |= clockGatingMask[portName];
 	return TRUE;
 }
 
 uint8 GPIO_pinControlRegister(GPIO_portNameType portName,uint8 pin,GPIO_pinControlRegisterType* pinControlRegister){
-	switch(portName){
-		case GPIOA:
-			PORTA_PCR(pin) = *pinControlRegister;
-			break;
-		case GPIOB:
-			PORTB_PCR(pin) = *pinControlRegister;
-			break;
-		case GPIOC:
-			PORTC_PCR(pin) = *pinControlRegister;
-			break;
-		case GPIOD:
-			PORTD_PCR(pin) = *pinControlRegister;
-			break;
-		case GPIOE:
-			PORTE_PCR(pin) = *pinControlRegister;
-			break;
-		default:
-			return FALSE;
+	if(portName > GPIOE){
+		return FALSE;
 	}
+	portBase[portName]->PCR[pin] = *pinControlRegister;
 	return TRUE;
 }
 
 void GPIO_dataDirectionPORT(GPIO_portNameType portName, uint32 direction){
-	switch(portName){
-		case GPIOA:
-			GPIOA_PDDR = direction;
-			break;
-		case GPIOB:
-			GPIOB_PDDR = direction;
-			break;
-		case GPIOC:
-			GPIOC_PDDR = direction;
-			break;
-		case GPIOD:
-			GPIOD_PDDR = direction;
-			break;
-		case GPIOE:
-			GPIOE_PDDR = direction;
-			break;
+	if(portName <= GPIOE){
+		GPIO_base[portName]->PDDR = direction;
 	}
 }
 
 void GPIO_dataDirectionPIN(GPIO_portNameType portName, uint8 state, uint8 pin){
-
-	switch(portName){
-		case(GPIOA):
-				if(state == GPIO_OUTPUT){
-					GPIOA_PDDR |= (BIT_ON << pin);
-				}
-				else{
-					GPIOA_PDDR &= ~(BIT_ON << pin);
-				}
-				break;
-		case(GPIOB):
-				if(state == GPIO_OUTPUT){
-					GPIOB_PDDR |= (BIT_ON << pin);
-				}
-				else{
-					GPIOB_PDDR &= ~(BIT_ON << pin);
-				}
-				break;
-		case(GPIOC):
-				if(state == GPIO_OUTPUT){
-					GPIOC_PDDR |= (BIT_ON << pin);
-				}
-				else{
-					GPIOC_PDDR &= ~(BIT_ON << pin);
-				}
-				break;
-		case(GPIOD):
-				if(state == GPIO_OUTPUT){
-					GPIOD_PDDR |= (BIT_ON << pin);
-				}
-				else{
-					GPIOD_PDDR &= ~(BIT_ON << pin);
-				}
-				break;
-		case(GPIOE):
-				if(state == GPIO_OUTPUT){
-					GPIOE_PDDR |= (BIT_ON << pin);
-				}
-				else{
-					GPIOE_PDDR &= ~(BIT_ON << pin);
-				}
-				break;
+	if(portName > GPIOE){
+		return;
+	}
+	if(state == GPIO_OUTPUT){
+		GPIO_base[portName]->PDDR |= GPIO_PIN_MASK(pin);
+	}
+	else{
+		GPIO_base[portName]->PDDR &= ~GPIO_PIN_MASK(pin);
 	}
 }
 
 uint32 GPIO_readPORT(GPIO_portNameType portName){
+	return (portName <= GPIOE)?(GPIO_base[portName]->PDIR):(0);
+}
 
-	switch(portName){
-		case(GPIOA):
-				return GPIOA_PDIR;
-				break;
-		case(GPIOB):
-				return GPIOB_PDIR;
-				break;
-		case(GPIOC):
-				return GPIOC_PDIR;
-				break;
-		case(GPIOD):
-				return GPIOD_PDIR;
-				break;
-		case(GPIOE):
-				return GPIOE_PDIR;
-				break;
-		default:
-				return FALSE;
+uint8 GPIO_readPIN(GPIO_portNameType portName, uint8 pin){
+	return (GPIO_readPINS(portName,GPIO_PIN_MASK(pin)))?1:0;
+}
+
+void GPIO_writePORT(GPIO_portNameType portName, uint32 data){
+	if(portName <= GPIOE){
+		GPIO_base[portName]->PDOR = data;
 	}
+}
 
+void GPIO_setPIN(GPIO_portNameType portName, uint8 pin){
+	GPIO_setPINS(portName,GPIO_PIN_MASK(pin));
 }
 
-uint8 GPIO_readPIN(GPIO_portNameType portName, uint8 pin){
-	switch(portName){
-		case(GPIOA):
-				return (GPIOA_PDIR & (1 << pin))?1:0;
-				break;
-		case(GPIOB):
-				return (GPIOB_PDIR & (1 << pin))?1:0;
-				break;
-		case(GPIOC):
-				return (GPIOC_PDIR & (1 << pin))?1:0;
-				break;
-		case(GPIOD):
-				return (GPIOD_PDIR & (1 << pin))?1:0;
-				break;
-		case(GPIOE):
-				return (GPIOE_PDIR & (1 << pin))?1:0;
-				break;
-		default:
-			return FALSE;
-	}
+void GPIO_clearPIN(GPIO_portNameType portName, uint8 pin){
+	GPIO_clearPINS(portName,GPIO_PIN_MASK(pin));
 }
 
-void GPIO_writePORT(GPIO_portNameType portName, uint32 data){
+void GPIO_tooglePIN(GPIO_portNameType portName, uint8 pin){
+	GPIO_tooglePINS(portName,GPIO_PIN_MASK(pin));
+}
 
-	switch(portName){
-		case GPIOA:
-			GPIOA_PDOR = data;
-			break;
-		case GPIOB:
-			GPIOB_PDOR = data;
-			break;
-		case GPIOC:
-			GPIOC_PDOR = data;
-			break;
-		case GPIOD:
-			GPIOD_PDOR = data;
-			break;
-		case GPIOE:
-			GPIOE_PDOR = data;
-			break;
+void GPIO_setPINS(GPIO_portNameType portName, uint32 mask){
+	if(portName <= GPIOE){
+		GPIO_fastSetPINS(portName,mask);
 	}
 }
 
-void GPIO_setPIN(GPIO_portNameType portName, uint8 pin){
+void GPIO_clearPINS(GPIO_portNameType portName, uint32 mask){
+	if(portName <= GPIOE){
+		GPIO_fastClearPINS(portName,mask);
+	}
+}
 
-switch(portName){
-	case(GPIOA):
-			GPIOA_PSOR = (BIT_ON << pin);
-			break;
-	case(GPIOB):
-			GPIOB_PSOR = (BIT_ON << pin);
-			break;
-	case(GPIOC):
-			GPIOC_PSOR = (BIT_ON << pin);
-			break;
-	case(GPIOD):
-			GPIOD_PSOR = (BIT_ON << pin);
-			break;
-	case(GPIOE):
-			GPIOE_PSOR = (BIT_ON << pin);
-			break;
+void GPIO_tooglePINS(GPIO_portNameType portName, uint32 mask){
+	if(portName <= GPIOE){
+		GPIO_fastTooglePINS(portName,mask);
 	}
 }
 
-void GPIO_clearPIN(GPIO_portNameType portName, uint8 pin){
-	switch(portName){
-		case GPIOA:
-			GPIOA_PCOR = (BIT_ON << pin);
-			break;
-		case GPIOB:
-			GPIOB_PCOR = (BIT_ON << pin);
-			break;
-		case GPIOC:
-			GPIOC_PCOR = (BIT_ON << pin);
-			break;
-		case GPIOD:
-			GPIOD_PCOR = (BIT_ON << pin);
-			break;
-		case GPIOE:
-			GPIOE_PCOR = (BIT_ON << pin);
-			break;
+void GPIO_writePINS(GPIO_portNameType portName, uint32 mask, uint32 data){
+	if(portName <= GPIOE){
+		GPIO_fastWritePINS(portName,mask,data);
 	}
 }
 
-void GPIO_tooglePIN(GPIO_portNameType portName, uint8 pin){
-	switch(portName){
-		case GPIOA:
-			GPIOA_PTOR = (BIT_ON << pin);
-			break;
-		case GPIOB:
-			GPIOB_PTOR = (BIT_ON << pin);
-			break;
-		case GPIOC:
-			GPIOC_PTOR = (BIT_ON << pin);
-			break;
-		case GPIOD:
-			GPIOD_PTOR = (BIT_ON << pin);
-			break;
-		case GPIOE:
-			GPIOE_PTOR = (BIT_ON << pin);
+uint32 GPIO_readPINS(GPIO_portNameType portName, uint32 mask){
+	return (portName <= GPIOE)?(GPIO_fastReadPINS(portName,mask)):(0);
+}
+
+uint8 GPIO_debounceConfig(GPIO_portNameType portName, uint8 pin, GPIO_debounceType* debounce){
+	uint32 window = *debounce & GPIO_DEBOUNCE_MS(0xFF);
+	PORT_Type* port;
+	uint8 index;
+
+	if(portName > GPIOE || window == 0){
+		return FALSE;
+	}
+	port = portBase[portName];
+
+	/*The digital filter width is shared by all the pins of the port; It is used if no other pin
+	 * of the port has a different window*/
+	if(!(*debounce & GPIO_DEBOUNCE_LOCKOUT) && window <= GPIO_DIGITAL_FILTER_MAX_MS &&
+			(port->DFER == 0 || port->DFWR == window)){
+		/*The clock and the width can only be changed while the filter is disabled in all the pins*/
+		if(port->DFER == 0){
+			port->DFCR = DIGITAL_FILTER_LPO;
+			port->DFWR = window;
+		}
+		port->DFER |= (BIT_ON << pin);
+		return TRUE;
+	}
+
+	/*Timestamp lockout; A pin already in the table only changes its window*/
+	for(index = 0; index < lockoutPinsCount; index++){
+		if(lockoutPins[index].portName == portName && lockoutPins[index].pin == pin){
 			break;
+		}
+	}
+	if(index == GPIO_DEBOUNCE_LOCKOUT_PINS){
+		return FALSE;
+	}
+	LPTMR_init();
+	lockoutPins[index].portName = portName;
+	lockoutPins[index].pin = pin;
+	lockoutPins[index].window = window;
+	/*The first edge is always accepted*/
+	lockoutPins[index].lastAccepted = LPTMR_milliseconds() - window;
+	if(index == lockoutPinsCount){
+		lockoutPinsCount++;
 	}
+	return TRUE;
 }
 
+BooleanType GPIO_debounceAccept(GPIO_portNameType portName, uint8 pin){
+	uint32 now = LPTMR_milliseconds();
+	uint8 index;
 
-
+	for(index = 0; index < lockoutPinsCount; index++){
+		if(lockoutPins[index].portName == portName && lockoutPins[index].pin == pin){
+			/*The difference is right even if the time base overflowed*/
+			if((uint32)(now - lockoutPins[index].lastAccepted) < lockoutPins[index].window){
+				return FALSE;
+			}
+			lockoutPins[index].lastAccepted = now;
+			return TRUE;
+		}
+	}
+	return TRUE;
+}
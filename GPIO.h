@@ -12,6 +12,7 @@
 
 
 #include "DataTypeDefinitions.h"
+#include "MK64F12.h"
 
 
 /** Constant that represent the clock enable for GPIO A */
@@ -85,6 +86,26 @@ typedef enum{GPIOA, /*!< Definition to select GPIO A */
 /*! This data type is used to configure the pin control register*/
 typedef const uint32 GPIO_pinControlRegisterType;
 
+/** Debounce window of a pin in ms (1 to 255) */
+#define GPIO_DEBOUNCE_MS(ms)   ((uint32)(ms) & 0x000000FF)
+/** Uses the timestamp lockout, even if the port digital filter could be used */
+#define GPIO_DEBOUNCE_LOCKOUT  0x00000100
+/** Longest window of the digital filter, clocked by the 1kHz LPO (ms) */
+#define GPIO_DIGITAL_FILTER_MAX_MS 31
+/** Number of pins that can use the timestamp lockout */
+#define GPIO_DEBOUNCE_LOCKOUT_PINS 8
+
+/*! This data type is used to configure the debouncing of a pin*/
+typedef const uint32 GPIO_debounceType;
+
+/** Mask of a pin, used by the functions that write or read several pins of a port at once;
+ * For example, GPIO_PIN_MASK(BIT10)|GPIO_PIN_MASK(BIT11) */
+#define GPIO_PIN_MASK(pin) ((uint32)BIT_ON << (pin))
+
+/** GPIO registers of each port, indexed by GPIO_portNameType (GPIOA to GPIOE); It is defined
+ * here, so the compiler knows the address of a constant port in the inline functions */
+static GPIO_Type* const GPIO_base[] = {PTA, PTB, PTC, PTD, PTE};
+
 
 /********************************************************************************************/
 /********************************************************************************************/
@@ -210,5 +231,117 @@ void GPIO_clearPIN(GPIO_portNameType portName, uint8 pin);
  	 \return void
  */
 void GPIO_tooglePIN(GPIO_portNameType portName, uint8 pin);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This sets several pins of a GPIO port, with a single write (PSOR).
+ 	 \param[in] portName Selected Port.
+ 	 \param[in] mask Pins to be set, built with GPIO_PIN_MASK.
+ 	 \return void
+ */
+void GPIO_setPINS(GPIO_portNameType portName, uint32 mask);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This clears several pins of a GPIO port, with a single write (PCOR).
+ 	 \param[in] portName Selected Port.
+ 	 \param[in] mask Pins to be cleared, built with GPIO_PIN_MASK.
+ 	 \return void
+ */
+void GPIO_clearPINS(GPIO_portNameType portName, uint32 mask);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This toggles several pins of a GPIO port, with a single write (PTOR).
+ 	 \param[in] portName Selected Port.
+ 	 \param[in] mask Pins to be toggled, built with GPIO_PIN_MASK.
+ 	 \return void
+ */
+void GPIO_tooglePINS(GPIO_portNameType portName, uint32 mask);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This writes several pins of a GPIO port, without changing the other ones: the pins
+ 	 	 of the mask that are 1 in data are set (one PSOR write), and the ones that are 0 are
+ 	 	 cleared (one PCOR write). There is no read-modify-write of PDOR, so an interruption that
+ 	 	 writes other pins of the port can't be lost.
+ 	 \param[in] portName Selected Port.
+ 	 \param[in] mask Pins to be written, built with GPIO_PIN_MASK.
+ 	 \param[in] data Value of the pins, in their positions of the port.
+ 	 \return void
+ */
+void GPIO_writePINS(GPIO_portNameType portName, uint32 mask, uint32 data);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This reads several pins of a GPIO port, with a single read (PDIR).
+ 	 \param[in] portName Port to be read.
+ 	 \param[in] mask Pins to be read, built with GPIO_PIN_MASK.
+ 	 \return The pins of the mask, in their positions of the port; The other bits are 0.
+ */
+uint32 GPIO_readPINS(GPIO_portNameType portName, uint32 mask);
+
+/*Inline versions of the multi pin functions, for the interruption handlers. They don't check
+ * the port, so it must be GPIOA to GPIOE; With a constant port, each one compiles to a single
+ * register access (two stores for the write)*/
+static inline void GPIO_fastSetPINS(GPIO_portNameType portName, uint32 mask){
+	GPIO_base[portName]->PSOR = mask;
+}
+
+static inline void GPIO_fastClearPINS(GPIO_portNameType portName, uint32 mask){
+	GPIO_base[portName]->PCOR = mask;
+}
+
+static inline void GPIO_fastTooglePINS(GPIO_portNameType portName, uint32 mask){
+	GPIO_base[portName]->PTOR = mask;
+}
+
+static inline void GPIO_fastWritePINS(GPIO_portNameType portName, uint32 mask, uint32 data){
+	GPIO_base[portName]->PSOR = data & mask;
+	GPIO_base[portName]->PCOR = ~data & mask;
+}
+
+static inline uint32 GPIO_fastReadPINS(GPIO_portNameType portName, uint32 mask){
+	return GPIO_base[portName]->PDIR & mask;
+}
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function configures the debouncing of an input pin, so its interruption handler
+ 	 	 doesn't need to wait for the bouncing to end. The passive digital filter of the port
+ 	 	 (PORTx_DFER/DFCR/DFWR, clocked by the 1kHz LPO) is used when the window fits in it and
+ 	 	 the port filter isn't used with another window; otherwise, the pin uses a timestamp
+ 	 	 lockout window, checked by GPIO_debounceAccept with the LPTMR time base (1ms
+ 	 	 resolution), that keeps counting while the MCU sleeps.
+ 	 	 For example, to debounce a switch for 30 ms:
+ 	 	 GPIO_debounceType debounce = GPIO_DEBOUNCE_MS(30);
+ 	 \param[in] portName Port of the pin.
+ 	 \param[in] pin Pin to be debounced.
+ 	 \param[in] debounce Pointer to a constant configuration value, built with GPIO_DEBOUNCE_MS
+ 	 	 and GPIO_DEBOUNCE_LOCKOUT.
+ 	 \return 1 if the debouncing was configured else return 0
+ */
+uint8 GPIO_debounceConfig(GPIO_portNameType portName, uint8 pin, GPIO_debounceType* debounce);
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function is called by the interruption handler of a debounced pin. It returns
+ 	 	 FALSE while the lockout window of the pin, started by the last accepted edge, isn't
+ 	 	 over. Pins debounced by the digital filter, and pins without debouncing, are always
+ 	 	 accepted. It never waits.
+ 	 \param[in] portName Port of the pin.
+ 	 \param[in] pin Pin that caused the interruption.
+ 	 \return TRUE if the edge must be attended
+ */
+BooleanType GPIO_debounceAccept(GPIO_portNameType portName, uint8 pin);
 
 #endif /* SOURCES_GPIO_H_ */
@@ -17,3 +17,9 @@ void delay(uint16 delay)
 
 	}
 }
+
+void cycleCounterInit()
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
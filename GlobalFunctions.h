@@ -10,9 +10,36 @@
 
 #include "GPIO.h"
 #include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+#include "CLKMGR.h"
+
+/*Conversion from ms to cycles of the cycle counter, that counts with the core clock*/
+#define CYCLES_FROM_MS(ms) ((uint32)(CLOCKMANAGER_coreClock()/1000)*(uint32)(ms))
+/*Current value of the cycle counter; It overflows each 2^32 cycles (35 s at 120MHz), so only
+ * the difference between two values, as uint32, is meaningful*/
+#define cycleCounter() (DWT->CYCCNT)
+
+/*Placement of the code and tables of the sample path in SRAM_L (0x1FFF0000, 64KB), that the
+ * core reads through the code bus without the flash wait states and prefetch misses. The
+ * linker script of the project (Kinetis SDK, MK64FN1M0xxx12_flash.ld) puts the ".ramfunc*"
+ * input sections at the start of the .data output section, in m_data (SRAM_L), so the startup
+ * code copies them from flash with the initialized data. The calls between flash and SRAM_L
+ * are out of the BL range, and the linker adds a veneer to them.
+ * Only the ARM build places the sections in SRAM_L; The host build (HostSim) keeps them in
+ * sections of their own, so its memory map shows what the ARM build places in SRAM_L*/
+#if defined(__arm__)
+#define RAM_FUNCTION __attribute__((section(".ramfunc.code")))
+#define RAM_TABLE __attribute__((section(".ramfunc.tables"), aligned(4)))
+#else
+#define RAM_FUNCTION __attribute__((section("ramfunc_code")))
+#define RAM_TABLE __attribute__((section("ramfunc_tables"), aligned(4)))
+#endif
 
 void delay(uint16);
 
+/*Enables the DWT cycle counter, without changing its value*/
+void cycleCounterInit();
+
 
 
 #endif /* GLOBALFUNCTIONS_H_ */
@@ -0,0 +1,1817 @@
+/**
+	\file
+	\brief
+		This is the source file for the host (Linux) simulator of the K64 peripherals used
+		by this project. The simulated registers are write protected; each write of the
+		firmware raises a SIGSEGV, the write is executed alone (single step, SIGTRAP) and then
+		its side effects are modeled (set/clear/toggle registers, write 1 to clear flags,
+		timers start, DMA requests, etc.). Reads aren't trapped. The simulated time, and the
+		interruptions, are driven by a host timer (SIGALRM), that preempts the firmware as
+		the NVIC does.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <time.h>
+#include <math.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "MK64F12.h"
+#include "HostSim.h"
+#include "PRFL.h"
+#include "BRDCFG.h"
+
+/*Size of a page of the host*/
+#define PAGE_SIZE 4096
+/*Trap flag of the x86 flags register; the next instruction is executed alone*/
+#define TRAP_FLAG 0x100
+/*Real time between host timer ticks (us)*/
+#define TICK_PERIOD_US 50
+/*Maximum number of events in a scenario*/
+#define MAX_EVENTS 4096
+/*Load changes of the motor in a scenario*/
+#define MAX_LOADS 64
+/*Maximum consecutive ticks without time advance while the main loop writes registers*/
+#define MAX_HELD_TICKS 10000
+/*CPU time given to the main loop after an interruption, before the time advances (ns); The ticks
+ * can come back to back on a loaded host, so the held ticks alone don't let it run*/
+#define MAIN_LOOP_NS 100000
+/*Maximum interruptions attended in a single tick; more means a flag is never cleared*/
+#define MAX_IRQS_PER_TICK 256
+/*Interruption numbers of the K64 used by the simulator*/
+#define DMA_CH0_IRQ_NUMBER 0
+#define DAC0_IRQ_NUMBER 56
+#define PIT_CH0_IRQ_NUMBER 48
+#define PORTA_IRQ_NUMBER 59
+#define LPTMR0_IRQ_NUMBER 58
+/*PIT channel with the same number as a DMA channel is its periodic trigger*/
+#define DMA_PERIODIC_CHANNELS 4
+/*DMAMUX request source of the FTM0 channel 0; The other channels follow it*/
+#define FTM0_CH0_DMA_SOURCE 20
+/*PDB input trigger for software*/
+#define PDB_SOFTWARE_TRIGGER 15
+/*PCR IRQC values*/
+#define IRQC_LOGIC0 8
+#define IRQC_RISING 9
+#define IRQC_FALLING 10
+#define IRQC_EITHER 11
+#define IRQC_LOGIC1 12
+/*LPTMR prescaler clock select of the LPO, and counts of the free running counter*/
+#define LPTMR_LPO 1
+#define LPTMR_COUNTS 0x10000
+/*SMC stop mode VLPS, run mode VLPR, and PMSTAT values*/
+#define SMC_STOPM_VLPS 2
+#define SMC_RUNM_VLPR 2
+#define PMSTAT_RUN 0x01
+#define PMSTAT_STOP 0x02
+#define PMSTAT_VLPR 0x04
+#define PMSTAT_VLPS 0x10
+/*MCG references: slow and fast internal references, and the external clock of the FRDM-K64F
+ * (EXTAL0); FLL factor of the internal reference, and PLL multiplier offset (VDIV0 + 24)*/
+#define SLOW_IRC_CLOCK 32768
+#define FAST_IRC_CLOCK 4000000
+#define EXTERNAL_CLOCK 50000000
+#define FLL_FACTOR 640
+#define PLL_VDIV_OFFSET 24
+/*MCG C1[CLKS] and S[CLKST] values*/
+#define CLKS_FLL_PLL 0
+#define CLKS_INTERNAL 1
+#define CLKS_EXTERNAL 2
+#define CLKST_PLL 3
+/*Limits of the K64 clocks in RUN mode, and of the PLL reference and output (Hz)*/
+#define MAX_CORE_CLOCK 120000000
+#define MAX_BUS_CLOCK 60000000
+#define MAX_FLASH_CLOCK 25000000
+#define VLPR_MAX_CORE_CLOCK 4000000
+#define VLPR_MAX_BUS_CLOCK 4000000
+#define VLPR_MAX_FLASH_CLOCK 1000000
+#define PLL_MIN_REFERENCE 2000000
+#define PLL_MAX_REFERENCE 4000000
+#define PLL_MIN_OUTPUT 48000000
+#define PLL_MAX_OUTPUT 120000000
+
+/*Pin event of a scenario*/
+typedef struct{
+	uint64 time;
+	uint8 port;
+	uint8 pin;
+	uint8 level;
+}HOSTSIM_EventType;
+
+/*Statistics of an interruption*/
+typedef struct{
+	uint32 count;
+	uint64 registerWrites;
+	uint64 hostNanosecondsTotal;
+	uint64 hostNanosecondsMax;
+}HOSTSIM_IrqStatsType;
+
+/*The simulated peripherals, page aligned and padded to full pages so they can be write protected
+ * alone; HOSTSIM_peripherals is the name used by MK64F12.h*/
+#define BLOCK_SIZE (((sizeof(HOSTSIM_PeripheralsType) + PAGE_SIZE - 1)/PAGE_SIZE)*PAGE_SIZE)
+static union{
+	HOSTSIM_PeripheralsType registers;
+	uint8_t page[BLOCK_SIZE];
+}peripheralBlock __attribute__((aligned(PAGE_SIZE)));
+extern HOSTSIM_PeripheralsType HOSTSIM_peripherals __attribute__((alias("peripheralBlock")));
+
+/*Short name for the registers, used by the simulator*/
+#define P (peripheralBlock.registers)
+
+/*Copy of the registers before the write being trapped*/
+static uint8_t snapshot[sizeof(HOSTSIM_PeripheralsType)];
+/*Address written by the instruction being trapped*/
+static volatile uint8_t* trapAddress = NULL;
+/*SIGALRM was blocked before the trapped instruction*/
+static int trapAlarmWasBlocked;
+/*Nesting of the write enable of the registers*/
+static int unlockDepth = 0;
+
+/*Core debug, DWT and SCB; They aren't part of the protected block*/
+CoreDebug_Type HOSTSIM_coreDebug;
+SCB_Type HOSTSIM_scb;
+static DWT_Type dwt;
+static int dwtRunning = FALSE;
+static uint64 dwtOriginHostTime;
+static uint64 dwtOriginTime;
+static uint32 dwtOriginCount;
+static uint32 dwtLastCount;
+static uint64 dwtOriginInstructions;
+/*Firmware instructions retired until the time starts; The firmware is single stepped meanwhile*/
+static uint64 bootInstructions = 0;
+
+/*Simulated time (1/HOSTSIM_TIME_BASE s), and the end of the simulation*/
+static uint64 now = 0;
+static uint64 endTime = HOSTSIM_MS(1000);
+/*Time starts when the firmware enables the interruptions*/
+static int started = FALSE;
+/*Trace of outputs*/
+static FILE* traceFile = NULL;
+
+/*Scenario events, sorted by time*/
+static HOSTSIM_EventType events[MAX_EVENTS];
+static uint32 eventCount = 0;
+static uint32 nextEvent = 0;
+static int eventsSorted = FALSE;
+
+/*Pins driven by the scenario, and their level*/
+static uint32 drivenMask[5];
+static uint32 drivenLevel[5];
+/*Last value of PDOR written in the trace, per port*/
+static uint32 tracedPdor[5];
+/*Digital filter: last input levels, filtered levels, pins with the filter enabled, and time when
+ * each pin takes its input level if it doesn't change again (0 if it isn't changing)*/
+static uint32 lastInputs[5];
+static uint32 filteredInputs[5];
+static uint32 filteredPins[5];
+static uint64 filterDeadline[5][32];
+
+/*PIT channels: running, and next expiry*/
+static int pitRunning[4];
+static uint64 pitNextExpiry[4];
+
+/*PDB: running, and next DAC interval trigger*/
+static int pdbRunning = FALSE;
+static uint64 pdbNextDacTrigger;
+
+/*FTM0: counting, start of the current PWM period, and for each channel, the duty taken at the last
+ * reload point, if its match of the current period is done, and the duty and period last written
+ * in the trace*/
+static int ftmRunning = FALSE;
+static uint64 ftmPeriodStart;
+static uint32 ftmActiveDuty[8];
+static int ftmMatched[8];
+static int64_t tracedFtmDuty[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+static uint32 tracedFtmPeriod[8];
+
+/*Motor plant: speed (RPM), position (encoder edges), edges given to the FTM1 decoder, time of the
+ * state, load (percent of HOSTSIM_MOTOR_RPM), and last speed written in the trace*/
+static double motorRpm = 0;
+static double motorEdges = 0;
+static int64_t motorCountedEdges = 0;
+static uint64 motorTime = 0;
+static int motorLoad = 0;
+static int tracedMotorRpm = 0;
+/*Load changes of the scenario, sorted by time*/
+static struct{
+	uint64 time;
+	int percent;
+}loads[MAX_LOADS];
+static uint32 loadCount = 0;
+static uint32 nextLoad = 0;
+
+/*LPTMR: running, time when it was enabled, and next compare*/
+static int lptmrRunning = FALSE;
+static uint64 lptmrOrigin;
+static uint64 lptmrNextCompare;
+
+/*Clocks: core, bus and flash clocks (Hz), and simulated time of a count of the bus and core
+ * clocks*/
+static uint32 coreClock = HOSTSIM_RESET_CLOCK;
+static uint32 busClock = HOSTSIM_RESET_CLOCK;
+static uint32 flashClock = HOSTSIM_RESET_CLOCK/2;
+static uint64 busCount = HOSTSIM_TIME_BASE/HOSTSIM_RESET_CLOCK;
+static uint64 coreCount = HOSTSIM_TIME_BASE/HOSTSIM_RESET_CLOCK;
+
+/*Run modes: time spent in each one (0 RUN, 1 VLPR), and time when the current one was entered*/
+static uint64 runModeTime[2];
+static uint64 runModeStart = 0;
+
+/*Sleep: the bus clock is stopped (stop modes), and the statistics of each mode (0 wait, 1 stop)*/
+static int busClockStopped = FALSE;
+static uint32 sleepEntries[2];
+static uint64 sleepTime[2];
+/*Mode of the sleep in progress (-1 awake) and its start, so a sleep that lasts until the end is counted*/
+static int sleepMode = -1;
+static uint64 sleepStart;
+
+/*DACs: last output written in the trace, and swing direction of each one*/
+static int tracedDacOutput[2] = {-1, -1};
+static int dacSwingDown[2];
+
+/*NVIC*/
+static uint8 nvicEnabled[HOSTSIM_IRQ_COUNT];
+static uint8 nvicPriority[HOSTSIM_IRQ_COUNT];
+static uint32 basePri = 0;
+static int primask = FALSE;
+static int currentIrq = -1;
+/*Register writes of the main loop (out of the host timer), and at the last tick*/
+static volatile uint64 threadWrites = 0;
+static uint64 tickThreadWrites = 0;
+static uint32 heldTicks = 0;
+static volatile int inTick = FALSE;
+static int irqsInLastTick = FALSE;
+/*CPU time of the host thread at the end of the last tick, and CPU time of the main loop since the
+ * last interruption or register write (ns)*/
+static uint64 tickEndCpu = 0;
+static uint64 mainLoopCpu = 0;
+/*The core woke up from WFI, and hasn't gone to sleep again*/
+static int coreAwake = FALSE;
+static HOSTSIM_IrqStatsType irqStats[HOSTSIM_IRQ_COUNT];
+static uint64 registerWrites = 0;
+/*Register writes of the initialization, before the first enabling of the interruptions*/
+static uint64 bootRegisterWrites = 0;
+
+/*Interruption handlers of the firmware; Weak, so the ones that aren't defined are NULL*/
+extern void DMA0_IRQHandler(void) __attribute__((weak));
+extern void DAC0_IRQHandler(void) __attribute__((weak));
+extern void PIT0_IRQHandler(void) __attribute__((weak));
+extern void PIT1_IRQHandler(void) __attribute__((weak));
+extern void PIT2_IRQHandler(void) __attribute__((weak));
+extern void PIT3_IRQHandler(void) __attribute__((weak));
+extern void PORTA_IRQHandler(void) __attribute__((weak));
+extern void PORTB_IRQHandler(void) __attribute__((weak));
+extern void PORTC_IRQHandler(void) __attribute__((weak));
+extern void PORTD_IRQHandler(void) __attribute__((weak));
+extern void PORTE_IRQHandler(void) __attribute__((weak));
+extern void LPTMR0_IRQHandler(void) __attribute__((weak));
+
+/*Limits of the sections of the functions and tables that the ARM build places in SRAM_L (RAM_FUNCTION
+ * and RAM_TABLE, in GlobalFunctions.h), given by the host linker; Weak, as they may be empty*/
+extern const char __start_ramfunc_code[] __attribute__((weak));
+extern const char __stop_ramfunc_code[] __attribute__((weak));
+extern const char __start_ramfunc_tables[] __attribute__((weak));
+extern const char __stop_ramfunc_tables[] __attribute__((weak));
+
+static void (*irqHandler(int irq))(void){
+	switch(irq){
+		case DMA_CH0_IRQ_NUMBER: return DMA0_IRQHandler;
+		case DAC0_IRQ_NUMBER: return DAC0_IRQHandler;
+		case PIT_CH0_IRQ_NUMBER: return PIT0_IRQHandler;
+		case PIT_CH0_IRQ_NUMBER + 1: return PIT1_IRQHandler;
+		case PIT_CH0_IRQ_NUMBER + 2: return PIT2_IRQHandler;
+		case PIT_CH0_IRQ_NUMBER + 3: return PIT3_IRQHandler;
+		case PORTA_IRQ_NUMBER: return PORTA_IRQHandler;
+		case PORTA_IRQ_NUMBER + 1: return PORTB_IRQHandler;
+		case PORTA_IRQ_NUMBER + 2: return PORTC_IRQHandler;
+		case PORTA_IRQ_NUMBER + 3: return PORTD_IRQHandler;
+		case PORTA_IRQ_NUMBER + 4: return PORTE_IRQHandler;
+		case LPTMR0_IRQ_NUMBER: return LPTMR0_IRQHandler;
+		default: return NULL;
+	}
+}
+
+/********************************************************************************************/
+/* Write protection                                                                         */
+/********************************************************************************************/
+
+static void unlock(){
+	if(unlockDepth++ == 0){
+		mprotect(&peripheralBlock, BLOCK_SIZE, PROT_READ | PROT_WRITE);
+	}
+}
+
+static void lock(){
+	if(--unlockDepth == 0){
+		mprotect(&peripheralBlock, BLOCK_SIZE, PROT_READ);
+	}
+}
+
+/*Value of a register before the write being modeled*/
+#define OLD(reg) (*(__typeof__((reg) + 0)*)(snapshot + ((const uint8_t*)&(reg) - (const uint8_t*)&P)))
+/*TRUE if the address being modeled is inside the register*/
+#define IS(address,reg) ((address) >= (const uint8_t*)&(reg) && (address) < (const uint8_t*)&(reg) + sizeof(reg))
+
+static uint64 microseconds(uint64 time){
+	return time/(HOSTSIM_TIME_BASE/1000000ULL);
+}
+
+/********************************************************************************************/
+/* GPIO and PORT                                                                            */
+/********************************************************************************************/
+
+static uint64 filterWidth(int port){
+	/*The width is counted with the LPO (1kHz) or with the bus clock*/
+	uint32 width = P.PORT[port].DFWR & 0x1F;
+	return (P.PORT[port].DFCR & 0x1)?(HOSTSIM_MS(width)):(width*busCount);
+}
+
+static uint32 pinLevels(int port){
+	uint32 levels = 0;
+	uint32 pullUps = 0;
+	uint32 changed;
+	int pin;
+	/*Pins not driven by the scenario take the level of the pull resistor (0 without it)*/
+	for(pin = 0; pin < 32; pin++){
+		if((P.PORT[port].PCR[pin] & 0x3) == 0x3){
+			pullUps |= (1u << pin);
+		}
+	}
+	levels = (drivenLevel[port] & drivenMask[port]) | (pullUps & ~drivenMask[port]);
+
+	/*Digital filter: a pin that starts being filtered takes its current level, and each change
+	 * restarts the window of the pin; The level passes when it is stable during the window*/
+	filteredInputs[port] = (filteredInputs[port] & filteredPins[port]) | (levels & ~filteredPins[port]);
+	filteredPins[port] = (filterWidth(port))?(P.PORT[port].DFER):(0);
+	changed = levels ^ lastInputs[port];
+	for(pin = 0; pin < 32; pin++){
+		uint32 bit = 1u << pin;
+		if(!(filteredPins[port] & bit)){
+			filterDeadline[port][pin] = 0;
+		} else if((levels & bit) == (filteredInputs[port] & bit)){
+			filterDeadline[port][pin] = 0;
+		} else if((changed & bit) || filterDeadline[port][pin] == 0){
+			filterDeadline[port][pin] = now + filterWidth(port);
+		} else if(filterDeadline[port][pin] <= now){
+			filteredInputs[port] ^= bit;
+			filterDeadline[port][pin] = 0;
+		}
+	}
+	lastInputs[port] = levels;
+	levels = (levels & ~filteredPins[port]) | (filteredInputs[port] & filteredPins[port]);
+
+	/*Outputs take the value of PDOR*/
+	return (levels & ~P.GPIO[port].PDDR) | (P.GPIO[port].PDOR & P.GPIO[port].PDDR);
+}
+
+static void portSyncIsf(int port){
+	int pin;
+	for(pin = 0; pin < 32; pin++){
+		if(P.PORT[port].ISFR & (1u << pin)){
+			P.PORT[port].PCR[pin] |= PORT_PCR_ISF_MASK;
+		} else {
+			P.PORT[port].PCR[pin] &= ~PORT_PCR_ISF_MASK;
+		}
+	}
+}
+
+static void gpioUpdate(int port){
+	uint32 oldLevels = P.GPIO[port].PDIR;
+	uint32 newLevels = pinLevels(port);
+	int pin;
+
+	P.GPIO[port].PDIR = newLevels;
+	/*Interruption flags, according to the IRQC of each pin*/
+	for(pin = 0; pin < 32; pin++){
+		uint32 bit = 1u << pin;
+		uint32 irqc = (P.PORT[port].PCR[pin] & PORT_PCR_IRQC_MASK) >> PORT_PCR_IRQC_SHIFT;
+		int rising = !(oldLevels & bit) && (newLevels & bit);
+		int falling = (oldLevels & bit) && !(newLevels & bit);
+		if((irqc == IRQC_RISING && rising) || (irqc == IRQC_FALLING && falling) ||
+				(irqc == IRQC_EITHER && (rising || falling)) ||
+				(irqc == IRQC_LOGIC0 && !(newLevels & bit)) || (irqc == IRQC_LOGIC1 && (newLevels & bit))){
+			P.PORT[port].ISFR |= bit;
+		}
+	}
+	portSyncIsf(port);
+
+	/*Outputs are recorded*/
+	if(P.GPIO[port].PDOR != tracedPdor[port]){
+		tracedPdor[port] = P.GPIO[port].PDOR;
+		if(traceFile){
+			fprintf(traceFile, "%llu GPIO%c PDOR 0x%08X\n", (unsigned long long)microseconds(now), 'A' + port, (unsigned)tracedPdor[port]);
+		}
+	}
+}
+
+static int gpioWritten(const uint8_t* address){
+	int port;
+	for(port = 0; port < 5; port++){
+		GPIO_Type* gpio = &P.GPIO[port];
+		if(IS(address, gpio->PSOR)){
+			gpio->PDOR |= gpio->PSOR;
+			gpio->PSOR = 0;
+		} else if(IS(address, gpio->PCOR)){
+			gpio->PDOR &= ~gpio->PCOR;
+			gpio->PCOR = 0;
+		} else if(IS(address, gpio->PTOR)){
+			gpio->PDOR ^= gpio->PTOR;
+			gpio->PTOR = 0;
+		} else if(IS(address, gpio->PDIR)){
+			gpio->PDIR = OLD(gpio->PDIR);
+		} else if(!IS(address, *gpio)){
+			continue;
+		}
+		gpioUpdate(port);
+		return TRUE;
+	}
+	for(port = 0; port < 5; port++){
+		PORT_Type* portRegs = &P.PORT[port];
+		int pin;
+		if(IS(address, portRegs->ISFR)){
+			/*Write 1 to clear*/
+			portRegs->ISFR = OLD(portRegs->ISFR) & ~portRegs->ISFR;
+		} else if(IS(address, portRegs->PCR)){
+			pin = (address - (const uint8_t*)&portRegs->PCR[0])/sizeof(uint32_t);
+			if(portRegs->PCR[pin] & PORT_PCR_ISF_MASK){
+				portRegs->ISFR &= ~(1u << pin);
+			}
+		} else if(!IS(address, *portRegs)){
+			continue;
+		}
+		portSyncIsf(port);
+		gpioUpdate(port);
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/********************************************************************************************/
+/* PIT                                                                                      */
+/********************************************************************************************/
+
+static void pitUpdateRunning(){
+	int channel;
+	for(channel = 0; channel < 4; channel++){
+		int running = !(PIT->MCR & PIT_MCR_MDIS_MASK) && (PIT->CHANNEL[channel].TCTRL & PIT_TCTRL_TEN_MASK);
+		if(running && !pitRunning[channel]){
+			/*The counter starts from the load value*/
+			pitNextExpiry[channel] = now + ((uint64)PIT->CHANNEL[channel].LDVAL + 1)*busCount;
+			PIT->CHANNEL[channel].CVAL = PIT->CHANNEL[channel].LDVAL;
+		}
+		pitRunning[channel] = running;
+	}
+}
+
+static int pitWritten(const uint8_t* address){
+	int channel;
+	if(IS(address, PIT->MCR)){
+		pitUpdateRunning();
+		return TRUE;
+	}
+	for(channel = 0; channel < 4; channel++){
+		if(IS(address, PIT->CHANNEL[channel].TFLG)){
+			PIT->CHANNEL[channel].TFLG = OLD(PIT->CHANNEL[channel].TFLG) & ~PIT->CHANNEL[channel].TFLG;
+			return TRUE;
+		} else if(IS(address, PIT->CHANNEL[channel].TCTRL)){
+			pitUpdateRunning();
+			return TRUE;
+		} else if(IS(address, PIT->CHANNEL[channel].CVAL)){
+			PIT->CHANNEL[channel].CVAL = OLD(PIT->CHANNEL[channel].CVAL);
+			return TRUE;
+		}
+	}
+	return IS(address, *PIT);
+}
+
+/********************************************************************************************/
+/* DAC                                                                                      */
+/********************************************************************************************/
+
+/*Registers of each DAC*/
+static DAC_Type* const dacs[2] = {DAC0, DAC1};
+
+static void dacUpdate(int instance){
+	DAC_Type* dac = dacs[instance];
+	uint8 readPointer = (dac->C2 & DAC_C2_DACBFRP_MASK) >> DAC_C2_DACBFRP_SHIFT;
+	int output = 0;
+	if(dac->C0 & DAC_C0_DACEN_MASK){
+		if(!(dac->C1 & DAC_C1_DACBFEN_MASK)){
+			readPointer = 0;
+		}
+		output = dac->DAT[readPointer].DATL | ((dac->DAT[readPointer].DATH & 0x0F) << 8);
+	}
+	if(output != tracedDacOutput[instance]){
+		tracedDacOutput[instance] = output;
+		if(traceFile){
+			fprintf(traceFile, "%llu DAC%d %d\n", (unsigned long long)microseconds(now), instance, output);
+		}
+	}
+}
+
+static void dacTrigger(int instance){
+	DAC_Type* dac = dacs[instance];
+	uint8 upper = dac->C2 & DAC_C2_DACBFUP_MASK;
+	uint8 readPointer = (dac->C2 & DAC_C2_DACBFRP_MASK) >> DAC_C2_DACBFRP_SHIFT;
+	uint8 mode = (dac->C1 & DAC_C1_DACBFMD_MASK) >> DAC_C1_DACBFMD_SHIFT;
+	uint8 watermarkWords = ((dac->C1 & DAC_C1_DACBFWM_MASK) >> DAC_C1_DACBFWM_SHIFT) + 1;
+
+	if(!(dac->C1 & DAC_C1_DACBFEN_MASK)){
+		return;
+	}
+	/*Moves the read pointer according to the work mode*/
+	if(mode == 1){
+		if(dacSwingDown[instance]){
+			readPointer = (readPointer == 0)?(1):(readPointer - 1);
+			dacSwingDown[instance] = (readPointer != 0) && dacSwingDown[instance];
+			if(readPointer == 1 && upper == 0){
+				readPointer = 0;
+			}
+		} else {
+			readPointer = (readPointer >= upper)?(upper ? upper - 1 : 0):(readPointer + 1);
+			dacSwingDown[instance] = (readPointer + 1 >= upper);
+		}
+	} else if(mode == 2){
+		if(readPointer < upper){
+			readPointer++;
+		}
+	} else {
+		readPointer = (readPointer >= upper)?(0):(readPointer + 1);
+	}
+	dac->C2 = (dac->C2 & ~DAC_C2_DACBFRP_MASK) | DAC_C2_DACBFRP(readPointer);
+
+	/*Flags; The ones with their interruption enabled are recorded in the trace, as they ask for a
+	 * refill of the buffer*/
+	if(readPointer == 0){
+		dac->SR |= DAC_SR_DACBFRPTF_MASK;
+		if(traceFile && (dac->C0 & DAC_C0_DACBTIEN_MASK)){
+			fprintf(traceFile, "%llu DAC%d flag top\n", (unsigned long long)microseconds(now), instance);
+		}
+	}
+	if(readPointer == upper){
+		dac->SR |= DAC_SR_DACBFRPBF_MASK;
+		if(traceFile && (dac->C0 & DAC_C0_DACBBIEN_MASK)){
+			fprintf(traceFile, "%llu DAC%d flag bottom\n", (unsigned long long)microseconds(now), instance);
+		}
+	}
+	if(upper >= watermarkWords && readPointer == upper - watermarkWords){
+		dac->SR |= DAC_SR_DACBFWMF_MASK;
+		if(traceFile && (dac->C0 & DAC_C0_DACBWIEN_MASK)){
+			fprintf(traceFile, "%llu DAC%d flag watermark\n", (unsigned long long)microseconds(now), instance);
+		}
+	}
+	dacUpdate(instance);
+}
+
+static int dacWritten(const uint8_t* address){
+	int instance;
+	for(instance = 0; instance < 2; instance++){
+		DAC_Type* dac = dacs[instance];
+		if(!IS(address, *dac)){
+			continue;
+		}
+		if(IS(address, dac->SR)){
+			/*Flags are cleared writing 0*/
+			dac->SR = OLD(dac->SR) & dac->SR;
+		} else if(IS(address, dac->C0) && (dac->C0 & DAC_C0_DACSWTRG_MASK)){
+			dac->C0 &= ~DAC_C0_DACSWTRG_MASK;
+			if(dac->C0 & DAC_C0_DACTRGSEL_MASK){
+				dacTrigger(instance);
+			}
+		}
+		dacUpdate(instance);
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/********************************************************************************************/
+/* eDMA, DMAMUX and PDB                                                                     */
+/********************************************************************************************/
+
+static void registerWritten(const uint8_t* address);
+
+static void dmaMinorLoop(int channel){
+	uint32 size = 1u << ((DMA0->TCD[channel].ATTR & DMA_ATTR_SSIZE_MASK) >> DMA_ATTR_SSIZE_SHIFT);
+	uint32 bytes;
+
+	for(bytes = 0; bytes < DMA0->TCD[channel].NBYTES_MLNO; bytes += size){
+		uint8_t* source = (uint8_t*)(uintptr_t)DMA0->TCD[channel].SADDR;
+		uint8_t* destination = (uint8_t*)(uintptr_t)DMA0->TCD[channel].DADDR;
+		if(destination >= peripheralBlock.page && destination < peripheralBlock.page + sizeof(P)){
+			/*Writes to registers are modeled as the firmware writes*/
+			memcpy(snapshot, &P, sizeof(P));
+			memcpy(destination, source, size);
+			registerWritten(destination);
+		} else {
+			memcpy(destination, source, size);
+		}
+		DMA0->TCD[channel].SADDR += DMA0->TCD[channel].SOFF;
+		DMA0->TCD[channel].DADDR += DMA0->TCD[channel].DOFF;
+	}
+
+	/*Major loop*/
+	DMA0->TCD[channel].CITER_ELINKNO--;
+	if(DMA0->TCD[channel].CITER_ELINKNO == 0){
+		uint16 csr = DMA0->TCD[channel].CSR;
+		if(csr & DMA_CSR_ESG_MASK){
+			/*Scatter gather: the next descriptor is loaded from memory, in the TCD layout*/
+			memcpy((void*)&DMA0->TCD[channel], (const void*)(uintptr_t)(uint32)DMA0->TCD[channel].DLAST_SGA, sizeof(DMA0->TCD[channel]));
+		} else {
+			DMA0->TCD[channel].SADDR += DMA0->TCD[channel].SLAST;
+			DMA0->TCD[channel].DADDR += DMA0->TCD[channel].DLAST_SGA;
+			DMA0->TCD[channel].CITER_ELINKNO = DMA0->TCD[channel].BITER_ELINKNO;
+			DMA0->TCD[channel].CSR |= DMA_CSR_DONE_MASK;
+		}
+		if(csr & DMA_CSR_INTMAJOR_MASK){
+			DMA0->INT |= (1u << channel);
+		}
+		if(csr & DMA_CSR_DREQ_MASK){
+			DMA0->ERQ &= ~(1u << channel);
+		}
+	}
+}
+
+static int dmaWritten(const uint8_t* address){
+	int channel;
+	if(IS(address, DMA0->SERQ)){
+		uint8 value = DMA0->SERQ;
+		if(!(value & DMA_SERQ_NOP_MASK)){
+			DMA0->ERQ |= (value & DMA_SERQ_SAER_MASK)?(0xFFFFu):(1u << (value & 0xF));
+		}
+		DMA0->SERQ = 0;
+	} else if(IS(address, DMA0->CERQ)){
+		uint8 value = DMA0->CERQ;
+		if(!(value & DMA_SERQ_NOP_MASK)){
+			DMA0->ERQ &= (value & DMA_SERQ_SAER_MASK)?(0):(~(1u << (value & 0xF)));
+		}
+		DMA0->CERQ = 0;
+	} else if(IS(address, DMA0->CINT)){
+		uint8 value = DMA0->CINT;
+		DMA0->INT &= (value & DMA_SERQ_SAER_MASK)?(0):(~(1u << (value & 0xF)));
+		DMA0->CINT = 0;
+	} else if(IS(address, DMA0->ERQ) || IS(address, DMA0->INT)){
+		/*INT is write 1 to clear*/
+		if(IS(address, DMA0->INT)){
+			DMA0->INT = OLD(DMA0->INT) & ~DMA0->INT;
+		}
+	} else {
+		for(channel = 0; channel < 16; channel++){
+			if(IS(address, DMA0->TCD[channel].CSR) && (DMA0->TCD[channel].CSR & DMA_CSR_START_MASK)){
+				/*Software request*/
+				DMA0->TCD[channel].CSR &= ~DMA_CSR_START_MASK;
+				dmaMinorLoop(channel);
+			}
+		}
+	}
+	return IS(address, *DMA0);
+}
+
+static void pdbUpdateNextTrigger(){
+	uint32 prescaler = 1u << ((PDB0->SC & PDB_SC_PRESCALER_MASK) >> PDB_SC_PRESCALER_SHIFT);
+	static const uint32 multiplier[4] = {1, 10, 20, 40};
+	uint64 period = (uint64)(PDB0->DAC[0].INT + 1)*prescaler*multiplier[(PDB0->SC & PDB_SC_MULT_MASK) >> PDB_SC_MULT_SHIFT];
+	pdbNextDacTrigger = now + period*busCount;
+}
+
+static int pdbWritten(const uint8_t* address){
+	if(!IS(address, *PDB0)){
+		return FALSE;
+	}
+	if(IS(address, PDB0->SC)){
+		if(!(PDB0->SC & PDB_SC_PDBEN_MASK)){
+			pdbRunning = FALSE;
+		} else if((PDB0->SC & PDB_SC_SWTRIG_MASK) &&
+				((PDB0->SC & PDB_SC_TRGSEL_MASK) >> PDB_SC_TRGSEL_SHIFT) == PDB_SOFTWARE_TRIGGER){
+			pdbRunning = TRUE;
+			pdbUpdateNextTrigger();
+		}
+		/*LDOK and SWTRIG are cleared by the hardware*/
+		PDB0->SC &= ~(PDB_SC_SWTRIG_MASK | PDB_SC_LDOK_MASK);
+	}
+	return TRUE;
+}
+
+/********************************************************************************************/
+/* FTM0                                                                                     */
+/********************************************************************************************/
+
+static uint64 ftmCountTime(){
+	return ((uint64)1 << (FTM0->SC & FTM_SC_PS_MASK))*busCount;
+}
+
+static uint32 ftmPeriodCounts(){
+	return (FTM0->MOD & 0xFFFF) - (FTM0->CNTIN & 0xFFFF) + 1;
+}
+
+static int ftmPwmChannel(int channel){
+	/*Edge aligned PWM: up counter, MSB set and an output level selected*/
+	uint32 control = FTM0->CONTROLS[channel].CnSC;
+	return !(FTM0->SC & FTM_SC_CPWMS_MASK) && (control & FTM_CnSC_MSB_MASK) && (control & (FTM_CnSC_ELSA_MASK | FTM_CnSC_ELSB_MASK));
+}
+
+static int ftmDmaArmed(int channel){
+	/*The match requests the DMA channel that has the channel as its DMAMUX source, if its hardware
+	 * requests are enabled*/
+	int dmaChannel;
+	if((FTM0->CONTROLS[channel].CnSC & (FTM_CnSC_DMA_MASK | FTM_CnSC_CHIE_MASK)) != (FTM_CnSC_DMA_MASK | FTM_CnSC_CHIE_MASK)){
+		return -1;
+	}
+	for(dmaChannel = 0; dmaChannel < 16; dmaChannel++){
+		if((DMAMUX->CHCFG[dmaChannel] & DMAMUX_CHCFG_ENBL_MASK) &&
+				(DMAMUX->CHCFG[dmaChannel] & DMAMUX_CHCFG_SOURCE_MASK) == FTM0_CH0_DMA_SOURCE + channel &&
+				(DMA0->ERQ & (1u << dmaChannel))){
+			return dmaChannel;
+		}
+	}
+	return -1;
+}
+
+static void ftmReload(){
+	/*The duties written during the period are taken, and the outputs are recorded*/
+	int channel;
+	for(channel = 0; channel < 8; channel++){
+		ftmActiveDuty[channel] = FTM0->CONTROLS[channel].CnV & 0xFFFF;
+		ftmMatched[channel] = FALSE;
+		if(ftmPwmChannel(channel) && (ftmActiveDuty[channel] != tracedFtmDuty[channel] || ftmPeriodCounts() != tracedFtmPeriod[channel])){
+			tracedFtmDuty[channel] = ftmActiveDuty[channel];
+			tracedFtmPeriod[channel] = ftmPeriodCounts();
+			if(traceFile){
+				fprintf(traceFile, "%llu FTM0 CH%d duty %u period %u\n", (unsigned long long)microseconds(now), channel,
+						(unsigned)((ftmActiveDuty[channel] > tracedFtmPeriod[channel])?(tracedFtmPeriod[channel]):(ftmActiveDuty[channel])),
+						(unsigned)tracedFtmPeriod[channel]);
+			}
+		}
+	}
+}
+
+static uint64 ftmNextEvent(){
+	uint64 period = ftmPeriodCounts()*ftmCountTime();
+	uint64 next = UINT64_MAX;
+	int reloadNeeded = FALSE;
+	int channel;
+	if(!ftmRunning || busClockStopped){
+		return next;
+	}
+	/*Only the reload points that change a duty, and the matches that request the DMA, are events*/
+	for(channel = 0; channel < 8; channel++){
+		if(!ftmPwmChannel(channel)){
+			continue;
+		}
+		if((FTM0->CONTROLS[channel].CnV & 0xFFFF) != ftmActiveDuty[channel]){
+			reloadNeeded = TRUE;
+		}
+		if(ftmDmaArmed(channel) >= 0){
+			reloadNeeded = TRUE;
+			if(!ftmMatched[channel] && ftmActiveDuty[channel] < ftmPeriodCounts() &&
+					ftmPeriodStart + ftmActiveDuty[channel]*ftmCountTime() < next){
+				next = ftmPeriodStart + ftmActiveDuty[channel]*ftmCountTime();
+			}
+		}
+	}
+	if(reloadNeeded && ftmPeriodStart + period < next){
+		next = ftmPeriodStart + period;
+	}
+	return next;
+}
+
+static void ftmAdvance(){
+	uint64 period = ftmPeriodCounts()*ftmCountTime();
+	int channel;
+	if(!ftmRunning || busClockStopped){
+		return;
+	}
+	/*Reload point; After a time without events, the counter is put in its current period*/
+	if(now >= ftmPeriodStart + period){
+		ftmPeriodStart += ((now - ftmPeriodStart)/period)*period;
+		ftmReload();
+	}
+	/*Matches of the current period; A match with the DMA request enabled is a minor loop of its
+	 * channel, that clears the flag*/
+	for(channel = 0; channel < 8; channel++){
+		if(ftmPwmChannel(channel) && !ftmMatched[channel] && ftmActiveDuty[channel] < ftmPeriodCounts() &&
+				ftmPeriodStart + ftmActiveDuty[channel]*ftmCountTime() <= now){
+			int dmaChannel = ftmDmaArmed(channel);
+			ftmMatched[channel] = TRUE;
+			FTM0->CONTROLS[channel].CnSC |= FTM_CnSC_CHF_MASK;
+			if(dmaChannel >= 0){
+				FTM0->CONTROLS[channel].CnSC &= ~FTM_CnSC_CHF_MASK;
+				dmaMinorLoop(dmaChannel);
+			}
+		}
+	}
+}
+
+static void ftmRestart(){
+	/*The counter starts a period from CNTIN*/
+	ftmPeriodStart = now;
+	ftmReload();
+}
+
+static int ftmWritten(const uint8_t* address){
+	int channel;
+	if(!IS(address, *FTM0)){
+		return FALSE;
+	}
+	if(IS(address, FTM0->SC)){
+		/*TOF is cleared writing 0 after reading it*/
+		FTM0->SC = (FTM0->SC & ~FTM_SC_TOF_MASK) | (OLD(FTM0->SC) & FTM0->SC & FTM_SC_TOF_MASK);
+		if((FTM0->SC & FTM_SC_CLKS_MASK) && !ftmRunning){
+			ftmRunning = TRUE;
+			ftmRestart();
+		} else if(!(FTM0->SC & FTM_SC_CLKS_MASK)){
+			ftmRunning = FALSE;
+		}
+	} else if(IS(address, FTM0->CNT) || IS(address, FTM0->MOD) || IS(address, FTM0->CNTIN)){
+		/*A write to CNT loads CNTIN; MOD and CNTIN are only written while the counter is stopped*/
+		FTM0->CNT = FTM0->CNTIN;
+		ftmRestart();
+	}
+	for(channel = 0; channel < 8; channel++){
+		if(IS(address, FTM0->CONTROLS[channel].CnSC)){
+			/*CHF is cleared writing 0 after reading it*/
+			FTM0->CONTROLS[channel].CnSC = (FTM0->CONTROLS[channel].CnSC & ~FTM_CnSC_CHF_MASK) |
+					(OLD(FTM0->CONTROLS[channel].CnSC) & FTM0->CONTROLS[channel].CnSC & FTM_CnSC_CHF_MASK);
+		} else if(IS(address, FTM0->CONTROLS[channel].CnV) && !ftmRunning){
+			/*Without the counter, the duty is taken at once*/
+			ftmReload();
+		}
+	}
+	return TRUE;
+}
+
+/********************************************************************************************/
+/* Motor plant and FTM1 quadrature decoder                                                  */
+/********************************************************************************************/
+
+static double motorDuty(){
+	/*Mean level of the motor output, FTM0 channel 0*/
+	if(!ftmRunning || busClockStopped || !ftmPwmChannel(0)){
+		return 0;
+	}
+	return (ftmActiveDuty[0] >= ftmPeriodCounts())?(1.0):((double)ftmActiveDuty[0]/ftmPeriodCounts());
+}
+
+static int motorMoving(){
+	/*It moves until a speed of 0 is recorded*/
+	return motorRpm >= 0.5 || tracedMotorRpm != 0 || motorDuty() > 0;
+}
+
+static int encoderRunning(){
+	/*The decoder counts in the FTM mode, with a clock source selected*/
+	return !busClockStopped && (FTM1->SC & FTM_SC_CLKS_MASK) && (FTM1->MODE & FTM_MODE_FTMEN_MASK) &&
+			(FTM1->QDCTRL & FTM_QDCTRL_QUADEN_MASK);
+}
+
+static uint64 motorNextEvent(){
+	/*The speed is recorded at each multiple of HOSTSIM_MOTOR_TRACE_MS, while the motor moves*/
+	uint64 period = HOSTSIM_MS(HOSTSIM_MOTOR_TRACE_MS);
+	uint64 next = UINT64_MAX;
+	if(motorMoving()){
+		next = (now/period + 1)*period;
+	}
+	if(nextLoad < loadCount && loads[nextLoad].time < next){
+		next = loads[nextLoad].time;
+	}
+	return next;
+}
+
+static void motorAdvance(){
+	/*First order motor: the speed goes to the duty times HOSTSIM_MOTOR_RPM, minus the load, with the
+	 * time constant HOSTSIM_MOTOR_TAU_MS; The load only slows the motor down*/
+	double seconds = (double)(now - motorTime)/HOSTSIM_TIME_BASE;
+	double tau = HOSTSIM_MOTOR_TAU_MS/1000.0;
+	double target = motorDuty()*HOSTSIM_MOTOR_RPM - motorLoad*HOSTSIM_MOTOR_RPM/100.0;
+	double decay;
+	int64_t edges;
+	if(now <= motorTime){
+		return;
+	}
+	if(target < 0){
+		target = 0;
+	}
+	decay = exp(-seconds/tau);
+	motorEdges += (target*seconds + (motorRpm - target)*tau*(1 - decay))*HOSTSIM_ENCODER_LINES*4/60.0;
+	motorRpm = target + (motorRpm - target)*decay;
+	motorTime = now;
+
+	/*The whole edges are counted by the decoder, up or down, from CNTIN to MOD and around*/
+	edges = (int64_t)floor(motorEdges) - motorCountedEdges;
+	motorCountedEdges += edges;
+	if(edges && encoderRunning()){
+		int64_t range = (int64_t)(FTM1->MOD & 0xFFFF) - (FTM1->CNTIN & 0xFFFF) + 1;
+		int64_t count = ((int64_t)(FTM1->CNT & 0xFFFF) - (FTM1->CNTIN & 0xFFFF) + edges) % range;
+		FTM1->CNT = (uint32)(((count < 0)?(count + range):(count)) + (FTM1->CNTIN & 0xFFFF));
+		FTM1->QDCTRL = (edges > 0)?(FTM1->QDCTRL | FTM_QDCTRL_QUADIR_MASK):(FTM1->QDCTRL & ~FTM_QDCTRL_QUADIR_MASK);
+	}
+
+	/*Load changes of the scenario*/
+	while(nextLoad < loadCount && loads[nextLoad].time <= now){
+		motorLoad = loads[nextLoad++].percent;
+		if(traceFile){
+			fprintf(traceFile, "%llu MOTOR load %d\n", (unsigned long long)microseconds(now), motorLoad);
+		}
+	}
+	if(traceFile && now % HOSTSIM_MS(HOSTSIM_MOTOR_TRACE_MS) == 0 && (int)lround(motorRpm) != tracedMotorRpm){
+		tracedMotorRpm = (int)lround(motorRpm);
+		fprintf(traceFile, "%llu MOTOR rpm %d\n", (unsigned long long)microseconds(now), tracedMotorRpm);
+	}
+}
+
+static int encoderWritten(const uint8_t* address){
+	if(!IS(address, *FTM1)){
+		return FALSE;
+	}
+	if(IS(address, FTM1->CNT)){
+		/*A write to CNT loads CNTIN*/
+		FTM1->CNT = FTM1->CNTIN;
+	}
+	return TRUE;
+}
+
+/********************************************************************************************/
+/* LPTMR and SMC                                                                            */
+/********************************************************************************************/
+
+static uint64 lptmrCountTicks(){
+	/*Only the LPO is modeled as the prescaler clock*/
+	uint64 ticks = HOSTSIM_MS(1);
+	if(!(LPTMR0->PSR & LPTMR_PSR_PBYP_MASK)){
+		ticks <<= ((LPTMR0->PSR & LPTMR_PSR_PRESCALE_MASK) >> LPTMR_PSR_PRESCALE_SHIFT) + 1;
+	}
+	return ticks;
+}
+
+static uint64 lptmrPeriod(){
+	/*Free running counter, or reset after the compare*/
+	return (LPTMR0->CSR & LPTMR_CSR_TFC_MASK)?(LPTMR_COUNTS):((uint64)(LPTMR0->CMR & 0xFFFF) + 1);
+}
+
+static int lptmrWritten(const uint8_t* address){
+	if(!IS(address, *LPTMR0)){
+		return FALSE;
+	}
+	if(IS(address, LPTMR0->CSR)){
+		/*TCF is write 1 to clear*/
+		uint32 flag = OLD(LPTMR0->CSR) & LPTMR_CSR_TCF_MASK & ~LPTMR0->CSR;
+		LPTMR0->CSR = (LPTMR0->CSR & ~LPTMR_CSR_TCF_MASK) | flag;
+		if((LPTMR0->CSR & LPTMR_CSR_TEN_MASK) && !lptmrRunning){
+			lptmrRunning = TRUE;
+			lptmrOrigin = now;
+			lptmrNextCompare = now + ((uint64)(LPTMR0->CMR & 0xFFFF) + 1)*lptmrCountTicks();
+		} else if(!(LPTMR0->CSR & LPTMR_CSR_TEN_MASK)){
+			/*The counter and the flag are reset while the timer is disabled*/
+			lptmrRunning = FALSE;
+			LPTMR0->CSR &= ~LPTMR_CSR_TCF_MASK;
+			LPTMR0->CNR = 0;
+		}
+	} else if(IS(address, LPTMR0->CNR)){
+		/*A write latches the counter, so it can be read*/
+		LPTMR0->CNR = (lptmrRunning)?((uint32)(((now - lptmrOrigin)/lptmrCountTicks()) % lptmrPeriod())):(0);
+	}
+	return TRUE;
+}
+
+static void clocksCheck();
+
+static int runModeVlpr(){
+	return ((SMC->PMCTRL & SMC_PMCTRL_RUNM_MASK) >> SMC_PMCTRL_RUNM_SHIFT) == SMC_RUNM_VLPR;
+}
+
+static int smcWritten(const uint8_t* address){
+	if(!IS(address, *SMC)){
+		return FALSE;
+	}
+	if(IS(address, SMC->PMPROT)){
+		/*PMPROT can only be written once after the reset*/
+		static int written = FALSE;
+		if(written){
+			SMC->PMPROT = OLD(SMC->PMPROT);
+		}
+		written = TRUE;
+	} else if(IS(address, SMC->PMCTRL)){
+		/*The very low power modes can't be selected unless they are allowed*/
+		if(!(SMC->PMPROT & SMC_PMPROT_AVLP_MASK) &&
+				((SMC->PMCTRL & SMC_PMCTRL_STOPM_MASK) == SMC_STOPM_VLPS || (SMC->PMCTRL & SMC_PMCTRL_RUNM_MASK))){
+			SMC->PMCTRL = OLD(SMC->PMCTRL);
+		}
+		/*The run mode changes at once*/
+		if((SMC->PMCTRL ^ OLD(SMC->PMCTRL)) & SMC_PMCTRL_RUNM_MASK){
+			runModeTime[!runModeVlpr()] += now - runModeStart;
+			runModeStart = now;
+			SMC->PMSTAT = (runModeVlpr())?(PMSTAT_VLPR):(PMSTAT_RUN);
+			if(traceFile){
+				fprintf(traceFile, "%llu SMC PMSTAT 0x%02X\n", (unsigned long long)microseconds(now), (unsigned)SMC->PMSTAT);
+			}
+			clocksCheck();
+		}
+	} else if(IS(address, SMC->PMSTAT)){
+		SMC->PMSTAT = OLD(SMC->PMSTAT);
+	}
+	return TRUE;
+}
+
+/********************************************************************************************/
+/* MCG, OSC and clock dividers                                                              */
+/********************************************************************************************/
+
+static uint64 clockCount(uint32 clock){
+	/*Simulated time of a count of a clock; The modeled clocks divide the time base*/
+	if(HOSTSIM_TIME_BASE % clock){
+		fprintf(stderr, "hostsim: clock %u Hz isn't a divisor of the time base\n", (unsigned)clock);
+	}
+	return HOSTSIM_TIME_BASE/clock;
+}
+
+static void clockError(const char* message){
+	fprintf(stderr, "hostsim: %s (core %u bus %u flash %u Hz)\n", message, (unsigned)coreClock, (unsigned)busClock, (unsigned)flashClock);
+	HOSTSIM_finish(EXIT_FAILURE);
+}
+
+static uint64 rescaleCounts(uint64 next, uint64 oldCount){
+	/*The remaining counts of a timer are counted with the new bus clock*/
+	return now + ((next - now + oldCount - 1)/oldCount)*busCount;
+}
+
+static void clocksCheck(){
+	/*Limits of the run mode; In VLPR, the MCG must stay in BLPI or BLPE mode*/
+	if(coreClock > MAX_CORE_CLOCK || busClock > MAX_BUS_CLOCK || flashClock > MAX_FLASH_CLOCK){
+		clockError("clocks out of the limits of the K64");
+	}
+	if(runModeVlpr()){
+		if(coreClock > VLPR_MAX_CORE_CLOCK || busClock > VLPR_MAX_BUS_CLOCK || flashClock > VLPR_MAX_FLASH_CLOCK){
+			clockError("clocks out of the limits of VLPR");
+		}
+		if(!(MCG->C2 & MCG_C2_LP_MASK) || ((MCG->C1 & MCG_C1_CLKS_MASK) >> MCG_C1_CLKS_SHIFT) == CLKS_FLL_PLL){
+			clockError("VLPR without the MCG in BLPI or BLPE mode");
+		}
+	}
+}
+
+static void clocksUpdate(){
+	uint8 clockSource = (MCG->C1 & MCG_C1_CLKS_MASK) >> MCG_C1_CLKS_SHIFT;
+	int internalReference = (MCG->C1 & MCG_C1_IREFS_MASK) != 0;
+	int pllSelected = (MCG->C6 & MCG_C6_PLLS_MASK) != 0;
+	uint32 pllReference = EXTERNAL_CLOCK/((MCG->C5 & MCG_C5_PRDIV0_MASK) + 1);
+	uint32 pllOutput = pllReference*((MCG->C6 & MCG_C6_VDIV0_MASK) + PLL_VDIV_OFFSET);
+	int pllLocked = pllSelected && pllReference >= PLL_MIN_REFERENCE && pllReference <= PLL_MAX_REFERENCE &&
+			pllOutput >= PLL_MIN_OUTPUT && pllOutput <= PLL_MAX_OUTPUT;
+	uint32 divider1 = ((SIM->CLKDIV1 & SIM_CLKDIV1_OUTDIV1_MASK) >> SIM_CLKDIV1_OUTDIV1_SHIFT) + 1;
+	uint32 divider2 = ((SIM->CLKDIV1 & SIM_CLKDIV1_OUTDIV2_MASK) >> SIM_CLKDIV1_OUTDIV2_SHIFT) + 1;
+	uint32 divider4 = ((SIM->CLKDIV1 & SIM_CLKDIV1_OUTDIV4_MASK) >> SIM_CLKDIV1_OUTDIV4_SHIFT) + 1;
+	uint32 mcgOutput;
+	uint64 oldBusCount = busCount;
+	int channel;
+
+	/*The status follows the control bits at once; Only the EXTAL0 external clock is modeled*/
+	MCG->S = ((internalReference)?(MCG_S_IREFST_MASK):(0)) | ((MCG->C2 & MCG_C2_IRCS_MASK)?(MCG_S_IRCST_MASK):(0)) |
+			((pllSelected)?(MCG_S_PLLST_MASK):(0)) | ((pllLocked)?(MCG_S_LOCK0_MASK):(0)) |
+			(((clockSource == CLKS_FLL_PLL && pllSelected)?(CLKST_PLL):(clockSource)) << MCG_S_CLKST_SHIFT);
+	if(clockSource == CLKS_FLL_PLL && pllSelected){
+		if(!pllLocked){
+			clockError("PLL output selected without lock");
+		}
+		mcgOutput = pllOutput;
+	} else if(clockSource == CLKS_FLL_PLL){
+		if(!internalReference){
+			clockError("FLL with the external reference (FEE) isn't modeled");
+		}
+		mcgOutput = SLOW_IRC_CLOCK*FLL_FACTOR;
+	} else if(clockSource == CLKS_INTERNAL){
+		mcgOutput = (MCG->C2 & MCG_C2_IRCS_MASK)?(FAST_IRC_CLOCK >> ((MCG->SC & MCG_SC_FCRDIV_MASK) >> MCG_SC_FCRDIV_SHIFT)):(SLOW_IRC_CLOCK);
+	} else {
+		mcgOutput = EXTERNAL_CLOCK;
+	}
+	if(coreClock == mcgOutput/divider1 && busClock == mcgOutput/divider2 && flashClock == mcgOutput/divider4){
+		clocksCheck();
+		return;
+	}
+
+	/*The cycle counter counts until now with the previous core clock*/
+	HOSTSIM_dwt();
+	dwtRunning = FALSE;
+	coreClock = mcgOutput/divider1;
+	busClock = mcgOutput/divider2;
+	flashClock = mcgOutput/divider4;
+	coreCount = clockCount(coreClock);
+	busCount = clockCount(busClock);
+	if(divider2 % divider1 || divider4 % divider1){
+		clockError("bus or flash divider isn't a multiple of the core divider");
+	}
+	clocksCheck();
+	for(channel = 0; channel < 4; channel++){
+		if(pitRunning[channel]){
+			pitNextExpiry[channel] = rescaleCounts(pitNextExpiry[channel], oldBusCount);
+		}
+	}
+	if(pdbRunning){
+		pdbNextDacTrigger = rescaleCounts(pdbNextDacTrigger, oldBusCount);
+	}
+	if(ftmRunning){
+		/*The FTM counter is restarted by the firmware with a new modulo*/
+		ftmPeriodStart = now;
+	}
+	if(traceFile){
+		fprintf(traceFile, "%llu MCG core %u bus %u flash %u\n", (unsigned long long)microseconds(now),
+				(unsigned)coreClock, (unsigned)busClock, (unsigned)flashClock);
+	}
+}
+
+static int mcgWritten(const uint8_t* address){
+	if(IS(address, *MCG) || IS(address, *OSC) || IS(address, SIM->CLKDIV1)){
+		clocksUpdate();
+		return TRUE;
+	}
+	return FALSE;
+}
+
+/*Models the side effects of a write to 'address'; The registers are write enabled*/
+static void registerWritten(const uint8_t* address){
+	registerWrites++;
+	if(gpioWritten(address) || pitWritten(address) || dacWritten(address) || dmaWritten(address) || pdbWritten(address) ||
+			ftmWritten(address) || encoderWritten(address) || lptmrWritten(address) || smcWritten(address) || mcgWritten(address)){
+		return;
+	}
+	/*The other SIM registers and DMAMUX don't have side effects*/
+}
+
+/********************************************************************************************/
+/* Write trapping                                                                           */
+/********************************************************************************************/
+
+static void segvHandler(int signal, siginfo_t* info, void* context){
+	ucontext_t* userContext = (ucontext_t*)context;
+	uint8_t* address = (uint8_t*)info->si_addr;
+
+	if(address < peripheralBlock.page || address >= peripheralBlock.page + BLOCK_SIZE){
+		/*A real fault of the firmware; the default action is restored, and the fault happens again*/
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler = SIG_DFL;
+		sigaction(SIGSEGV, &action, NULL);
+		return;
+	}
+
+	/*The registers are saved, the write is enabled for a single instruction, and the host timer
+	 * can't interrupt that instruction*/
+	memcpy(snapshot, &P, sizeof(P));
+	trapAddress = address;
+	trapAlarmWasBlocked = sigismember(&userContext->uc_sigmask, SIGALRM);
+	sigaddset(&userContext->uc_sigmask, SIGALRM);
+	unlock();
+	userContext->uc_mcontext.gregs[REG_EFL] |= TRAP_FLAG;
+}
+
+static void trapHandler(int signal, siginfo_t* info, void* context){
+	ucontext_t* userContext = (ucontext_t*)context;
+
+	/*Until the time starts, each firmware instruction is counted; The handlers run with the trap
+	 * flag cleared, so they aren't*/
+	if(started){
+		userContext->uc_mcontext.gregs[REG_EFL] &= ~TRAP_FLAG;
+	} else {
+		bootInstructions++;
+	}
+	if(trapAddress == NULL){
+		return;
+	}
+	registerWritten((const uint8_t*)trapAddress);
+	trapAddress = NULL;
+	if(!inTick){
+		threadWrites++;
+	}
+	lock();
+	if(!trapAlarmWasBlocked){
+		sigdelset(&userContext->uc_sigmask, SIGALRM);
+	}
+}
+
+/********************************************************************************************/
+/* NVIC                                                                                     */
+/********************************************************************************************/
+
+static int irqAsserted(int irq){
+	if(irq >= PIT_CH0_IRQ_NUMBER && irq < PIT_CH0_IRQ_NUMBER + 4){
+		int channel = irq - PIT_CH0_IRQ_NUMBER;
+		return (PIT->CHANNEL[channel].TFLG & PIT_TFLG_TIF_MASK) && (PIT->CHANNEL[channel].TCTRL & PIT_TCTRL_TIE_MASK);
+	}
+	if(irq >= PORTA_IRQ_NUMBER && irq < PORTA_IRQ_NUMBER + 5){
+		return P.PORT[irq - PORTA_IRQ_NUMBER].ISFR != 0;
+	}
+	if(irq == DAC0_IRQ_NUMBER){
+		return (DAC0->SR & DAC0->C0 & (DAC_C0_DACBBIEN_MASK | DAC_C0_DACBTIEN_MASK | DAC_C0_DACBWIEN_MASK)) != 0;
+	}
+	if(irq == LPTMR0_IRQ_NUMBER){
+		return (LPTMR0->CSR & LPTMR_CSR_TCF_MASK) && (LPTMR0->CSR & LPTMR_CSR_TIE_MASK);
+	}
+	if(irq >= DMA_CH0_IRQ_NUMBER && irq < DMA_CH0_IRQ_NUMBER + 16){
+		return (DMA0->INT & (1u << (irq - DMA_CH0_IRQ_NUMBER))) != 0;
+	}
+	return FALSE;
+}
+
+static int irqMasked(int irq){
+	uint32 priority = (uint32)nvicPriority[irq] << (8 - __NVIC_PRIO_BITS);
+	if(basePri != 0 && priority >= basePri){
+		return TRUE;
+	}
+	/*No nesting: an interruption is attended after the current one returns*/
+	return currentIrq >= 0;
+}
+
+static int highestPendingIrq(){
+	int irq;
+	int best = -1;
+	for(irq = 0; irq < HOSTSIM_IRQ_COUNT; irq++){
+		if(nvicEnabled[irq] && irqHandler(irq) && irqAsserted(irq) && !irqMasked(irq)){
+			if(best < 0 || nvicPriority[irq] < nvicPriority[best]){
+				best = irq;
+			}
+		}
+	}
+	return best;
+}
+
+static uint64 hostNanoseconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return (uint64)time.tv_sec*1000000000ULL + time.tv_nsec;
+}
+
+DWT_Type* HOSTSIM_dwt(){
+	/*The host time isn't read until the time starts, so the instructions counted meanwhile don't
+	 * depend on the host clock*/
+	uint64 hostTime = (started)?(hostNanoseconds()):(0);
+	int running = (HOSTSIM_coreDebug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk);
+	/*Until the time starts, the cycle counter counts the firmware instructions, one per cycle;
+	 * Then it runs with the simulated time, plus the host time scaled to the core clock, so it
+	 * measures the firmware code too; It counts again from the value written by the firmware,
+	 * if any*/
+	if(running){
+		if(!dwtRunning || dwt.CYCCNT != dwtLastCount){
+			dwtOriginHostTime = hostTime;
+			dwtOriginTime = now;
+			dwtOriginCount = dwt.CYCCNT;
+			dwtOriginInstructions = bootInstructions;
+		}
+		if(started){
+			dwt.CYCCNT = dwtOriginCount + (uint32)((now - dwtOriginTime)/coreCount) +
+					(uint32)(((hostTime - dwtOriginHostTime)*coreClock)/1000000000ULL);
+		} else {
+			dwt.CYCCNT = dwtOriginCount + (uint32)(bootInstructions - dwtOriginInstructions);
+		}
+		dwtLastCount = dwt.CYCCNT;
+	}
+	dwtRunning = running;
+	return &dwt;
+}
+
+static void dispatchInterrupts(){
+	int attended;
+	for(attended = 0; attended < MAX_IRQS_PER_TICK; attended++){
+		int irq;
+		uint64 start;
+		uint64 elapsed;
+		uint64 writes;
+		if(primask){
+			return;
+		}
+		irq = highestPendingIrq();
+		if(irq < 0){
+			return;
+		}
+		/*Exception entry, handler, and exception return*/
+		currentIrq = irq;
+		writes = registerWrites;
+		start = hostNanoseconds();
+		irqHandler(irq)();
+		elapsed = hostNanoseconds() - start;
+		irqsInLastTick = TRUE;
+		mainLoopCpu = 0;
+		currentIrq = -1;
+		irqStats[irq].count++;
+		irqStats[irq].registerWrites += registerWrites - writes;
+		irqStats[irq].hostNanosecondsTotal += elapsed;
+		if(elapsed > irqStats[irq].hostNanosecondsMax){
+			irqStats[irq].hostNanosecondsMax = elapsed;
+		}
+	}
+	fprintf(stderr, "hostsim: an interruption flag is never cleared\n");
+	HOSTSIM_finish(EXIT_FAILURE);
+}
+
+void NVIC_EnableIRQ(IRQn_Type IRQn){
+	nvicEnabled[IRQn] = TRUE;
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn){
+	nvicEnabled[IRQn] = FALSE;
+}
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority){
+	nvicPriority[IRQn] = priority & ((1u << __NVIC_PRIO_BITS) - 1);
+}
+
+uint32_t NVIC_GetPriority(IRQn_Type IRQn){
+	return nvicPriority[IRQn];
+}
+
+void __set_BASEPRI(uint32_t value){
+	basePri = value & 0xFF;
+}
+
+uint32_t __get_BASEPRI(void){
+	return basePri;
+}
+
+void __disable_irq(void){
+	primask = TRUE;
+}
+
+void __enable_irq(void){
+	primask = FALSE;
+	if(started && !inTick){
+		/*The interruptions that became pending while PRIMASK was set are taken right now, as in
+		 * the core (for example, the one that ended a WFI)*/
+		sigset_t alarmMask;
+		sigset_t previousMask;
+		sigemptyset(&alarmMask);
+		sigaddset(&alarmMask, SIGALRM);
+		sigprocmask(SIG_BLOCK, &alarmMask, &previousMask);
+		inTick = TRUE;
+		dispatchInterrupts();
+		inTick = FALSE;
+		sigprocmask(SIG_SETMASK, &previousMask, NULL);
+	}
+	if(!started){
+		/*The simulated time starts with the first enabling of the interruptions*/
+		struct itimerval timer;
+		/*The cycle counter counts the host time from here*/
+		HOSTSIM_dwt();
+		dwtRunning = FALSE;
+		started = TRUE;
+		bootRegisterWrites = registerWrites;
+		timer.it_interval.tv_sec = 0;
+		timer.it_interval.tv_usec = TICK_PERIOD_US;
+		timer.it_value = timer.it_interval;
+		setitimer(ITIMER_REAL, &timer, NULL);
+	}
+}
+
+/********************************************************************************************/
+/* Simulated time                                                                           */
+/********************************************************************************************/
+
+static int compareEvents(const void* first, const void* second){
+	const HOSTSIM_EventType* a = (const HOSTSIM_EventType*)first;
+	const HOSTSIM_EventType* b = (const HOSTSIM_EventType*)second;
+	return (a->time > b->time) - (a->time < b->time);
+}
+
+static void advanceTime(){
+	uint64 next = endTime;
+	int channel;
+	int port;
+	int pin;
+
+	if(!eventsSorted){
+		qsort(events + nextEvent, eventCount - nextEvent, sizeof(HOSTSIM_EventType), compareEvents);
+		eventsSorted = TRUE;
+	}
+
+	/*Next event of any source; The PIT and the PDB don't count while the bus clock is stopped*/
+	for(channel = 0; channel < 4; channel++){
+		if(pitRunning[channel] && !busClockStopped && pitNextExpiry[channel] < next){
+			next = pitNextExpiry[channel];
+		}
+	}
+	if(pdbRunning && !busClockStopped && pdbNextDacTrigger < next){
+		next = pdbNextDacTrigger;
+	}
+	if(ftmNextEvent() < next){
+		next = ftmNextEvent();
+	}
+	if(motorNextEvent() < next){
+		next = motorNextEvent();
+	}
+	if(lptmrRunning && lptmrNextCompare < next){
+		next = lptmrNextCompare;
+	}
+	if(nextEvent < eventCount && events[nextEvent].time < next){
+		next = events[nextEvent].time;
+	}
+	for(port = 0; port < 5; port++){
+		for(pin = 0; pin < 32; pin++){
+			if(filterDeadline[port][pin] && filterDeadline[port][pin] < next){
+				next = filterDeadline[port][pin];
+			}
+		}
+	}
+	if(next > now){
+		now = next;
+	}
+
+	/*The motor moves until now with the duty of the last period, and the decoder counts its edges
+	 * before the timers expire*/
+	motorAdvance();
+
+	/*PIT expiries; the counter is loaded again with LDVAL*/
+	for(channel = 0; channel < 4 && !busClockStopped; channel++){
+		if(pitRunning[channel] && pitNextExpiry[channel] <= now){
+			PIT->CHANNEL[channel].TFLG |= PIT_TFLG_TIF_MASK;
+			pitNextExpiry[channel] = now + ((uint64)PIT->CHANNEL[channel].LDVAL + 1)*busCount;
+			/*Periodic trigger of the DMA channel with the same number*/
+			if(channel < DMA_PERIODIC_CHANNELS &&
+					(DMAMUX->CHCFG[channel] & (DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_TRIG_MASK)) == (DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_TRIG_MASK) &&
+					(DMA0->ERQ & (1u << channel))){
+				dmaMinorLoop(channel);
+			}
+		}
+		if(pitRunning[channel]){
+			PIT->CHANNEL[channel].CVAL = (uint32)((pitNextExpiry[channel] - now + busCount - 1)/busCount - 1);
+		}
+	}
+
+	/*PDB DAC interval triggers, to the DACs that use the hardware trigger; Both are modeled with the
+	 * interval of the DAC0 trigger*/
+	if(pdbRunning && !busClockStopped && pdbNextDacTrigger <= now){
+		int instance;
+		for(instance = 0; instance < 2; instance++){
+			if((PDB0->DAC[instance].INTC & PDB_INTC_TOE_MASK) && !(dacs[instance]->C0 & DAC_C0_DACTRGSEL_MASK)){
+				dacTrigger(instance);
+			}
+		}
+		pdbUpdateNextTrigger();
+	}
+
+	/*FTM0 reload points and matches*/
+	ftmAdvance();
+
+	/*LPTMR compare, clocked by the LPO*/
+	if(lptmrRunning && lptmrNextCompare <= now){
+		LPTMR0->CSR |= LPTMR_CSR_TCF_MASK;
+		lptmrNextCompare += lptmrPeriod()*lptmrCountTicks();
+	}
+
+	/*Scenario events*/
+	while(nextEvent < eventCount && events[nextEvent].time <= now){
+		HOSTSIM_EventType* event = &events[nextEvent++];
+		if(event->level == HOSTSIM_RELEASE){
+			drivenMask[event->port] &= ~(1u << event->pin);
+		} else {
+			drivenMask[event->port] |= (1u << event->pin);
+			if(event->level){
+				drivenLevel[event->port] |= (1u << event->pin);
+			} else {
+				drivenLevel[event->port] &= ~(1u << event->pin);
+			}
+		}
+		gpioUpdate(event->port);
+	}
+
+	/*Digital filter windows that are over*/
+	for(port = 0; port < 5; port++){
+		for(pin = 0; pin < 32; pin++){
+			if(filterDeadline[port][pin] && filterDeadline[port][pin] <= now){
+				gpioUpdate(port);
+				break;
+			}
+		}
+	}
+}
+
+static uint64 threadCpuNanoseconds(){
+	struct timespec time;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+	return (uint64)time.tv_sec*1000000000ULL + (uint64)time.tv_nsec;
+}
+
+static void tickHandler(int signal){
+	if(!started){
+		return;
+	}
+	/*The main loop runs in the same host thread, between the ticks*/
+	mainLoopCpu += threadCpuNanoseconds() - tickEndCpu;
+	if(threadWrites != tickThreadWrites){
+		mainLoopCpu = 0;
+	}
+	/*The main loop code doesn't consume simulated time, but the host needs time to run it; After
+	 * an interruption (that may have left work to the main loop), and while the main loop is
+	 * writing registers, the time doesn't advance until the main loop has run MAIN_LOOP_NS; Nor
+	 * while it has the interruptions disabled, or from a wake up until the next WFI*/
+	if((threadWrites != tickThreadWrites || irqsInLastTick || mainLoopCpu < MAIN_LOOP_NS || primask || coreAwake) && heldTicks < MAX_HELD_TICKS){
+		irqsInLastTick = FALSE;
+		tickThreadWrites = threadWrites;
+		heldTicks++;
+		tickEndCpu = threadCpuNanoseconds();
+		return;
+	}
+	heldTicks = 0;
+	inTick = TRUE;
+	unlock();
+	advanceTime();
+	lock();
+	dispatchInterrupts();
+	inTick = FALSE;
+	if(now >= endTime){
+		HOSTSIM_finish(EXIT_SUCCESS);
+	}
+	tickEndCpu = threadCpuNanoseconds();
+}
+
+/********************************************************************************************/
+/* Sleep                                                                                    */
+/********************************************************************************************/
+
+void __DSB(void){
+}
+
+void __WFI(void){
+	sigset_t alarmMask;
+	sigset_t previousMask;
+	uint64 start = now;
+	int deep = (HOSTSIM_scb.SCR & SCB_SCR_SLEEPDEEP_Msk) != 0;
+	int channel;
+
+	if(!started){
+		return;
+	}
+	coreAwake = FALSE;
+	/*The host timer doesn't run while the core sleeps; The time advances here*/
+	sigemptyset(&alarmMask);
+	sigaddset(&alarmMask, SIGALRM);
+	sigprocmask(SIG_BLOCK, &alarmMask, &previousMask);
+
+	/*The cycle counter stops with the core*/
+	HOSTSIM_dwt();
+	/*The stop modes (VLPS, or STOP if VLPS isn't selected) stop the bus clock*/
+	unlock();
+	if(deep){
+		busClockStopped = TRUE;
+		SMC->PMSTAT = ((SMC->PMCTRL & SMC_PMCTRL_STOPM_MASK) == SMC_STOPM_VLPS)?(PMSTAT_VLPS):(PMSTAT_STOP);
+		if(traceFile){
+			fprintf(traceFile, "%llu SMC PMSTAT 0x%02X\n", (unsigned long long)microseconds(now), (unsigned)SMC->PMSTAT);
+		}
+	}
+
+	/*Any interruption that isn't masked by BASEPRI wakes up the core, even with PRIMASK set*/
+	sleepMode = deep;
+	sleepStart = start;
+	while(highestPendingIrq() < 0){
+		inTick = TRUE;
+		advanceTime();
+		inTick = FALSE;
+		if(now >= endTime){
+			HOSTSIM_finish(EXIT_SUCCESS);
+		}
+	}
+
+	if(deep){
+		/*The PIT and the PDB continue counting from where they stopped*/
+		for(channel = 0; channel < 4; channel++){
+			pitNextExpiry[channel] += now - start;
+		}
+		pdbNextDacTrigger += now - start;
+		ftmPeriodStart += now - start;
+		busClockStopped = FALSE;
+		SMC->PMSTAT = (runModeVlpr())?(PMSTAT_VLPR):(PMSTAT_RUN);
+		if(traceFile){
+			fprintf(traceFile, "%llu SMC PMSTAT 0x%02X\n", (unsigned long long)microseconds(now), (unsigned)SMC->PMSTAT);
+		}
+		/*The MCG leaves the stop modes in PBE mode if it entered them in PEE mode*/
+		if(((MCG->C1 & MCG_C1_CLKS_MASK) >> MCG_C1_CLKS_SHIFT) == CLKS_FLL_PLL && (MCG->C6 & MCG_C6_PLLS_MASK)){
+			MCG->C1 = (MCG->C1 & ~MCG_C1_CLKS_MASK) | MCG_C1_CLKS(CLKS_EXTERNAL);
+			clocksUpdate();
+		}
+	}
+	lock();
+	sleepMode = -1;
+	sleepEntries[deep]++;
+	sleepTime[deep] += now - start;
+	dwtRunning = FALSE;
+	coreAwake = TRUE;
+	tickEndCpu = threadCpuNanoseconds();
+	sigprocmask(SIG_SETMASK, &previousMask, NULL);
+}
+
+/********************************************************************************************/
+/* API                                                                                      */
+/********************************************************************************************/
+
+void HOSTSIM_init(FILE* trace){
+	struct sigaction action;
+	int port;
+
+	traceFile = trace;
+
+	/*Reset values*/
+	memset(&P, 0, sizeof(P));
+	PIT->MCR = PIT_MCR_MDIS_MASK;
+	SMC->PMSTAT = PMSTAT_RUN;
+	/*FEI mode: FLL with the slow internal reference; Flash clock divided by 2*/
+	MCG->C1 = MCG_C1_IREFS_MASK;
+	MCG->S = MCG_S_IREFST_MASK;
+	MCG->SC = MCG_SC_FCRDIV(1);
+	SIM->CLKDIV1 = SIM_CLKDIV1_OUTDIV4(1);
+	for(port = 0; port < 5; port++){
+		gpioUpdate(port);
+	}
+
+	/*Write trapping, and host timer; The host timer can't interrupt a trapped write*/
+	memset(&action, 0, sizeof(action));
+	sigemptyset(&action.sa_mask);
+	sigaddset(&action.sa_mask, SIGALRM);
+	action.sa_flags = SA_SIGINFO | SA_NODEFER;
+	action.sa_sigaction = segvHandler;
+	sigaction(SIGSEGV, &action, NULL);
+	action.sa_sigaction = trapHandler;
+	sigaction(SIGTRAP, &action, NULL);
+	memset(&action, 0, sizeof(action));
+	action.sa_handler = tickHandler;
+	sigaction(SIGALRM, &action, NULL);
+
+	mprotect(&peripheralBlock, BLOCK_SIZE, PROT_READ);
+
+	/*The firmware is single stepped until the time starts, to count its instructions*/
+	__asm__ volatile("pushfq\n\torq %0, (%%rsp)\n\tpopfq" : : "i"(TRAP_FLAG) : "cc", "memory");
+}
+
+void HOSTSIM_schedulePin(uint64 time, HOSTSIM_PortType port, uint8 pin, uint8 level){
+	if(eventCount >= MAX_EVENTS){
+		fprintf(stderr, "hostsim: too many scenario events\n");
+		return;
+	}
+	events[eventCount].time = time;
+	events[eventCount].port = port;
+	events[eventCount].pin = pin;
+	events[eventCount].level = level;
+	eventCount++;
+	eventsSorted = FALSE;
+}
+
+void HOSTSIM_scheduleKey(uint64 time, uint8 code){
+	/*Data bits, as read by KYBRD.c: PTB2 is bit 3, PTB3 bit 2, PTB10 bit 1, PTB11 bit 0*/
+	HOSTSIM_schedulePin(time, HOSTSIM_PORTB, 2, (code >> 3) & 1);
+	HOSTSIM_schedulePin(time, HOSTSIM_PORTB, 3, (code >> 2) & 1);
+	HOSTSIM_schedulePin(time, HOSTSIM_PORTB, 10, (code >> 1) & 1);
+	HOSTSIM_schedulePin(time, HOSTSIM_PORTB, 11, code & 1);
+	/*Data available pulse, after the data is stable*/
+	HOSTSIM_schedulePin(time + 1, HOSTSIM_PORTB, 20, 1);
+	HOSTSIM_schedulePin(time + HOSTSIM_MS(HOSTSIM_KEY_MS), HOSTSIM_PORTB, 20, 0);
+}
+
+void HOSTSIM_scheduleLoad(uint64 time, uint8 percent){
+	uint32 index;
+	if(loadCount >= MAX_LOADS){
+		fprintf(stderr, "hostsim: too many scenario loads\n");
+		return;
+	}
+	/*The loads are kept sorted by time*/
+	for(index = loadCount; index > nextLoad && loads[index - 1].time > time; index--){
+		loads[index] = loads[index - 1];
+	}
+	loads[index].time = time;
+	loads[index].percent = percent;
+	loadCount++;
+}
+
+void HOSTSIM_setEndTime(uint64 time){
+	endTime = time;
+}
+
+uint64 HOSTSIM_now(){
+	return now;
+}
+
+BooleanType HOSTSIM_loadScenario(const char* path){
+	FILE* file = fopen(path, "r");
+	char line[256];
+	if(file == NULL){
+		return FALSE;
+	}
+	while(fgets(line, sizeof(line), file)){
+		char command[16];
+		char port;
+		char levelText[16];
+		double milliseconds;
+		unsigned pin;
+		unsigned code;
+		if(line[0] == '#' || sscanf(line, "%15s", command) != 1){
+			continue;
+		}
+		if(!strcmp(command, "end") && sscanf(line, "%*s %lf", &milliseconds) == 1){
+			HOSTSIM_setEndTime(HOSTSIM_MS(milliseconds));
+		} else if(!strcmp(command, "pin") && sscanf(line, "%*s %lf %c %u %15s", &milliseconds, &port, &pin, levelText) == 4){
+			HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds), port - 'A', pin,
+					(!strcmp(levelText, "release"))?(HOSTSIM_RELEASE):(atoi(levelText) != 0));
+		} else if(!strcmp(command, "press") && sscanf(line, "%*s %lf %c %u", &milliseconds, &port, &pin) == 3){
+			HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds), port - 'A', pin, 0);
+			HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds + HOSTSIM_PRESS_MS), port - 'A', pin, HOSTSIM_RELEASE);
+		} else if(!strcmp(command, "bounce") && sscanf(line, "%*s %lf %c %u", &milliseconds, &port, &pin) == 3){
+			/*Press and release, each one with HOSTSIM_BOUNCES short pulses*/
+			int bounce;
+			for(bounce = 0; bounce < HOSTSIM_BOUNCES; bounce++){
+				HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds + bounce*HOSTSIM_BOUNCE_MS), port - 'A', pin, 0);
+				HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds + (bounce + 0.5)*HOSTSIM_BOUNCE_MS), port - 'A', pin, HOSTSIM_RELEASE);
+				HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds + HOSTSIM_PRESS_MS + bounce*HOSTSIM_BOUNCE_MS), port - 'A', pin, HOSTSIM_RELEASE);
+				HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds + HOSTSIM_PRESS_MS + (bounce + 0.5)*HOSTSIM_BOUNCE_MS), port - 'A', pin, 0);
+			}
+			HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds + HOSTSIM_BOUNCES*HOSTSIM_BOUNCE_MS), port - 'A', pin, 0);
+			HOSTSIM_schedulePin(HOSTSIM_MS(milliseconds + HOSTSIM_PRESS_MS + HOSTSIM_BOUNCES*HOSTSIM_BOUNCE_MS), port - 'A', pin, HOSTSIM_RELEASE);
+		} else if(!strcmp(command, "key") && sscanf(line, "%*s %lf %x", &milliseconds, &code) == 2){
+			HOSTSIM_scheduleKey(HOSTSIM_MS(milliseconds), code);
+		} else if(!strcmp(command, "load") && sscanf(line, "%*s %lf %u", &milliseconds, &code) == 2){
+			HOSTSIM_scheduleLoad(HOSTSIM_MS(milliseconds), code);
+		} else {
+			fprintf(stderr, "hostsim: unknown scenario line: %s", line);
+		}
+	}
+	fclose(file);
+	return TRUE;
+}
+
+void HOSTSIM_finish(int status){
+	int irq;
+	struct itimerval timer;
+
+	/*Stops the host timer*/
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_REAL, &timer, NULL);
+
+	if(traceFile){
+		fprintf(traceFile, "# end %llu us register_writes %llu\n", (unsigned long long)microseconds(now), (unsigned long long)registerWrites);
+		fprintf(traceFile, "# boot register_writes %llu host_instructions %llu boot_ns %u\n", (unsigned long long)bootRegisterWrites,
+				(unsigned long long)bootInstructions, (unsigned)BOARDCONFIG_bootNanoseconds());
+		runModeTime[runModeVlpr()] += now - runModeStart;
+		fprintf(traceFile, "# run us %llu vlpr us %llu\n", (unsigned long long)microseconds(runModeTime[0]),
+				(unsigned long long)microseconds(runModeTime[1]));
+		if(sleepMode >= 0){
+			sleepEntries[sleepMode]++;
+			sleepTime[sleepMode] += now - sleepStart;
+		}
+		fprintf(traceFile, "# sleep wait entries %u us %llu stop entries %u us %llu\n",
+				(unsigned)sleepEntries[0], (unsigned long long)microseconds(sleepTime[0]),
+				(unsigned)sleepEntries[1], (unsigned long long)microseconds(sleepTime[1]));
+		for(irq = 0; irq < HOSTSIM_IRQ_COUNT; irq++){
+			if(irqStats[irq].count){
+				fprintf(traceFile, "# irq %d count %u register_writes %llu host_ns_mean %llu host_ns_max %llu\n",
+						irq, (unsigned)irqStats[irq].count, (unsigned long long)irqStats[irq].registerWrites,
+						(unsigned long long)(irqStats[irq].hostNanosecondsTotal/irqStats[irq].count),
+						(unsigned long long)irqStats[irq].hostNanosecondsMax);
+			}
+		}
+#ifdef PROFILER_ENABLE
+		/*Memory map, profiled handlers and benchmarks of the firmware; The handlers are measured with the host time
+		 * scaled to the core clock (host_cycles), so they are only comparable between runs on the same host; The period
+		 * of the PIT handlers is counted by the PIT, in the simulated time. The benchmarks (run in the initialization)
+		 * are measured with the host instructions*/
+		{
+			static const char* const regionNames[] = {"FLASH", "SRAM_L", "SRAM_U", "OTHER"};
+			int entry;
+			int benchmark;
+			int handler;
+			for(entry = 0; entry < PROFILER_memoryMapCount; entry++){
+				const char* address = (const char*)PROFILER_memoryMap[entry].address;
+				fprintf(traceFile, "# map %s region %s host_section %s host_address %p\n", PROFILER_memoryMap[entry].name,
+						regionNames[PROFILER_memoryMap[entry].region],
+						((address >= __start_ramfunc_code && address < __stop_ramfunc_code) ||
+						(address >= __start_ramfunc_tables && address < __stop_ramfunc_tables))?("ramfunc"):("default"),
+						(const void*)address);
+			}
+			for(handler = 0; handler < PROFILER_HANDLERS; handler++){
+				if(!PROFILER_stats[handler].count){
+					continue;
+				}
+				fprintf(traceFile, "# profile handler %d count %u host_cycles_min %u host_cycles_max %u host_cycles_mean %u", handler,
+						(unsigned)PROFILER_stats[handler].count, (unsigned)PROFILER_stats[handler].minimum,
+						(unsigned)PROFILER_stats[handler].maximum, (unsigned)PROFILER_mean((PROFILER_HandlerType)handler));
+				if(PROFILER_stats[handler].maximumPeriod){
+					fprintf(traceFile, " period_min %u period_max %u jitter %u", (unsigned)PROFILER_stats[handler].minimumPeriod,
+							(unsigned)PROFILER_stats[handler].maximumPeriod,
+							(unsigned)(PROFILER_stats[handler].maximumPeriod - PROFILER_stats[handler].minimumPeriod));
+				}
+				fprintf(traceFile, "\n");
+			}
+			for(benchmark = 0; benchmark < PROFILER_benchmarkCount; benchmark++){
+				fprintf(traceFile, "# benchmark %s items %u host_instructions %u host_instructions_per_item %.2f\n", PROFILER_benchmarks[benchmark].name,
+						(unsigned)PROFILER_benchmarks[benchmark].items, (unsigned)PROFILER_benchmarks[benchmark].cycles,
+						(double)PROFILER_benchmarks[benchmark].cycles/PROFILER_benchmarks[benchmark].items);
+			}
+			if(PROFILER_benchmarkDrops){
+				fprintf(traceFile, "# benchmarks dropped %u\n", (unsigned)PROFILER_benchmarkDrops);
+			}
+		}
+#endif
+		fflush(traceFile);
+	}
+	_exit(status);
+}
@@ -0,0 +1,207 @@
+/**
+	\file
+	\brief
+		This is the header file for the host (Linux) simulator of the K64 peripherals used
+		by this project (SIM, PORT, GPIO, PIT, DAC0, DAC1, eDMA, DMAMUX, PDB0, FTM0, FTM1, LPTMR0,
+		SMC, MCG and the NVIC), and the motor with its encoder. The
+		firmware sources are compiled without changes against HostSim/MK64F12.h, and its
+		register writes are trapped and modeled by HostSim.c. Pin events are injected from a
+		scenario, and GPIO outputs, DAC outputs and interruption statistics are recorded in a
+		trace.
+
+		Build (x86-64 Linux; -no-pie keeps the firmware arrays at 32 bits addresses, as the
+		DMA registers are 32 bits), with all the .c files of the project directory and of HostSim
+		as sources:
+			gcc -std=gnu99 -O1 -fno-pie -no-pie -IHostSim -I. -Dmain=FIRMWARE_main <sources> -lm -o hostsim
+		Run:
+			./hostsim HostSim/scenarios/wavegen_password.txt [trace.txt]
+		A scenario that needs build options (the modes selected at build time) gives them in a
+		"# build:" line. HostSim/run_scenarios.sh builds and runs each scenario, and compares
+		its trace with the expected one, the .trace file next to it.
+		The host tools in HostSim/tools (the motor program assembler) are built on their own,
+		as written in each file.
+
+		Time model: the simulated time is counted in units of 1/HOSTSIM_TIME_BASE s, so a count
+		of any modeled clock is a whole number of units, and it jumps from one peripheral event
+		(PIT expiry, PDB trigger, scenario pin event) to the next one, each host timer tick. The
+		firmware code doesn't consume simulated time; to give the main loop host time to run,
+		the time doesn't advance after an interruption, nor after a register write of the main
+		loop, until the main loop has run for a while (host CPU time); Nor while the main loop
+		has the interruptions disabled, or runs after a wake up from WFI. The time doesn't start
+		until the firmware enables the interruptions for the first time; Until then (the
+		initialization), the firmware is single stepped, and the cycle counter counts its host
+		instructions, one per cycle, so the boot time (BOARDCONFIG_bootNanoseconds, the cycles
+		of each clock converted with that clock) doesn't depend on the host load. The register
+		writes and the host instructions of the initialization, and the boot time, are reported
+		in the trace.
+		WFI doesn't return until an interruption is pending, and the time advances meanwhile;
+		With SLEEPDEEP, the bus clock stops, so the PIT and the PDB don't count, and the
+		PMSTAT changes are recorded in the trace. The cycle counter doesn't count while the core
+		sleeps.
+		Clocks: the MCG modes FEI, FBE, PBE, PEE and BLPI are modeled, with the 50MHz external
+		clock of the FRDM-K64F in EXTAL0; Its status bits follow the control bits at once (the
+		PLL locks without delay). The PIT and the PDB count with the bus clock, and the cycle
+		counter with the core clock, given by the MCG output and SIM_CLKDIV1; Each change is
+		recorded in the trace, and a clock above the limits of the K64 ends the simulation. The
+		VLPR run mode is modeled with its limits (4MHz core and bus, BLPI or BLPE), and the
+		time spent in RUN and VLPR is reported at the end of the trace.
+		DAC: the output is recorded in the trace when it changes. In the buffer mode, the PDB
+		(or a software trigger) moves the read pointer, and the top, bottom and watermark flags
+		with their interruption enabled are recorded too, as each one asks for a refill.
+		FTM0: only the edge aligned PWM of the TPM compatible mode is modeled, counted with the
+		bus clock. A duty (CnV) is taken at the reload point, at the end of the period, and its
+		change is recorded in the trace (duty and period in counts). The matches only request
+		the DMA (a minor loop of the DMA channel routed to the FTM0 channel); The FTM
+		interruptions aren't modeled. While nothing changes, the periods aren't simulated.
+		eDMA: a minor loop is done at once, with its writes to registers modeled as firmware
+		writes. At the end of a major loop, a channel with ESG loads the next descriptor from
+		the memory given by DLAST_SGA (scatter gather); Channel linking isn't modeled.
+		Motor: a first order plant driven by the mean level of the FTM0 channel 0: its speed
+		goes to the duty times HOSTSIM_MOTOR_RPM, minus the load of the scenario, with the time
+		constant HOSTSIM_MOTOR_TAU_MS. Its encoder (HOSTSIM_ENCODER_LINES) is counted by the
+		FTM1 quadrature decoder, the only FTM1 mode modeled. The speed is recorded in the trace
+		each HOSTSIM_MOTOR_TRACE_MS, when it changes.
+		Profiler (built with -DPROFILER_ENABLE): the trace ends with the memory map, the
+		profiled handlers and the benchmarks (and the number of results that didn't fit in
+		PROFILER_BENCHMARKS, if any). The map gives the region of each entry and the host
+		section where it landed: "ramfunc" for the ones that the ARM build places in SRAM_L. The
+		fields with the host_ prefix depend on the host; The handler durations are host time
+		scaled to the core clock, and the benchmarks (run in the initialization) are host
+		instruction counts, that only change with the code or the compiler. The period of the
+		PIT handlers is counted by the PIT, in the simulated time; As the firmware code doesn't
+		consume simulated time and the flash wait states aren't modeled, its jitter is only
+		caused by interruptions masked or taken late, and the effect of the SRAM placement must
+		be measured on target.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef HOSTSIM_HOSTSIM_H_
+#define HOSTSIM_HOSTSIM_H_
+
+#include <stdio.h>
+#include "DataTypeDefinitions.h"
+
+/*Units of simulated time in a second: the least common multiple of the modeled clocks (FLL
+ * 20.97MHz, external clock 50MHz, PLL 120MHz, internal references, and their divisions)*/
+#define HOSTSIM_TIME_BASE 4915200000000ULL
+/*Core and bus clock after the reset, FEI mode: the FLL, 640 times the 32.768kHz internal
+ * reference (Hz)*/
+#define HOSTSIM_RESET_CLOCK 20971520
+/*Conversion from ms to simulated time*/
+#define HOSTSIM_MS(milliseconds) ((uint64)((milliseconds)*(HOSTSIM_TIME_BASE/1000.0)))
+/*Level used to release a pin; The pin takes the level of its pull resistor*/
+#define HOSTSIM_RELEASE 2
+/*Duration of a switch press in a scenario*/
+#define HOSTSIM_PRESS_MS 50
+/*Bounces of a switch in a scenario, at the press and at the release, and their period*/
+#define HOSTSIM_BOUNCES 4
+#define HOSTSIM_BOUNCE_MS 1
+/*Duration of the data available pulse of the MM74C922 in a scenario*/
+#define HOSTSIM_KEY_MS 20
+/*Motor: speed at 100% of duty without load (RPM), time constant (ms), lines of the encoder, and
+ * period of the speed in the trace (ms)*/
+#define HOSTSIM_MOTOR_RPM 3300
+#define HOSTSIM_MOTOR_TAU_MS 60
+#define HOSTSIM_ENCODER_LINES 500
+#define HOSTSIM_MOTOR_TRACE_MS 20
+/*Number of interruptions in the simulated NVIC*/
+#define HOSTSIM_IRQ_COUNT 86
+
+/*! These constants are used to select a port in the simulator API*/
+typedef enum {HOSTSIM_PORTA, HOSTSIM_PORTB, HOSTSIM_PORTC, HOSTSIM_PORTD, HOSTSIM_PORTE} HOSTSIM_PortType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function initializes the simulated peripherals with their reset values, and
+ 	 	 write protects them, so the firmware writes are modeled.
+ 	 \param[in] trace File where the outputs are recorded
+ 	 \return void
+ */
+void HOSTSIM_init(FILE* trace);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function schedules a level change of an input pin.
+ 	 \param[in] time Simulated time of the change (1/HOSTSIM_TIME_BASE s)
+ 	 \param[in] port Port of the pin
+ 	 \param[in] pin Pin number
+ 	 \param[in] level 0, 1 or HOSTSIM_RELEASE
+ 	 \return void
+ */
+void HOSTSIM_schedulePin(uint64 time, HOSTSIM_PortType port, uint8 pin, uint8 level);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function schedules a key press in the MM74C922 keyboard encoder (data in
+ 	 	 PTB2, PTB3, PTB10, PTB11, and data available pulse in PTB20)
+ 	 \param[in] time Simulated time of the press (1/HOSTSIM_TIME_BASE s)
+ 	 \param[in] code 4 bits code of the key (see KYBRD.h)
+ 	 \return void
+ */
+void HOSTSIM_scheduleKey(uint64 time, uint8 code);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function schedules a change of the load of the motor
+ 	 \param[in] time Simulated time of the change (1/HOSTSIM_TIME_BASE s)
+ 	 \param[in] percent Load, as the speed it takes off, in percent of HOSTSIM_MOTOR_RPM
+ 	 \return void
+ */
+void HOSTSIM_scheduleLoad(uint64 time, uint8 percent);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function sets the simulated time when the simulation ends
+ 	 \param[in] time Simulated time (1/HOSTSIM_TIME_BASE s)
+ 	 \return void
+ */
+void HOSTSIM_setEndTime(uint64 time);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function reads a scenario file. Each line is one of:
+ 	 	 	 end <ms>
+ 	 	 	 pin <ms> <A-E> <pin> <0|1|release>
+ 	 	 	 press <ms> <A-E> <pin>		(low during HOSTSIM_PRESS_MS)
+ 	 	 	 key <ms> <hex code>
+ 	 	 	 load <ms> <percent>	(load of the motor)
+ 	 	 Empty lines and lines that start with '#' are ignored.
+ 	 \param[in] path Scenario file
+ 	 \return TRUE if the file was read
+ */
+BooleanType HOSTSIM_loadScenario(const char* path);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the simulated time
+ 	 \return Simulated time (1/HOSTSIM_TIME_BASE s)
+ */
+uint64 HOSTSIM_now();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function ends the simulation: it records the interruption statistics in the
+ 	 	 trace, and exits the process
+ 	 \param[in] status Exit status of the process
+ 	 \return void
+ */
+void HOSTSIM_finish(int status);
+
+#endif /* HOSTSIM_HOSTSIM_H_ */
@@ -0,0 +1,43 @@
+/**
+	\file
+	\brief
+		This is the entry point of the host simulator. It reads the scenario, prepares the
+		simulated peripherals and runs the firmware main (renamed FIRMWARE_main when it is
+		compiled for the host).
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "HostSim.h"
+
+/*The firmware main is renamed with -Dmain=FIRMWARE_main*/
+#undef main
+int FIRMWARE_main(void);
+
+int main(int argc, char* argv[]){
+	FILE* trace = stdout;
+
+	if(argc < 2){
+		fprintf(stderr, "usage: %s <scenario> [trace]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	if(!HOSTSIM_loadScenario(argv[1])){
+		fprintf(stderr, "hostsim: can't read %s\n", argv[1]);
+		return EXIT_FAILURE;
+	}
+	if(argc > 2){
+		trace = fopen(argv[2], "w");
+		if(trace == NULL){
+			fprintf(stderr, "hostsim: can't write %s\n", argv[2]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	HOSTSIM_init(trace);
+	/*The firmware never returns; The simulation ends with HOSTSIM_finish at the end time*/
+	FIRMWARE_main();
+	HOSTSIM_finish(EXIT_SUCCESS);
+	return EXIT_SUCCESS;
+}
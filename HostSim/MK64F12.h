@@ -0,0 +1,631 @@
+/**
+	\file
+	\brief
+		This is the host (Linux) replacement of the MK64F12.h device header. It declares
+		the registers used by the firmware with the same names as the NXP header, but all
+		of them live in a single simulated block (HOSTSIM_peripherals) that is modeled by
+		HostSim.c. Only the registers used by this project are declared; the layout inside
+		each peripheral is kept as in the K64, but the peripherals aren't at their real
+		addresses.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef HOSTSIM_MK64F12_H_
+#define HOSTSIM_MK64F12_H_
+
+#include <stdint.h>
+
+/*Priority bits implemented in the NVIC of the K64*/
+#define __NVIC_PRIO_BITS 4
+
+/********************************************************************************************/
+/* Peripheral register layouts                                                              */
+/********************************************************************************************/
+
+/*System Integration Module*/
+typedef struct {
+	volatile uint32_t SOPT1;
+	volatile uint32_t SOPT2;
+	volatile uint32_t SCGC1;
+	volatile uint32_t SCGC2;
+	volatile uint32_t SCGC3;
+	volatile uint32_t SCGC4;
+	volatile uint32_t SCGC5;
+	volatile uint32_t SCGC6;
+	volatile uint32_t SCGC7;
+	volatile uint32_t CLKDIV1;
+	volatile uint32_t CLKDIV2;
+} SIM_Type;
+
+/*Port control and interrupts*/
+typedef struct {
+	volatile uint32_t PCR[32];
+	volatile uint32_t GPCLR;
+	volatile uint32_t GPCHR;
+	uint32_t RESERVED_0[6];
+	volatile uint32_t ISFR;
+	uint32_t RESERVED_1[7];
+	volatile uint32_t DFER;
+	volatile uint32_t DFCR;
+	volatile uint32_t DFWR;
+} PORT_Type;
+
+/*General purpose input/output*/
+typedef struct {
+	volatile uint32_t PDOR;
+	volatile uint32_t PSOR;
+	volatile uint32_t PCOR;
+	volatile uint32_t PTOR;
+	volatile uint32_t PDIR;
+	volatile uint32_t PDDR;
+} GPIO_Type;
+
+/*Periodic interrupt timer*/
+typedef struct {
+	volatile uint32_t MCR;
+	uint32_t RESERVED_0[63];
+	struct {
+		volatile uint32_t LDVAL;
+		volatile uint32_t CVAL;
+		volatile uint32_t TCTRL;
+		volatile uint32_t TFLG;
+	} CHANNEL[4];
+} PIT_Type;
+
+/*12 bits digital to analog converter*/
+typedef struct {
+	struct {
+		volatile uint8_t DATL;
+		volatile uint8_t DATH;
+	} DAT[16];
+	volatile uint8_t SR;
+	volatile uint8_t C0;
+	volatile uint8_t C1;
+	volatile uint8_t C2;
+} DAC_Type;
+
+/*Enhanced direct memory access controller*/
+typedef struct {
+	volatile uint32_t CR;
+	volatile uint32_t ES;
+	uint32_t RESERVED_0;
+	volatile uint32_t ERQ;
+	uint32_t RESERVED_1;
+	volatile uint32_t EEI;
+	volatile uint8_t CEEI;
+	volatile uint8_t SEEI;
+	volatile uint8_t CERQ;
+	volatile uint8_t SERQ;
+	volatile uint8_t CDNE;
+	volatile uint8_t SSRT;
+	volatile uint8_t CERR;
+	volatile uint8_t CINT;
+	uint32_t RESERVED_2;
+	volatile uint32_t INT;
+	uint32_t RESERVED_3;
+	volatile uint32_t ERR;
+	uint32_t RESERVED_4;
+	volatile uint32_t HRS;
+	struct {
+		volatile uint32_t SADDR;
+		volatile int16_t SOFF;
+		volatile uint16_t ATTR;
+		volatile uint32_t NBYTES_MLNO;
+		volatile int32_t SLAST;
+		volatile uint32_t DADDR;
+		volatile int16_t DOFF;
+		volatile uint16_t CITER_ELINKNO;
+		volatile int32_t DLAST_SGA;
+		volatile uint16_t CSR;
+		volatile uint16_t BITER_ELINKNO;
+	} TCD[16];
+} DMA_Type;
+
+/*DMA request multiplexer*/
+typedef struct {
+	volatile uint8_t CHCFG[16];
+} DMAMUX_Type;
+
+/*Programmable delay block*/
+typedef struct {
+	volatile uint32_t SC;
+	volatile uint32_t MOD;
+	volatile uint32_t CNT;
+	volatile uint32_t IDLY;
+	struct {
+		volatile uint32_t INTC;
+		volatile uint32_t INT;
+	} DAC[2];
+} PDB_Type;
+
+/*FlexTimer*/
+typedef struct {
+	volatile uint32_t SC;
+	volatile uint32_t CNT;
+	volatile uint32_t MOD;
+	struct {
+		volatile uint32_t CnSC;
+		volatile uint32_t CnV;
+	} CONTROLS[8];
+	volatile uint32_t CNTIN;
+	volatile uint32_t STATUS;
+	volatile uint32_t MODE;
+	volatile uint32_t SYNC;
+	volatile uint32_t OUTINIT;
+	volatile uint32_t OUTMASK;
+	volatile uint32_t COMBINE;
+	volatile uint32_t DEADTIME;
+	volatile uint32_t EXTTRIG;
+	volatile uint32_t POL;
+	volatile uint32_t FMS;
+	volatile uint32_t FILTER;
+	volatile uint32_t FLTCTRL;
+	volatile uint32_t QDCTRL;
+	volatile uint32_t CONF;
+	volatile uint32_t FLTPOL;
+	volatile uint32_t SYNCONF;
+	volatile uint32_t INVCTRL;
+	volatile uint32_t SWOCTRL;
+	volatile uint32_t PWMLOAD;
+} FTM_Type;
+
+/*Low power timer*/
+typedef struct {
+	volatile uint32_t CSR;
+	volatile uint32_t PSR;
+	volatile uint32_t CMR;
+	volatile uint32_t CNR;
+} LPTMR_Type;
+
+/*System mode controller*/
+typedef struct {
+	volatile uint8_t PMPROT;
+	volatile uint8_t PMCTRL;
+	volatile uint8_t STOPCTRL;
+	volatile uint8_t PMSTAT;
+} SMC_Type;
+
+/*Multipurpose clock generator*/
+typedef struct {
+	volatile uint8_t C1;
+	volatile uint8_t C2;
+	volatile uint8_t C3;
+	volatile uint8_t C4;
+	volatile uint8_t C5;
+	volatile uint8_t C6;
+	volatile uint8_t S;
+	uint8_t RESERVED_0[1];
+	volatile uint8_t SC;
+	uint8_t RESERVED_1[1];
+	volatile uint8_t ATCVH;
+	volatile uint8_t ATCVL;
+	volatile uint8_t C7;
+	volatile uint8_t C8;
+} MCG_Type;
+
+/*System oscillator*/
+typedef struct {
+	volatile uint8_t CR;
+} OSC_Type;
+
+/*All the simulated peripherals; The block is write protected, so each write of the firmware
+ * is seen by the simulator (see HostSim.c)*/
+typedef struct {
+	SIM_Type SIM;
+	PORT_Type PORT[5];
+	GPIO_Type GPIO[5];
+	PIT_Type PIT;
+	DAC_Type DAC[2];
+	DMA_Type DMA0;
+	DMAMUX_Type DMAMUX;
+	PDB_Type PDB0;
+	FTM_Type FTM[4];
+	LPTMR_Type LPTMR0;
+	SMC_Type SMC;
+	MCG_Type MCG;
+	OSC_Type OSC;
+} HOSTSIM_PeripheralsType;
+
+extern HOSTSIM_PeripheralsType HOSTSIM_peripherals;
+
+/********************************************************************************************/
+/* Peripheral instances                                                                     */
+/********************************************************************************************/
+
+#define SIM (&HOSTSIM_peripherals.SIM)
+#define PORTA (&HOSTSIM_peripherals.PORT[0])
+#define PORTB (&HOSTSIM_peripherals.PORT[1])
+#define PORTC (&HOSTSIM_peripherals.PORT[2])
+#define PORTD (&HOSTSIM_peripherals.PORT[3])
+#define PORTE (&HOSTSIM_peripherals.PORT[4])
+#define PTA (&HOSTSIM_peripherals.GPIO[0])
+#define PTB (&HOSTSIM_peripherals.GPIO[1])
+#define PTC (&HOSTSIM_peripherals.GPIO[2])
+#define PTD (&HOSTSIM_peripherals.GPIO[3])
+#define PTE (&HOSTSIM_peripherals.GPIO[4])
+#define PIT (&HOSTSIM_peripherals.PIT)
+#define DAC0 (&HOSTSIM_peripherals.DAC[0])
+#define DAC1 (&HOSTSIM_peripherals.DAC[1])
+#define DMA0 (&HOSTSIM_peripherals.DMA0)
+#define DMAMUX (&HOSTSIM_peripherals.DMAMUX)
+#define PDB0 (&HOSTSIM_peripherals.PDB0)
+#define FTM0 (&HOSTSIM_peripherals.FTM[0])
+#define FTM1 (&HOSTSIM_peripherals.FTM[1])
+#define FTM2 (&HOSTSIM_peripherals.FTM[2])
+#define FTM3 (&HOSTSIM_peripherals.FTM[3])
+#define LPTMR0 (&HOSTSIM_peripherals.LPTMR0)
+#define SMC (&HOSTSIM_peripherals.SMC)
+#define MCG (&HOSTSIM_peripherals.MCG)
+#define OSC (&HOSTSIM_peripherals.OSC)
+
+/********************************************************************************************/
+/* Register access macros (same names as the NXP header)                                    */
+/********************************************************************************************/
+
+#define SIM_SCGC2 (SIM->SCGC2)
+#define SIM_SCGC3 (SIM->SCGC3)
+#define SIM_SCGC5 (SIM->SCGC5)
+#define SIM_SCGC6 (SIM->SCGC6)
+#define SIM_SCGC7 (SIM->SCGC7)
+#define SIM_CLKDIV1 (SIM->CLKDIV1)
+
+#define PORTA_PCR(index) (PORTA->PCR[index])
+#define PORTB_PCR(index) (PORTB->PCR[index])
+#define PORTC_PCR(index) (PORTC->PCR[index])
+#define PORTD_PCR(index) (PORTD->PCR[index])
+#define PORTE_PCR(index) (PORTE->PCR[index])
+#define PORTA_ISFR (PORTA->ISFR)
+#define PORTB_ISFR (PORTB->ISFR)
+#define PORTC_ISFR (PORTC->ISFR)
+#define PORTD_ISFR (PORTD->ISFR)
+#define PORTE_ISFR (PORTE->ISFR)
+
+#define GPIOA_PDOR (PTA->PDOR)
+#define GPIOA_PSOR (PTA->PSOR)
+#define GPIOA_PCOR (PTA->PCOR)
+#define GPIOA_PTOR (PTA->PTOR)
+#define GPIOA_PDIR (PTA->PDIR)
+#define GPIOA_PDDR (PTA->PDDR)
+#define GPIOB_PDOR (PTB->PDOR)
+#define GPIOB_PSOR (PTB->PSOR)
+#define GPIOB_PCOR (PTB->PCOR)
+#define GPIOB_PTOR (PTB->PTOR)
+#define GPIOB_PDIR (PTB->PDIR)
+#define GPIOB_PDDR (PTB->PDDR)
+#define GPIOC_PDOR (PTC->PDOR)
+#define GPIOC_PSOR (PTC->PSOR)
+#define GPIOC_PCOR (PTC->PCOR)
+#define GPIOC_PTOR (PTC->PTOR)
+#define GPIOC_PDIR (PTC->PDIR)
+#define GPIOC_PDDR (PTC->PDDR)
+#define GPIOD_PDOR (PTD->PDOR)
+#define GPIOD_PSOR (PTD->PSOR)
+#define GPIOD_PCOR (PTD->PCOR)
+#define GPIOD_PTOR (PTD->PTOR)
+#define GPIOD_PDIR (PTD->PDIR)
+#define GPIOD_PDDR (PTD->PDDR)
+#define GPIOE_PDOR (PTE->PDOR)
+#define GPIOE_PSOR (PTE->PSOR)
+#define GPIOE_PCOR (PTE->PCOR)
+#define GPIOE_PTOR (PTE->PTOR)
+#define GPIOE_PDIR (PTE->PDIR)
+#define GPIOE_PDDR (PTE->PDDR)
+
+#define PIT_MCR (PIT->MCR)
+#define PIT_LDVAL0 (PIT->CHANNEL[0].LDVAL)
+#define PIT_LDVAL1 (PIT->CHANNEL[1].LDVAL)
+#define PIT_LDVAL2 (PIT->CHANNEL[2].LDVAL)
+#define PIT_LDVAL3 (PIT->CHANNEL[3].LDVAL)
+#define PIT_CVAL0 (PIT->CHANNEL[0].CVAL)
+#define PIT_CVAL1 (PIT->CHANNEL[1].CVAL)
+#define PIT_CVAL2 (PIT->CHANNEL[2].CVAL)
+#define PIT_CVAL3 (PIT->CHANNEL[3].CVAL)
+#define PIT_TCTRL0 (PIT->CHANNEL[0].TCTRL)
+#define PIT_TCTRL1 (PIT->CHANNEL[1].TCTRL)
+#define PIT_TCTRL2 (PIT->CHANNEL[2].TCTRL)
+#define PIT_TCTRL3 (PIT->CHANNEL[3].TCTRL)
+#define PIT_TFLG0 (PIT->CHANNEL[0].TFLG)
+#define PIT_TFLG1 (PIT->CHANNEL[1].TFLG)
+#define PIT_TFLG2 (PIT->CHANNEL[2].TFLG)
+#define PIT_TFLG3 (PIT->CHANNEL[3].TFLG)
+
+#define DAC0_DAT0L (DAC0->DAT[0].DATL)
+#define DAC0_DAT0H (DAC0->DAT[0].DATH)
+#define DAC0_DATL(index) (DAC0->DAT[index].DATL)
+#define DAC0_DATH(index) (DAC0->DAT[index].DATH)
+#define DAC0_SR (DAC0->SR)
+#define DAC0_C0 (DAC0->C0)
+#define DAC0_C1 (DAC0->C1)
+#define DAC0_C2 (DAC0->C2)
+#define DAC1_DAT0L (DAC1->DAT[0].DATL)
+#define DAC1_DAT0H (DAC1->DAT[0].DATH)
+#define DAC1_DATL(index) (DAC1->DAT[index].DATL)
+#define DAC1_DATH(index) (DAC1->DAT[index].DATH)
+#define DAC1_SR (DAC1->SR)
+#define DAC1_C0 (DAC1->C0)
+#define DAC1_C1 (DAC1->C1)
+#define DAC1_C2 (DAC1->C2)
+
+#define LPTMR0_CSR (LPTMR0->CSR)
+#define LPTMR0_PSR (LPTMR0->PSR)
+#define LPTMR0_CMR (LPTMR0->CMR)
+#define LPTMR0_CNR (LPTMR0->CNR)
+
+#define SMC_PMPROT (SMC->PMPROT)
+#define SMC_PMCTRL (SMC->PMCTRL)
+#define SMC_STOPCTRL (SMC->STOPCTRL)
+#define SMC_PMSTAT (SMC->PMSTAT)
+
+#define MCG_C1 (MCG->C1)
+#define MCG_C2 (MCG->C2)
+#define MCG_C4 (MCG->C4)
+#define MCG_C5 (MCG->C5)
+#define MCG_C6 (MCG->C6)
+#define MCG_S (MCG->S)
+#define MCG_SC (MCG->SC)
+#define MCG_C7 (MCG->C7)
+#define OSC_CR (OSC->CR)
+
+/********************************************************************************************/
+/* Bit fields                                                                               */
+/********************************************************************************************/
+
+#define SIM_SCGC3_FTM3_MASK 0x2000000u
+#define SIM_SCGC5_LPTMR_MASK 0x1u
+#define SIM_SCGC6_DMAMUX_MASK 0x2u
+#define SIM_SCGC6_PDB_MASK 0x400000u
+#define SIM_SCGC6_PIT_MASK 0x800000u
+#define SIM_SCGC6_FTM0_MASK 0x1000000u
+#define SIM_SCGC6_FTM1_MASK 0x2000000u
+#define SIM_SCGC6_FTM2_MASK 0x4000000u
+#define SIM_SCGC7_DMA_MASK 0x2u
+#define SIM_CLKDIV1_OUTDIV4_MASK 0xF0000u
+#define SIM_CLKDIV1_OUTDIV4_SHIFT 16
+#define SIM_CLKDIV1_OUTDIV4(x) (((uint32_t)(x) << SIM_CLKDIV1_OUTDIV4_SHIFT) & SIM_CLKDIV1_OUTDIV4_MASK)
+#define SIM_CLKDIV1_OUTDIV3_MASK 0xF00000u
+#define SIM_CLKDIV1_OUTDIV3_SHIFT 20
+#define SIM_CLKDIV1_OUTDIV3(x) (((uint32_t)(x) << SIM_CLKDIV1_OUTDIV3_SHIFT) & SIM_CLKDIV1_OUTDIV3_MASK)
+#define SIM_CLKDIV1_OUTDIV2_MASK 0xF000000u
+#define SIM_CLKDIV1_OUTDIV2_SHIFT 24
+#define SIM_CLKDIV1_OUTDIV2(x) (((uint32_t)(x) << SIM_CLKDIV1_OUTDIV2_SHIFT) & SIM_CLKDIV1_OUTDIV2_MASK)
+#define SIM_CLKDIV1_OUTDIV1_MASK 0xF0000000u
+#define SIM_CLKDIV1_OUTDIV1_SHIFT 28
+#define SIM_CLKDIV1_OUTDIV1(x) (((uint32_t)(x) << SIM_CLKDIV1_OUTDIV1_SHIFT) & SIM_CLKDIV1_OUTDIV1_MASK)
+
+#define PORT_PCR_MUX_MASK 0x700u
+#define PORT_PCR_MUX_SHIFT 8
+#define PORT_PCR_IRQC_MASK 0xF0000u
+#define PORT_PCR_IRQC_SHIFT 16
+#define PORT_PCR_ISF_MASK 0x1000000u
+
+#define PIT_MCR_FRZ_MASK 0x1u
+#define PIT_MCR_MDIS_MASK 0x2u
+#define PIT_TCTRL_TEN_MASK 0x1u
+#define PIT_TCTRL_TIE_MASK 0x2u
+#define PIT_TCTRL_CHN_MASK 0x4u
+#define PIT_TFLG_TIF_MASK 0x1u
+
+#define DAC_SR_DACBFRPBF_MASK 0x1u
+#define DAC_SR_DACBFRPTF_MASK 0x2u
+#define DAC_SR_DACBFWMF_MASK 0x4u
+#define DAC_C0_DACBBIEN_MASK 0x1u
+#define DAC_C0_DACBTIEN_MASK 0x2u
+#define DAC_C0_DACBWIEN_MASK 0x4u
+#define DAC_C0_DACSWTRG_MASK 0x10u
+#define DAC_C0_DACTRGSEL_MASK 0x20u
+#define DAC_C0_DACEN_MASK 0x80u
+#define DAC_C1_DACBFEN_MASK 0x1u
+#define DAC_C1_DACBFMD_MASK 0x6u
+#define DAC_C1_DACBFMD_SHIFT 1
+#define DAC_C1_DACBFMD(x) ((uint8_t)(((uint8_t)(x)) << DAC_C1_DACBFMD_SHIFT) & DAC_C1_DACBFMD_MASK)
+#define DAC_C1_DACBFWM_MASK 0x18u
+#define DAC_C1_DACBFWM_SHIFT 3
+#define DAC_C1_DACBFWM(x) ((uint8_t)(((uint8_t)(x)) << DAC_C1_DACBFWM_SHIFT) & DAC_C1_DACBFWM_MASK)
+#define DAC_C2_DACBFUP_MASK 0xFu
+#define DAC_C2_DACBFUP_SHIFT 0
+#define DAC_C2_DACBFUP(x) ((uint8_t)(((uint8_t)(x)) << DAC_C2_DACBFUP_SHIFT) & DAC_C2_DACBFUP_MASK)
+#define DAC_C2_DACBFRP_MASK 0xF0u
+#define DAC_C2_DACBFRP_SHIFT 4
+#define DAC_C2_DACBFRP(x) ((uint8_t)(((uint8_t)(x)) << DAC_C2_DACBFRP_SHIFT) & DAC_C2_DACBFRP_MASK)
+
+#define DMA_ATTR_DSIZE_MASK 0x7u
+#define DMA_ATTR_DSIZE(x) ((uint16_t)(x) & DMA_ATTR_DSIZE_MASK)
+#define DMA_ATTR_SSIZE_MASK 0x700u
+#define DMA_ATTR_SSIZE_SHIFT 8
+#define DMA_ATTR_SSIZE(x) ((uint16_t)(((uint16_t)(x)) << DMA_ATTR_SSIZE_SHIFT) & DMA_ATTR_SSIZE_MASK)
+#define DMA_CITER_ELINKNO_CITER_MASK 0x7FFFu
+#define DMA_CITER_ELINKNO_CITER(x) ((uint16_t)(x) & DMA_CITER_ELINKNO_CITER_MASK)
+#define DMA_BITER_ELINKNO_BITER_MASK 0x7FFFu
+#define DMA_BITER_ELINKNO_BITER(x) ((uint16_t)(x) & DMA_BITER_ELINKNO_BITER_MASK)
+#define DMA_CSR_START_MASK 0x1u
+#define DMA_CSR_INTMAJOR_MASK 0x2u
+#define DMA_CSR_DREQ_MASK 0x8u
+#define DMA_CSR_ESG_MASK 0x10u
+#define DMA_CSR_ACTIVE_MASK 0x40u
+#define DMA_CSR_DONE_MASK 0x80u
+#define DMA_SERQ_SAER_MASK 0x40u
+#define DMA_SERQ_NOP_MASK 0x80u
+
+#define DMAMUX_CHCFG_SOURCE_MASK 0x3Fu
+#define DMAMUX_CHCFG_SOURCE(x) ((uint8_t)(x) & DMAMUX_CHCFG_SOURCE_MASK)
+#define DMAMUX_CHCFG_TRIG_MASK 0x40u
+#define DMAMUX_CHCFG_ENBL_MASK 0x80u
+
+#define PDB_SC_LDOK_MASK 0x1u
+#define PDB_SC_CONT_MASK 0x2u
+#define PDB_SC_MULT_MASK 0xCu
+#define PDB_SC_MULT_SHIFT 2
+#define PDB_SC_PDBEN_MASK 0x80u
+#define PDB_SC_TRGSEL_MASK 0xF00u
+#define PDB_SC_TRGSEL_SHIFT 8
+#define PDB_SC_TRGSEL(x) (((uint32_t)(x) << PDB_SC_TRGSEL_SHIFT) & PDB_SC_TRGSEL_MASK)
+#define PDB_SC_PRESCALER_MASK 0x7000u
+#define PDB_SC_PRESCALER_SHIFT 12
+#define PDB_SC_PRESCALER(x) (((uint32_t)(x) << PDB_SC_PRESCALER_SHIFT) & PDB_SC_PRESCALER_MASK)
+#define PDB_SC_SWTRIG_MASK 0x10000u
+#define PDB_INTC_TOE_MASK 0x1u
+
+#define FTM_SC_PS_MASK 0x7u
+#define FTM_SC_PS(x) ((uint32_t)(x) & FTM_SC_PS_MASK)
+#define FTM_SC_CLKS_MASK 0x18u
+#define FTM_SC_CLKS_SHIFT 3
+#define FTM_SC_CLKS(x) (((uint32_t)(x) << FTM_SC_CLKS_SHIFT) & FTM_SC_CLKS_MASK)
+#define FTM_SC_CPWMS_MASK 0x20u
+#define FTM_SC_TOIE_MASK 0x40u
+#define FTM_SC_TOF_MASK 0x80u
+#define FTM_CnSC_DMA_MASK 0x1u
+#define FTM_CnSC_ELSA_MASK 0x4u
+#define FTM_CnSC_ELSB_MASK 0x8u
+#define FTM_CnSC_MSA_MASK 0x10u
+#define FTM_CnSC_MSB_MASK 0x20u
+#define FTM_CnSC_CHIE_MASK 0x40u
+#define FTM_CnSC_CHF_MASK 0x80u
+#define FTM_MODE_FTMEN_MASK 0x1u
+#define FTM_MODE_INIT_MASK 0x2u
+#define FTM_MODE_WPDIS_MASK 0x4u
+#define FTM_QDCTRL_QUADEN_MASK 0x1u
+#define FTM_QDCTRL_QUADIR_MASK 0x4u
+#define FTM_QDCTRL_QUADMODE_MASK 0x8u
+
+#define LPTMR_CSR_TEN_MASK 0x1u
+#define LPTMR_CSR_TMS_MASK 0x2u
+#define LPTMR_CSR_TFC_MASK 0x4u
+#define LPTMR_CSR_TIE_MASK 0x40u
+#define LPTMR_CSR_TCF_MASK 0x80u
+#define LPTMR_PSR_PCS_MASK 0x3u
+#define LPTMR_PSR_PCS(x) ((uint32_t)(x) & LPTMR_PSR_PCS_MASK)
+#define LPTMR_PSR_PBYP_MASK 0x4u
+#define LPTMR_PSR_PRESCALE_MASK 0x78u
+#define LPTMR_PSR_PRESCALE_SHIFT 3
+#define LPTMR_PSR_PRESCALE(x) (((uint32_t)(x) << LPTMR_PSR_PRESCALE_SHIFT) & LPTMR_PSR_PRESCALE_MASK)
+
+#define SMC_PMPROT_AVLP_MASK 0x20u
+#define SMC_PMCTRL_STOPM_MASK 0x7u
+#define SMC_PMCTRL_STOPM(x) ((uint8_t)(x) & SMC_PMCTRL_STOPM_MASK)
+#define SMC_PMCTRL_STOPA_MASK 0x8u
+#define SMC_PMCTRL_RUNM_MASK 0x60u
+#define SMC_PMCTRL_RUNM_SHIFT 5
+#define SMC_PMCTRL_RUNM(x) ((uint8_t)(((uint8_t)(x)) << SMC_PMCTRL_RUNM_SHIFT) & SMC_PMCTRL_RUNM_MASK)
+#define SMC_PMSTAT_PMSTAT_MASK 0x7Fu
+
+#define MCG_C1_IREFSTEN_MASK 0x1u
+#define MCG_C1_IRCLKEN_MASK 0x2u
+#define MCG_C1_IREFS_MASK 0x4u
+#define MCG_C1_FRDIV_MASK 0x38u
+#define MCG_C1_FRDIV_SHIFT 3
+#define MCG_C1_FRDIV(x) ((uint8_t)(((uint8_t)(x)) << MCG_C1_FRDIV_SHIFT) & MCG_C1_FRDIV_MASK)
+#define MCG_C1_CLKS_MASK 0xC0u
+#define MCG_C1_CLKS_SHIFT 6
+#define MCG_C1_CLKS(x) ((uint8_t)(((uint8_t)(x)) << MCG_C1_CLKS_SHIFT) & MCG_C1_CLKS_MASK)
+#define MCG_C2_IRCS_MASK 0x1u
+#define MCG_C2_LP_MASK 0x2u
+#define MCG_C2_EREFS_MASK 0x4u
+#define MCG_C2_HGO_MASK 0x8u
+#define MCG_C2_RANGE_MASK 0x30u
+#define MCG_C2_RANGE_SHIFT 4
+#define MCG_C2_RANGE(x) ((uint8_t)(((uint8_t)(x)) << MCG_C2_RANGE_SHIFT) & MCG_C2_RANGE_MASK)
+#define MCG_C4_DRST_DRS_MASK 0x60u
+#define MCG_C4_DRST_DRS_SHIFT 5
+#define MCG_C4_DMX32_MASK 0x80u
+#define MCG_C5_PRDIV0_MASK 0x1Fu
+#define MCG_C5_PRDIV0(x) ((uint8_t)(x) & MCG_C5_PRDIV0_MASK)
+#define MCG_C6_VDIV0_MASK 0x1Fu
+#define MCG_C6_VDIV0(x) ((uint8_t)(x) & MCG_C6_VDIV0_MASK)
+#define MCG_C6_PLLS_MASK 0x40u
+#define MCG_S_IRCST_MASK 0x1u
+#define MCG_S_OSCINIT0_MASK 0x2u
+#define MCG_S_CLKST_MASK 0xCu
+#define MCG_S_CLKST_SHIFT 2
+#define MCG_S_IREFST_MASK 0x10u
+#define MCG_S_PLLST_MASK 0x20u
+#define MCG_S_LOCK0_MASK 0x40u
+#define MCG_SC_FCRDIV_MASK 0xEu
+#define MCG_SC_FCRDIV_SHIFT 1
+#define MCG_SC_FCRDIV(x) ((uint8_t)(((uint8_t)(x)) << MCG_SC_FCRDIV_SHIFT) & MCG_SC_FCRDIV_MASK)
+#define MCG_C7_OSCSEL_MASK 0x3u
+#define OSC_CR_ERCLKEN_MASK 0x80u
+
+/********************************************************************************************/
+/* Core debug, DWT cycle counter and system control block                                   */
+/********************************************************************************************/
+
+/*These registers aren't write protected; CYCCNT is updated from the host clock each time DWT
+ * is used, so it counts the host time spent by the firmware, scaled to the core clock*/
+typedef struct {
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+	volatile uint32_t DHCSR;
+	volatile uint32_t DCRSR;
+	volatile uint32_t DCRDR;
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+extern CoreDebug_Type HOSTSIM_coreDebug;
+DWT_Type* HOSTSIM_dwt(void);
+
+#define DWT (HOSTSIM_dwt())
+#define CoreDebug (&HOSTSIM_coreDebug)
+
+#define DWT_CTRL_CYCCNTENA_Msk 0x1u
+#define CoreDebug_DEMCR_TRCENA_Msk 0x1000000u
+
+/*System control block; Only SCR is used, it is read by __WFI*/
+typedef struct {
+	volatile uint32_t SCR;
+} SCB_Type;
+
+extern SCB_Type HOSTSIM_scb;
+
+#define SCB (&HOSTSIM_scb)
+
+#define SCB_SCR_SLEEPDEEP_Msk 0x4u
+
+/********************************************************************************************/
+/* CMSIS core functions, implemented by the simulated NVIC                                  */
+/********************************************************************************************/
+
+typedef int IRQn_Type;
+
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+uint32_t NVIC_GetPriority(IRQn_Type IRQn);
+void __enable_irq(void);
+void __disable_irq(void);
+void __set_BASEPRI(uint32_t basePri);
+uint32_t __get_BASEPRI(void);
+void __DSB(void);
+void __WFI(void);
+
+/********************************************************************************************/
+/* CMSIS SIMD and saturation intrinsics of the Cortex-M4, with the same results in C         */
+/********************************************************************************************/
+
+/*Dual 16 bits signed multiply, with the sum of both products added to an accumulator; The sum
+ * wraps around, as in the core*/
+static inline uint32_t __SMLAD(uint32_t op1, uint32_t op2, uint32_t op3){
+	return (uint32_t)((int32_t)(int16_t)op1*(int16_t)op2) + (uint32_t)((int32_t)(int16_t)(op1 >> 16)*(int16_t)(op2 >> 16)) + op3;
+}
+
+/*Packs the lower half of the first operand and the lower half of the second one, shifted*/
+static inline uint32_t __PKHBT(uint32_t op1, uint32_t op2, uint32_t shift){
+	return (op1 & 0x0000FFFFu) | ((op2 << shift) & 0xFFFF0000u);
+}
+
+/*32 bits signed add, saturated to the int32_t range*/
+static inline int32_t __QADD(int32_t op1, int32_t op2){
+	int64_t sum = (int64_t)op1 + op2;
+	return (sum > INT32_MAX)?(INT32_MAX):((sum < INT32_MIN)?(INT32_MIN):((int32_t)sum));
+}
+
+/*Signed saturation to a number of bits (1 to 32)*/
+static inline int32_t __SSAT(int32_t value, uint32_t bits){
+	int64_t maximum = ((int64_t)1 << (bits - 1)) - 1;
+	return (value > maximum)?((int32_t)maximum):((value < -maximum - 1)?((int32_t)(-maximum - 1)):(value));
+}
+
+#endif /* HOSTSIM_MK64F12_H_ */
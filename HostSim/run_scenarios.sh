@@ -0,0 +1,53 @@
+#!/bin/sh
+# Builds the host simulator with the build options of each scenario (its "# build:" line, if
+# any), runs it, and compares its trace with the expected one, the .trace file next to the
+# scenario. The host times of the interruptions and of the profiled handlers, and the host
+# addresses of the memory map, depend on the host, so they aren't compared.
+# Run from the project directory:
+#	sh HostSim/run_scenarios.sh [--update] [scenario.txt ...]
+# With --update, the expected traces are written again from the current outputs.
+
+CC=${CC:-gcc}
+CFLAGS="-std=gnu99 -O1 -fno-pie -no-pie -IHostSim -I. -Dmain=FIRMWARE_main"
+UPDATE=0
+if [ "$1" = "--update" ]; then
+	UPDATE=1
+	shift
+fi
+SCENARIOS=${*:-HostSim/scenarios/*.txt}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+FAILED=0
+
+# Removes the fields that depend on the host from a trace
+normalize(){
+	sed -E -e 's/ host_(ns|cycles)_[a-z]+ [0-9]+//g' -e 's/ host_address [^ ]+//' "$1"
+}
+
+for SCENARIO in $SCENARIOS; do
+	NAME=$(basename "$SCENARIO" .txt)
+	EXPECTED=${SCENARIO%.txt}.trace
+	OPTIONS=$(sed -n 's/^# build://p' "$SCENARIO")
+	if ! $CC $CFLAGS $OPTIONS *.c HostSim/*.c -lm -o "$WORK/hostsim" 2> "$WORK/build.txt"; then
+		cat "$WORK/build.txt"
+		echo "FAIL $NAME (build)"
+		FAILED=1
+		continue
+	fi
+	if ! timeout 600 "$WORK/hostsim" "$SCENARIO" "$WORK/$NAME.trace" > /dev/null; then
+		echo "FAIL $NAME (run)"
+		FAILED=1
+		continue
+	fi
+	if [ $UPDATE -eq 1 ]; then
+		cp "$WORK/$NAME.trace" "$EXPECTED"
+		echo "UPDATED $NAME"
+	elif normalize "$EXPECTED" > "$WORK/expected.txt" && normalize "$WORK/$NAME.trace" | diff -u "$WORK/expected.txt" - > "$WORK/diff.txt"; then
+		echo "PASS $NAME"
+	else
+		cat "$WORK/diff.txt"
+		echo "FAIL $NAME"
+		FAILED=1
+	fi
+done
+exit $FAILED
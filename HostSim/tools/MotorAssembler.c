@@ -0,0 +1,386 @@
+/**
+	\file
+	\brief
+		This is the host assembler of the motor programs (MTRPRG.h). It reads a program in
+		text, checks it, and writes it as a C initializer made with the MOTORPROGRAM macros;
+		With --run, it runs the program with the interpreter of the firmware on a virtual
+		clock instead, for the given time, and writes the time (us) of each output; The
+		last line gives the segments run and the time run, up to the end of the program or
+		the given time (the last segment can wait past it, but it isn't counted). A line has an optional label
+		("name:"), and an instruction; "#" starts a comment:
+			speed <rpm>            SET_OUTPUT, 0 to MOTORCONTROL_MAX_RPM
+			duty <percent>         SET_DUTY, 0 to 100 (decimals allowed)
+			wait <time>ms|us       WAIT, from MOTORPROGRAM_MIN_WAIT_US to MOTORPROGRAM_MAX_WAIT_US
+			loop <count> <label>   LOOP, runs from the label up to the loop <count> times in total
+			jump <label>           JUMP
+			end                    END
+		The loops must be nested, up to MOTORPROGRAM_LOOP_DEPTH, a jump must not leave a
+		loop, a jump back must pass through a wait, and the program must end with a jump or
+		an end.
+
+		Build:
+			gcc -std=gnu99 -IHostSim -I. HostSim/tools/MotorAssembler.c MTRPRG.c -o mtrasm
+		Run:
+			./mtrasm [--name <symbol>] program.txt > program.h
+			./mtrasm --run <ms> program.txt
+		HostSim/tools/run_programs.sh assembles or runs the test programs of
+		HostSim/tools/programs, and compares their outputs with the expected ones.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MTRPRG.h"
+#include "MTRCTRL.h"
+
+/*Longest label, and most labels*/
+#define LABEL_SIZE 32
+#define MAX_LABELS 256
+
+/*Struct that contains a label, or a reference to a label*/
+typedef struct{
+	/*name, of the label*/
+	char name[LABEL_SIZE];
+	/*instruction, index of the labeled instruction, or of the one that refers to it*/
+	uint16 instruction;
+	/*line, of the source*/
+	unsigned line;
+}LabelType;
+
+static MOTORPROGRAM_InstructionType program[MOTORPROGRAM_MAX_INSTRUCTIONS];
+static unsigned programLines[MOTORPROGRAM_MAX_INSTRUCTIONS];
+static uint16 instructions = 0;
+static LabelType labels[MAX_LABELS];
+static uint16 labelCount = 0;
+static LabelType references[MAX_LABELS];
+static uint16 referenceCount = 0;
+static const char* sourcePath;
+static unsigned errors = 0;
+
+static void error(unsigned line, const char* message, const char* detail){
+	fprintf(stderr, "%s:%u: %s%s%s\n", sourcePath, line, message, (detail)?(": "):(""), (detail)?(detail):(""));
+	errors++;
+}
+
+static int findLabel(const char* name){
+	uint16 label;
+	for(label = 0; label < labelCount; label++){
+		if(!strcmp(labels[label].name, name)){
+			return label;
+		}
+	}
+	return -1;
+}
+
+static void addReference(const char* name, unsigned line){
+	/*The target is written when all the labels are known*/
+	if(referenceCount == MAX_LABELS || strlen(name) >= LABEL_SIZE){
+		error(line, "too many references, or label too long", name);
+		return;
+	}
+	strcpy(references[referenceCount].name, name);
+	references[referenceCount].instruction = instructions;
+	references[referenceCount].line = line;
+	referenceCount++;
+}
+
+static void emit(MOTORPROGRAM_InstructionType instruction, unsigned line){
+	if(instructions == MOTORPROGRAM_MAX_INSTRUCTIONS){
+		error(line, "program too long", NULL);
+		return;
+	}
+	programLines[instructions] = line;
+	program[instructions++] = instruction;
+}
+
+static void parseLine(char* text, unsigned line){
+	char* colon;
+	char mnemonic[16];
+	char operand[LABEL_SIZE + 16];
+	char label[LABEL_SIZE + 16];
+	char unit[8];
+	double value;
+	unsigned count;
+	int fields;
+
+	/*Comment, and label*/
+	if(strchr(text, '#')){
+		*strchr(text, '#') = '\0';
+	}
+	colon = strchr(text, ':');
+	if(colon){
+		*colon = '\0';
+		if(sscanf(text, " %47s", label) != 1 || strlen(label) >= LABEL_SIZE){
+			error(line, "bad label", text);
+		} else if(findLabel(label) >= 0){
+			error(line, "label defined twice", label);
+		} else if(labelCount == MAX_LABELS){
+			error(line, "too many labels", label);
+		} else {
+			strcpy(labels[labelCount].name, label);
+			labels[labelCount].instruction = instructions;
+			labels[labelCount].line = line;
+			labelCount++;
+		}
+		text = colon + 1;
+	}
+	if(sscanf(text, " %15s", mnemonic) != 1){
+		return;
+	}
+
+	if(!strcmp(mnemonic, "speed")){
+		if(sscanf(text, " %*s %lf", &value) != 1 || value < 0 || value > MOTORCONTROL_MAX_RPM || value != (uint32)value){
+			error(line, "speed must be 0 to MOTORCONTROL_MAX_RPM RPM", NULL);
+			return;
+		}
+		emit(MOTORPROGRAM_SET_OUTPUT((uint32)value), line);
+	} else if(!strcmp(mnemonic, "duty")){
+		if(sscanf(text, " %*s %lf", &value) != 1 || value < 0 || value > 100){
+			error(line, "duty must be 0 to 100 %", NULL);
+			return;
+		}
+		emit(MOTORPROGRAM_SET_DUTY((uint32)(value*(1 << 15)/100 + 0.5)), line);
+	} else if(!strcmp(mnemonic, "wait")){
+		fields = sscanf(text, " %*s %lf%7s", &value, unit);
+		if(fields == 2 && !strcmp(unit, "ms")){
+			value *= 1000;
+		} else if(fields != 2 || strcmp(unit, "us")){
+			error(line, "wait needs a time in ms or us", NULL);
+			return;
+		}
+		if(value < MOTORPROGRAM_MIN_WAIT_US || value > MOTORPROGRAM_MAX_WAIT_US || value != (uint32)value){
+			error(line, "wait must be a whole number of us, from MOTORPROGRAM_MIN_WAIT_US to MOTORPROGRAM_MAX_WAIT_US", NULL);
+			return;
+		}
+		emit(MOTORPROGRAM_WAIT_US((uint32)value), line);
+	} else if(!strcmp(mnemonic, "loop")){
+		if(sscanf(text, " %*s %u %47s", &count, operand) != 2 || count < 1 || count > MOTORPROGRAM_MAX_REPETITIONS){
+			error(line, "loop needs a count, 1 to MOTORPROGRAM_MAX_REPETITIONS, and a label", NULL);
+			return;
+		}
+		addReference(operand, line);
+		emit(MOTORPROGRAM_LOOP(count, 0), line);
+	} else if(!strcmp(mnemonic, "jump")){
+		if(sscanf(text, " %*s %47s", operand) != 1){
+			error(line, "jump needs a label", NULL);
+			return;
+		}
+		addReference(operand, line);
+		emit(MOTORPROGRAM_JUMP(0), line);
+	} else if(!strcmp(mnemonic, "end")){
+		emit(MOTORPROGRAM_END, line);
+	} else {
+		error(line, "unknown instruction", mnemonic);
+	}
+}
+
+static void resolve(){
+	uint16 reference;
+	uint16 instruction;
+	uint16 target;
+	uint16 other;
+	int label;
+	uint8 depth;
+	BooleanType waits;
+
+	for(reference = 0; reference < referenceCount; reference++){
+		label = findLabel(references[reference].name);
+		instruction = references[reference].instruction;
+		if(label < 0){
+			error(references[reference].line, "unknown label", references[reference].name);
+			continue;
+		}
+		target = labels[label].instruction;
+		if(MOTORPROGRAM_OPCODE(program[instruction]) == MOTORPROGRAM_OP_LOOP){
+			if(target > instruction){
+				error(references[reference].line, "the label of a loop must be before it", references[reference].name);
+			}
+			program[instruction] |= target;
+		} else {
+			if(target >= instructions){
+				error(references[reference].line, "jump to the end of the program", references[reference].name);
+			}
+			program[instruction] |= target;
+		}
+	}
+	if(errors){
+		return;
+	}
+
+	/*Loops: each pair is disjoint or nested, and a jump from the body of a loop stays in it*/
+	for(instruction = 0; instruction < instructions; instruction++){
+		if(MOTORPROGRAM_OPCODE(program[instruction]) == MOTORPROGRAM_OP_LOOP){
+			target = MOTORPROGRAM_LOOP_TARGET(program[instruction]);
+			depth = 1;
+			for(other = 0; other < instructions; other++){
+				if(MOTORPROGRAM_OPCODE(program[other]) == MOTORPROGRAM_OP_LOOP && other != instruction &&
+						MOTORPROGRAM_LOOP_TARGET(program[other]) <= instruction && instruction < other){
+					if(target < MOTORPROGRAM_LOOP_TARGET(program[other])){
+						error(programLines[instruction], "the loops overlap", NULL);
+					}
+					depth++;
+				}
+				if(MOTORPROGRAM_OPCODE(program[other]) == MOTORPROGRAM_OP_JUMP && target <= other && other < instruction &&
+						(MOTORPROGRAM_OPERAND(program[other]) < target || MOTORPROGRAM_OPERAND(program[other]) > instruction)){
+					error(programLines[other], "the jump leaves a loop", NULL);
+				}
+			}
+			if(depth > MOTORPROGRAM_LOOP_DEPTH){
+				error(programLines[instruction], "loops nested too deep", NULL);
+			}
+		}
+	}
+
+	/*A jump or a loop back without a wait would run in MOTORPROGRAM_MIN_WAIT_US segments for ever*/
+	for(instruction = 0; instruction < instructions; instruction++){
+		if(MOTORPROGRAM_OPCODE(program[instruction]) == MOTORPROGRAM_OP_JUMP &&
+				MOTORPROGRAM_OPERAND(program[instruction]) <= instruction){
+			waits = FALSE;
+			for(other = (uint16)MOTORPROGRAM_OPERAND(program[instruction]); other < instruction; other++){
+				if(MOTORPROGRAM_OPCODE(program[other]) == MOTORPROGRAM_OP_WAIT){
+					waits = TRUE;
+				}
+			}
+			if(waits == FALSE){
+				error(programLines[instruction], "jump back without a wait", NULL);
+			}
+		}
+	}
+
+	if(instructions == 0 || (MOTORPROGRAM_OPCODE(program[instructions - 1]) != MOTORPROGRAM_OP_END &&
+			MOTORPROGRAM_OPCODE(program[instructions - 1]) != MOTORPROGRAM_OP_JUMP)){
+		error((instructions)?(programLines[instructions - 1]):(0), "the program must end with a jump or an end", NULL);
+	}
+}
+
+static void printInstruction(FILE* file, MOTORPROGRAM_InstructionType instruction){
+	uint32 operand = MOTORPROGRAM_OPERAND(instruction);
+
+	switch(MOTORPROGRAM_OPCODE(instruction)){
+	case MOTORPROGRAM_OP_SET_OUTPUT:
+		fprintf(file, "MOTORPROGRAM_SET_OUTPUT(%u)", (unsigned)operand);
+		break;
+	case MOTORPROGRAM_OP_SET_DUTY:
+		fprintf(file, "MOTORPROGRAM_SET_DUTY(%u)", (unsigned)operand);
+		break;
+	case MOTORPROGRAM_OP_WAIT:
+		if(operand % 1000){
+			fprintf(file, "MOTORPROGRAM_WAIT_US(%u)", (unsigned)operand);
+		} else {
+			fprintf(file, "MOTORPROGRAM_WAIT_MS(%u)", (unsigned)operand/1000);
+		}
+		break;
+	case MOTORPROGRAM_OP_LOOP:
+		fprintf(file, "MOTORPROGRAM_LOOP(%u,%u)", (unsigned)MOTORPROGRAM_LOOP_REPETITIONS(instruction),
+				(unsigned)MOTORPROGRAM_LOOP_TARGET(instruction));
+		break;
+	case MOTORPROGRAM_OP_JUMP:
+		fprintf(file, "MOTORPROGRAM_JUMP(%u)", (unsigned)operand);
+		break;
+	default:
+		fprintf(file, "MOTORPROGRAM_END");
+		break;
+	}
+}
+
+static void printProgram(const char* name){
+	uint16 instruction;
+	uint16 label;
+
+	printf("/*Motor program assembled from %s; %u instructions*/\n", sourcePath, (unsigned)instructions);
+	printf("static const MOTORPROGRAM_InstructionType %s[] = {\n", name);
+	for(instruction = 0; instruction < instructions; instruction++){
+		printf("\t\t");
+		printInstruction(stdout, program[instruction]);
+		printf("%s", (instruction == instructions - 1)?(""):(","));
+		for(label = 0; label < labelCount; label++){
+			if(labels[label].instruction == instruction){
+				printf(" /*%s*/", labels[label].name);
+			}
+		}
+		printf("\n");
+	}
+	printf("};\n");
+}
+
+static void runProgram(double milliseconds){
+	MOTORPROGRAM_InterpreterType interpreter;
+	MOTORPROGRAM_SegmentType segment;
+	uint64 now = 0;
+	uint64 end = (uint64)(milliseconds*1000);
+	uint32 wait;
+	uint32 segments = 0;
+	uint8 output;
+
+	/*The virtual clock jumps from a segment to the next one, as the PIT3 of the motor scheduler*/
+	MOTORPROGRAM_start(&interpreter, program);
+	while(now <= end){
+		wait = MOTORPROGRAM_next(&interpreter, &segment);
+		segments++;
+		for(output = 0; output < segment.outputs; output++){
+			printf("%llu ", (unsigned long long)now);
+			if(MOTORPROGRAM_OPCODE(segment.output[output]) == MOTORPROGRAM_OP_SET_OUTPUT){
+				printf("speed %u\n", (unsigned)MOTORPROGRAM_OPERAND(segment.output[output]));
+			} else {
+				printf("duty %.2f\n", MOTORPROGRAM_OPERAND(segment.output[output])*100.0/(1 << 15));
+			}
+		}
+		if(wait == 0){
+			printf("%llu end\n", (unsigned long long)now);
+			break;
+		}
+		now += wait;
+	}
+	/*The wait of the last segment can go past the end of the run*/
+	if(now > end){
+		now = end;
+	}
+	printf("# segments %u us %llu\n", (unsigned)segments, (unsigned long long)now);
+}
+
+int main(int argc, char* argv[]){
+	const char* name = "motorProgram";
+	double runMilliseconds = -1;
+	char text[256];
+	unsigned line = 0;
+	FILE* file;
+	int argument;
+
+	for(argument = 1; argument < argc - 1; argument++){
+		if(!strcmp(argv[argument], "--name") && argument + 1 < argc - 1){
+			name = argv[++argument];
+		} else if(!strcmp(argv[argument], "--run") && argument + 1 < argc - 1){
+			runMilliseconds = atof(argv[++argument]);
+		} else {
+			break;
+		}
+	}
+	if(argument != argc - 1){
+		fprintf(stderr, "usage: %s [--name <symbol>] [--run <ms>] <program>\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	sourcePath = argv[argument];
+	file = fopen(sourcePath, "r");
+	if(file == NULL){
+		fprintf(stderr, "mtrasm: can't read %s\n", sourcePath);
+		return EXIT_FAILURE;
+	}
+	while(fgets(text, sizeof(text), file)){
+		parseLine(text, ++line);
+	}
+	fclose(file);
+	resolve();
+	if(errors){
+		fprintf(stderr, "mtrasm: %u errors\n", errors);
+		return EXIT_FAILURE;
+	}
+
+	if(runMilliseconds >= 0){
+		runProgram(runMilliseconds);
+	} else {
+		printProgram(name);
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+#!/bin/sh
+# Builds the motor program assembler, and assembles each test program, or runs it for the time of
+# its "# run: <ms>" line, if any; Then it compares the output, with the errors and the exit status,
+# with the expected one, the .out file next to the program.
+# Run from the project directory:
+#	sh HostSim/tools/run_programs.sh [--update] [program.txt ...]
+# With --update, the expected outputs are written again from the current ones.
+
+CC=${CC:-gcc}
+CFLAGS="-std=gnu99 -IHostSim -I."
+UPDATE=0
+if [ "$1" = "--update" ]; then
+	UPDATE=1
+	shift
+fi
+PROGRAMS=${*:-HostSim/tools/programs/*.txt}
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+FAILED=0
+
+if ! $CC $CFLAGS HostSim/tools/MotorAssembler.c MTRPRG.c -o "$WORK/mtrasm"; then
+	echo "FAIL (build)"
+	exit 1
+fi
+
+for PROGRAM in $PROGRAMS; do
+	NAME=$(basename "$PROGRAM" .txt)
+	EXPECTED=${PROGRAM%.txt}.out
+	RUN=$(sed -n 's/^# run://p' "$PROGRAM")
+	if [ -n "$RUN" ]; then
+		"$WORK/mtrasm" --run $RUN "$PROGRAM" > "$WORK/$NAME.out" 2>&1
+	else
+		"$WORK/mtrasm" "$PROGRAM" > "$WORK/$NAME.out" 2>&1
+	fi
+	echo "# exit $?" >> "$WORK/$NAME.out"
+	if [ $UPDATE -eq 1 ]; then
+		cp "$WORK/$NAME.out" "$EXPECTED"
+		echo "UPDATED $NAME"
+	elif diff -u "$EXPECTED" "$WORK/$NAME.out" > "$WORK/diff.txt"; then
+		echo "PASS $NAME"
+	else
+		cat "$WORK/diff.txt"
+		echo "FAIL $NAME"
+		FAILED=1
+	fi
+done
+exit $FAILED
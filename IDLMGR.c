@@ -0,0 +1,94 @@
+/**
+	\file
+	\brief
+		This is the source file for the idle manager. The sleep mode is selected with the
+		SLEEPDEEP bit of the core: WFI without it enters the wait mode, and with it enters the
+		stop mode selected in SMC_PMCTRL, that is VLPS.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "IDLMGR.h"
+#include "LPTMR.h"
+#include "EVNTQ.h"
+#include "CLKMGR.h"
+#include "NVIC.h"
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*Stop mode entered with SLEEPDEEP: very low power stop*/
+#define STOP_MODE_VLPS 0x2
+
+/*Clients that need the bus clock; Each flag is only written by its client*/
+static volatile BooleanType busClockNeeded[IDLEMANAGER_CLIENTS];
+/*Idle statistics*/
+static IDLEMANAGER_StatsType stats;
+/*Time base when the manager was initialized*/
+static uint32 initMilliseconds;
+
+void IDLEMANAGER_init(){
+	uint8 index;
+
+	/*PMPROT can be written only once after the reset; VLPR and VLPS are allowed*/
+	SMC_PMPROT = SMC_PMPROT_AVLP_MASK;
+	SMC_PMCTRL = (SMC_PMCTRL & ~SMC_PMCTRL_STOPM_MASK) | SMC_PMCTRL_STOPM(STOP_MODE_VLPS);
+
+	for(index = 0; index < IDLEMANAGER_CLIENTS; index++){
+		busClockNeeded[index] = FALSE;
+	}
+	for(index = 0; index < IDLEMANAGER_MODES; index++){
+		stats.entries[index] = 0;
+		stats.milliseconds[index] = 0;
+	}
+	LPTMR_init();
+	initMilliseconds = LPTMR_milliseconds();
+	stats.elapsedMilliseconds = 0;
+}
+
+void IDLEMANAGER_busClockNeeded(IDLEMANAGER_ClientType client, BooleanType needed){
+	busClockNeeded[client] = needed;
+}
+
+static IDLEMANAGER_ModeType IDLEMANAGER_deepestMode(){
+	uint8 client;
+	for(client = 0; client < IDLEMANAGER_CLIENTS; client++){
+		if(busClockNeeded[client]){
+			return IDLEMANAGER_WAIT;
+		}
+	}
+	return IDLEMANAGER_VLPS;
+}
+
+void IDLEMANAGER_idle(){
+	IDLEMANAGER_ModeType mode;
+	uint32 start;
+
+	/*With the interruptions disabled, an interruption still ends WFI, but it is attended after
+	 * EnableInterrupts; So an event pushed after the queues are checked can't be left waiting
+	 * until the next interruption*/
+	DisableInterrupts;
+	if(EVENTQUEUE_isEmpty()){
+		mode = IDLEMANAGER_deepestMode();
+		if(mode == IDLEMANAGER_VLPS){
+			SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+		} else {
+			SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+		}
+		start = LPTMR_milliseconds();
+		__DSB();
+		__WFI();
+		if(mode == IDLEMANAGER_VLPS){
+			/*The MCG leaves VLPS in PBE mode; The PLL is selected again before the wake up
+			 * interruption is attended*/
+			CLOCKMANAGER_wakeUp();
+		}
+		stats.milliseconds[mode] += LPTMR_milliseconds() - start;
+		stats.entries[mode]++;
+	}
+	EnableInterrupts;
+}
+
+const IDLEMANAGER_StatsType* IDLEMANAGER_stats(){
+	stats.elapsedMilliseconds = LPTMR_milliseconds() - initMilliseconds;
+	return &stats;
+}
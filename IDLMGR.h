@@ -0,0 +1,92 @@
+/**
+	\file
+	\brief
+		This is the header file for the idle manager. When the main loop has no events to
+		attend, it sleeps with WFI until an interruption, in the deepest mode that the active
+		processes allow:
+			- Wait: the core stops, but the bus clock runs, so the PIT, DMA, DAC and PDB keep
+			  working. It is used while any client needs the bus clock (the wave generator, a
+			  running timer of the timer wheel, or the motor control loop or DMA sequence).
+			- VLPS (very low power stop): all the clocks but the LPO stop. It is used when only
+			  the inputs are expected; The PORT interruptions of the keyboard (PTB20), SW2 and
+			  SW3 are asynchronous, and wake up the MCU from VLPS without the LLWU.
+		LLS and VLLS aren't used: they only wake up with the LLWU pins, and PTB20 isn't one of
+		them. The time spent in each mode is measured with the LPTMR time base, that keeps
+		counting while the MCU sleeps.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_IDLMGR_H_
+#define SOURCES_IDLMGR_H_
+
+#include "DataTypeDefinitions.h"
+
+/*! This enumerated constant are used to select a sleep mode*/
+typedef enum {IDLEMANAGER_WAIT, /*!< Wait mode, the bus clock runs */
+			  IDLEMANAGER_VLPS, /*!< Very low power stop mode, only the LPO runs */
+			  IDLEMANAGER_MODES
+			 }IDLEMANAGER_ModeType;
+
+/*! This enumerated constant are used to select a client that can need the bus clock*/
+typedef enum {IDLEMANAGER_WAVEGEN,        /*!< Wave generator: PIT0, DMA, DAC and PDB */
+			  IDLEMANAGER_TIMERWHEEL,     /*!< Timer wheel: PIT2 */
+			  IDLEMANAGER_MOTOR,          /*!< Motor control loop (PIT1, FTM0 and the FTM1 decoder), DMA sequence (PIT3, DMA and FTM0), or auxiliary motor outputs (FTM0) */
+			  IDLEMANAGER_MOTORSCHEDULER, /*!< Motor programs (PIT3) */
+			  IDLEMANAGER_CLIENTS
+			 }IDLEMANAGER_ClientType;
+
+/*Struct that contains the idle statistics*/
+typedef struct{
+	/*entries, times the MCU slept in each mode*/
+	uint32 entries[IDLEMANAGER_MODES];
+	/*milliseconds, time slept in each mode; Each sleep is measured with a resolution of 1ms,
+	 * but the sum has no bias, as the sleeps start at any moment of a millisecond*/
+	uint32 milliseconds[IDLEMANAGER_MODES];
+	/*elapsedMilliseconds, time since IDLEMANAGER_init, updated by IDLEMANAGER_stats*/
+	uint32 elapsedMilliseconds;
+}IDLEMANAGER_StatsType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function allows the VLPS mode, starts the LPTMR time base and clears the
+ 	 	 statistics. It must be called before the processes are initialized.
+ 	 \return void
+ */
+void IDLEMANAGER_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function indicates if a client needs the bus clock while the MCU sleeps. Each
+ 	 	 client has its own flag, so it can be called from the main loop or an interruption.
+ 	 \param[in] client Client
+ 	 \param[in] needed TRUE while the client uses a peripheral clocked by the bus clock
+ 	 \return void
+ */
+void IDLEMANAGER_busClockNeeded(IDLEMANAGER_ClientType client, BooleanType needed);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function is called from the main loop, after the events are attended. If
+ 	 	 no event arrived meanwhile, the MCU sleeps until the next interruption, that is
+ 	 	 attended before it returns.
+ 	 \return void
+ */
+void IDLEMANAGER_idle();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the idle statistics
+ 	 \return Pointer to the statistics
+ */
+const IDLEMANAGER_StatsType* IDLEMANAGER_stats();
+
+#endif /* SOURCES_IDLMGR_H_ */
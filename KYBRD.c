@@ -3,6 +3,8 @@
 	\brief
 		This is the source file for a KEYBOARD using a MM74C922, with the Kinetis
 		64F. Includes the functions to initialize the KEYBOARD, and PORTB_IRQHandler.
+		The data lines are gathered into 4 bits with two masks and shifts, and the lookup
+		table puts them back in the order of the code (D is the MSB).
 	\author Patricio Gomez Garca
 	\date	23/09/2016
  */
@@ -11,42 +13,85 @@
 #ifndef SOURCES_KEYB_C_
 #define SOURCES_KEYB_C_
 
+#include <stddef.h>
 #include "NVIC.h"
 #include "GPIO.h"
 #include "GlobalFunctions.h"
-#include "PSSWRD.h"
+#include "LPTMR.h"
 #include "MK64F12.h"
 #include "KYBRD.h"
+#include "PRFL.h"
+#include "EVNTQ.h"
 
-/*local variable for the data received in the keyboard*/
-static uint8 keyBoardData = FALSE;
+/*Data available from the encoder, in PORT B*/
+#define DATA_AVAILABLE_MASK GPIO_PIN_MASK(BIT20)
+/*Data lines of the encoder, in PORT B: D (MSB) in pin 2, C in 3, B in 10 and A (LSB) in 11*/
+#define DATA_LOW_MASK (GPIO_PIN_MASK(BIT2)|GPIO_PIN_MASK(BIT3))
+#define DATA_HIGH_MASK (GPIO_PIN_MASK(BIT10)|GPIO_PIN_MASK(BIT11))
+/*Pins sampled by the interruption*/
+#define SAMPLE_MASK (DATA_AVAILABLE_MASK|DATA_LOW_MASK|DATA_HIGH_MASK)
+/*Shifts that gather the data lines into 4 bits: pin 2 in bit 0, 3 in 1, 10 in 2 and 11 in 3*/
+#define DATA_LOW_SHIFT BIT2
+#define DATA_HIGH_SHIFT (BIT10 - BIT2)
+/*Bits of a key code*/
+#define CODE_MASK 0xF
+/*Events that can be waiting in the keypad queue*/
+#define TIMESTAMP_MASK (EVENTQUEUE_SIZE - 1)
 
+/*Code of the key for each gathered value; The gather leaves the data lines in reverse order*/
+static const uint8 codeOfGather[] = {
+		0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE, 0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+};
+/*Character printed on the key of each code (BUTTON_* values)*/
+static const uint8 keyOfCode[] = {
+		'D', 'B', 'C', 'A', '0', '5', '8', '2', '#', '6', '9', '3', '*', '4', '7', '1'
+};
+/*Time of the keys waiting in the keypad queue, in the same order; The queue has a single
+ * producer and consumer, so each event stored by the interruption is attended in order*/
+static volatile uint32 timestamps[EVENTQUEUE_SIZE];
+/*Next place of timestamps written by the interruption, and read by the main loop*/
+static uint8 timestampTail = 0;
+static uint8 timestampHead = 0;
+/*Function that attends the key events*/
+static void(*fptrHandler)(const KEYBOARD_EventType*) = NULL;
 
-void KEYBOARD_init(){
-	/*Sets the configuration needed to receive an interruption when there is data available in the keyboard*/
-	GPIO_pinControlRegisterType pinControlRegisterPORTB = GPIO_MUX1|INTR_RISING_EDGE;
-	/*Sets PORT B pin 20, with the functionality of MUX_1  and the interruption actives with the rising edge*/
-	GPIO_pinControlRegister(GPIOB,BIT20,&pinControlRegisterPORTB);
-	/*Sets PORT B pin 20 as an input (Data available from the Keyboard interruption)*/
-	GPIO_dataDirectionPIN(GPIOB,GPIO_INPUT,BIT20);
+static uint8 KEYBOARD_decode(uint32 sample){
+	return codeOfGather[((sample & DATA_LOW_MASK) >> DATA_LOW_SHIFT)
+	                    | ((sample & DATA_HIGH_MASK) >> DATA_HIGH_SHIFT)];
+}
+
+/*Attends, in the main loop, a key stored by PORTB_IRQHandler*/
+static void KEYBOARD_attend(uint8 code){
+	KEYBOARD_EventType event;
+
+	event.timestamp = timestamps[timestampHead & TIMESTAMP_MASK];
+	timestampHead++;
+	event.code = code;
+	event.key = KEYBOARD_keyOfCode(code);
+	if(fptrHandler){
+		fptrHandler(&event);
+	}
+}
 
-	/*Sets the configuration needed to get the data available from ports B2, B3, B10 and B11*/
-	GPIO_pinControlRegisterType pinControlRegisterPORTB2_11 = GPIO_MUX1;
-	/*Sets PORT B pins 2, 3, 10 and 11, with the functionality of MUX_1 */
-	GPIO_pinControlRegister(GPIOB,BIT2,&pinControlRegisterPORTB2_11);
-	GPIO_pinControlRegister(GPIOB,BIT3,&pinControlRegisterPORTB2_11);
-	GPIO_pinControlRegister(GPIOB,BIT10,&pinControlRegisterPORTB2_11);
-	GPIO_pinControlRegister(GPIOB,BIT11,&pinControlRegisterPORTB2_11);
-	/*Sets PORT B pins 2, 3, 10 and 11 as inputs (Data from the keyboard)*/
-	GPIO_dataDirectionPIN(GPIOB,GPIO_INPUT,BIT2);
-	GPIO_dataDirectionPIN(GPIOB,GPIO_INPUT,BIT3);
-	GPIO_dataDirectionPIN(GPIOB,GPIO_INPUT,BIT10);
-	GPIO_dataDirectionPIN(GPIOB,GPIO_INPUT,BIT11);
+void KEYBOARD_init(){
+	/*Keys are attended in the main loop, masking the same interruptions as PORTB_IRQHandler*/
+	timestampTail = 0;
+	timestampHead = 0;
+	EVENTQUEUE_setHandler(EVENTQUEUE_KEYPAD,KEYBOARD_attend,PRIORITY_6);
+	/*The pins (PTB20, and PTB2, PTB3, PTB10, PTB11) and the PORTB interruption are configured by
+	 * BOARDCONFIG_init*/
+}
 
-	/*Enable the PORTB interruptions with PRIORITY 10*/
-	NVIC_enableInterruptAndPriority(PORTB_IRQ, PRIORITY_6);
+void KEYBOARD_setHandler(void(*handler)(const KEYBOARD_EventType*)){
+	fptrHandler = handler;
+}
 
+uint8 KEYBOARD_readCode(){
+	return KEYBOARD_decode(GPIO_fastReadPINS(GPIOB,SAMPLE_MASK));
+}
 
+uint8 KEYBOARD_keyOfCode(uint8 code){
+	return keyOfCode[code & CODE_MASK];
 }
 
 /********************************************************************************************/
@@ -58,20 +103,21 @@ void KEYBOARD_init(){
  	 \return void
  */
 void PORTB_IRQHandler(){
-	/*Double check of the interruption*/
-	if(GPIO_readPIN(GPIOB,BIT20)){
-		/*Gather from the pins 2, 3, 10, 11 in PORT B, the keyboard data*/
-		keyBoardData = ( ( GPIO_readPIN(GPIOB,BIT2) << 3 ) )
-				| ( ( GPIO_readPIN(GPIOB,BIT3) << 2 ) ) | ( ( GPIO_readPIN(GPIOB,BIT10) << 1 ) )
-				| ( ( GPIO_readPIN(GPIOB,BIT11) ) );
-		/*Call the function that will attend the data change in PASSWORD process and state machine*/
-		PASSWORD_getNewData(keyBoardData);
-		/*Do a software Debouncer, with a delay*/
+	PROFILER_START(PROFILER_PORTB);
+	/*Data available and the data lines, in a single read of the port*/
+	uint32 sample = GPIO_fastReadPINS(GPIOB,SAMPLE_MASK);
+	/*Double check of the interruption, and glitches discarded*/
+	if((sample & DATA_AVAILABLE_MASK) && GPIO_debounceAccept(GPIOB,BIT20)){
+		/*The key is attended in the main loop by the registered handler (the PASSWORD process); Its
+		 * time is stored only if the event was, so the timestamps stay in the order of the queue*/
+		if(EVENTQUEUE_push(EVENTQUEUE_KEYPAD,KEYBOARD_decode(sample))){
+			timestamps[timestampTail & TIMESTAMP_MASK] = LPTMR_milliseconds();
+			timestampTail++;
+		}
 	}
 	/*Clear the interruption flags*/
 	GPIO_clearInterrupt(GPIOB);
-	/*Digital Debouncer*/
-	delay(25000);
+	PROFILER_STOP(PROFILER_PORTB);
 }
 
 
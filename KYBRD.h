@@ -3,6 +3,9 @@
 	\brief
 		This is the header file for a KEYBOARD using a MM74C922, with the Kinetis
 		64F. Includes the functions to initialize the KEYBOARD, and PORTB_IRQHandler.
+		The data of the encoder (PTB2, PTB3, PTB10 and PTB11) and data available (PTB20) are
+		sampled with a single read of GPIOB_PDIR, and the code is decoded with lookup tables.
+		Each key is delivered to the main loop as an event, with the time it was pressed.
 	\author Patricio Gomez Garca
 	\date	23/09/2016
  */
@@ -10,6 +13,8 @@
 #ifndef SOURCES_KYBRD_H_
 #define SOURCES_KYBRD_H_
 
+#include "DataTypeDefinitions.h"
+
 /*Buttons interpretation: If data is 0x4, button 0 was pressed*/
 #define BUTTON_0 0x4
 /*Buttons interpretation: If data is 0xf, button 1 was pressed*/
@@ -43,6 +48,16 @@
 /*Buttons interpretation: If data is 0x8, button # was pressed*/
 #define BUTTON_NUMBER 0x8
 
+/*Struct that contains a key event*/
+typedef struct{
+	/*timestamp, LPTMR time base (ms) when the interruption read the key*/
+	uint32 timestamp;
+	/*code, of the key, one of the BUTTON_* values*/
+	uint8 code;
+	/*key, character printed on the key: '0' to '9', 'A' to 'D', '*' or '#'*/
+	uint8 key;
+}KEYBOARD_EventType;
+
 /********************************************************************************************/
 /********************************************************************************************/
 /********************************************************************************************/
@@ -53,5 +68,36 @@
  */
 void KEYBOARD_init();
 
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function registers the function that attends the key events. It is called in
+ 	 	 	 the main loop, with the interruptions of PORT B masked.
+ 	 \param[in] handler Function called with each key event
+ 	 \return void
+ */
+void KEYBOARD_setHandler(void(*handler)(const KEYBOARD_EventType*));
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function reads the data lines of the encoder, with a single read of the port.
+ 	 	 	 It is only meaningful while data available is high.
+ 	 \return Code of the key, one of the BUTTON_* values
+ */
+uint8 KEYBOARD_readCode();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief	 This function returns the character printed on a key
+ 	 \param[in] code Code of the key, one of the BUTTON_* values
+ 	 \return Character of the key
+ */
+uint8 KEYBOARD_keyOfCode(uint8 code);
+
 
 #endif /* SOURCES_KYBRD_H_ */
@@ -0,0 +1,68 @@
+/**
+	\file
+	\brief
+		This is the source file for the low power timer (LPTMR0) in Kinetis 64F, used as a
+		millisecond time base. The counter is read writing CNR first, that latches its value.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "LPTMR.h"
+#include "NVIC.h"
+#include "PRFL.h"
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*Prescaler clock select: LPO*/
+#define LPTMR_LPO 0x1
+/*Last value of the counter; The compare flag is set when the counter goes from here to 0*/
+#define LPTMR_MAXIMUM 0xFFFF
+/*Counts in an overflow of the counter*/
+#define LPTMR_OVERFLOW 0x10000
+/*Counter values below this one, read with the compare flag set, are after the overflow*/
+#define LPTMR_HALF 0x8000
+
+/*Overflows of the counter, counted by the interruption*/
+static volatile uint32 overflows = 0;
+
+void LPTMR_init(){
+	SIM_SCGC5 |= SIM_SCGC5_LPTMR_MASK;
+	if(LPTMR0_CSR & LPTMR_CSR_TEN_MASK){
+		return;
+	}
+	/*Time counter mode, free running, with the LPO without prescaler*/
+	LPTMR0_PSR = LPTMR_PSR_PCS(LPTMR_LPO) | LPTMR_PSR_PBYP_MASK;
+	LPTMR0_CMR = LPTMR_MAXIMUM;
+	LPTMR0_CSR = LPTMR_CSR_TFC_MASK | LPTMR_CSR_TIE_MASK;
+	overflows = 0;
+	NVIC_enableInterruptAndPriority(LOW_POWER_TIMER_IRQ, LPTMR_PRIORITY);
+	LPTMR0_CSR |= LPTMR_CSR_TEN_MASK;
+}
+
+uint32 LPTMR_milliseconds(){
+	uint32 high;
+	uint32 low;
+	uint32 pending;
+
+	/*If the interruption counted an overflow meanwhile, the counter is read again*/
+	do{
+		high = overflows;
+		LPTMR0_CNR = 0;
+		low = LPTMR0_CNR & LPTMR_MAXIMUM;
+		pending = LPTMR0_CSR & LPTMR_CSR_TCF_MASK;
+	}while(high != overflows);
+
+	/*An overflow not counted yet, because the interruption is masked by the caller*/
+	if(pending && low < LPTMR_HALF){
+		high++;
+	}
+	return high*LPTMR_OVERFLOW + low;
+}
+
+void LPTMR0_IRQHandler(){
+	PROFILER_START(PROFILER_LPTMR0);
+	/*TCF is cleared writing 1; the other bits are written with the same value*/
+	LPTMR0_CSR |= LPTMR_CSR_TCF_MASK;
+	overflows++;
+	PROFILER_STOP(PROFILER_LPTMR0);
+}
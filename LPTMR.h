@@ -0,0 +1,45 @@
+/**
+	\file
+	\brief
+		This is the header file for the low power timer (LPTMR0) in Kinetis 64F. It is used
+		as a millisecond time base that keeps counting in the wait and stop modes (VLPS), as
+		it is clocked by the 1kHz LPO. The 16 bits counter runs free, and its overflows are
+		counted by the LPTMR0 interruption, so the time base has 32 bits (49 days).
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_LPTMR_H_
+#define SOURCES_LPTMR_H_
+
+#include "DataTypeDefinitions.h"
+#include "NVIC.h"
+
+/*Clock of the counter: the LPO, without prescaler (Hz)*/
+#define LPTMR_CLOCK 1000
+/*Priority of the overflow interruption*/
+#define LPTMR_PRIORITY PRIORITY_11
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function starts the time base: it enables the LPTMR clock gating, selects
+ 	 	 the LPO without prescaler, and enables the free running counter and its overflow
+ 	 	 interruption. If the time base is already running, it does nothing.
+ 	 \return void
+ */
+void LPTMR_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the time base. It can be called from any interruption, even
+ 	 	 while the overflow interruption is masked; Only the difference between two values, as
+ 	 	 uint32, is meaningful.
+ 	 \return Milliseconds since LPTMR_init
+ */
+uint32 LPTMR_milliseconds();
+
+#endif /* SOURCES_LPTMR_H_ */
@@ -0,0 +1,66 @@
+/**
+	\file
+	\brief
+		This is the source file for the fixed point mixer of the wave generator. The mix
+		itself is the inline function MIXER_output; Here are its configuration and its
+		benchmark.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "MIXR.h"
+#include "DataTypeDefinitions.h"
+#include "GlobalFunctions.h"
+
+/*Half of the last bit of the result, added to the accumulator to round instead of truncate; With
+ * it, a unity gain gives back the same sample*/
+#define MIXER_ROUNDING (1 << 14)
+
+MIXER_ChannelConfigType MIXER_channels[MIXER_CHANNELS];
+
+void MIXER_init(){
+	uint8 channel;
+	uint8 source;
+
+	for(channel = 0; channel < MIXER_CHANNELS; channel++){
+		for(source = 0; source < MIXER_SOURCES; source++){
+			MIXER_setGain((MIXER_ChannelType)channel, source, (source == channel)?(MIXER_UNITY_GAIN):(0));
+		}
+		MIXER_setOffset((MIXER_ChannelType)channel, 0);
+	}
+}
+
+void MIXER_setGain(MIXER_ChannelType channel, uint8 source, sint16 gain){
+	uint32* gainPair = &MIXER_channels[channel].gainPairs[source/2];
+
+	/*The odd sources are in the upper half of the pair*/
+	if(source % 2){
+		*gainPair = MIXER_PACK(*gainPair, gain);
+	} else {
+		*gainPair = MIXER_PACK(gain, *gainPair >> 16);
+	}
+}
+
+void MIXER_setOffset(MIXER_ChannelType channel, sint16 offset){
+	MIXER_channels[channel].bias = ((sint32)offset << 15) + MIXER_ROUNDING;
+}
+
+uint32 MIXER_benchmark(){
+	/*samples of the sources; They change each sample, so the mix can't be taken out of the loop*/
+	uint32 samplePairs[MIXER_SOURCES/2];
+	/*The results are added, so the mix isn't removed by the compiler*/
+	volatile uint32 outputs = 0;
+	uint32 start;
+	uint32 sample;
+	uint8 pair;
+
+	for(pair = 0; pair < MIXER_SOURCES/2; pair++){
+		samplePairs[pair] = MIXER_PACK(-MIXER_MIDDLE, MIXER_MIDDLE - 1);
+	}
+	start = cycleCounter();
+	for(sample = 0; sample < MIXER_BENCHMARK_SAMPLES; sample++){
+		samplePairs[0] += sample;
+		outputs += MIXER_output(MIXER_DAC0, samplePairs);
+	}
+	return cycleCounter() - start;
+}
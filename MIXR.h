@@ -0,0 +1,134 @@
+/**
+	\file
+	\brief
+		This is the header file for the fixed point mixer of the wave generator. It is the
+		stage between the arrays of values and the DACs: each output channel (DAC0, DAC1)
+		mixes up to MIXER_SOURCES signed samples, each one with its own gain, and adds an
+		offset; The result is saturated to the 12 bits of the DAC, so a change of amplitude
+		or DC level doesn't need new arrays.
+			- The samples are signed DAC counts, around the middle of the scale (-2048 to 2047).
+			- The gains are Q15 (MIXER_UNITY_GAIN is 0.99997, and a negative gain inverts).
+			- The offset is in DAC counts.
+		The mix uses the DSP instructions of the Cortex-M4: two samples and two gains are
+		packed in a 32 bits word, and SMLAD multiplies and accumulates both at once; QADD adds
+		the offset with saturation, and SSAT saturates the result.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_MIXR_H_
+#define SOURCES_MIXR_H_
+
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*Sources mixed by each channel; It must be even, as SMLAD takes them in pairs. With 12 bits
+ * samples and Q15 gains, the accumulator (32 bits) can't overflow with up to 16 sources*/
+#define MIXER_SOURCES 4
+/*Bits of the DAC, and the middle of its scale (the sample 0)*/
+#define MIXER_DAC_BITS 12
+#define MIXER_MIDDLE (1 << (MIXER_DAC_BITS - 1))
+/*Q15 gains*/
+#define MIXER_UNITY_GAIN 0x7FFF
+#define MIXER_Q15(gain) ((sint16)((gain)*32767))
+/*Packs two signed 16 bits values in a 32 bits word, the first one in the lower half*/
+#define MIXER_PACK(low,high) ((uint32)(uint16)(low) | ((uint32)(uint16)(high) << 16))
+/*Samples mixed by MIXER_benchmark*/
+#define MIXER_BENCHMARK_SAMPLES 256
+
+/*! This enumerated constant are used to select an output channel of the mixer*/
+typedef enum {MIXER_DAC0, /*!< Channel loaded to the DAC0 */
+			  MIXER_DAC1, /*!< Channel loaded to the DAC1, in the dual mode of the wave generator */
+			  MIXER_CHANNELS
+			 }MIXER_ChannelType;
+
+/*Struct that contains the configuration of a channel*/
+typedef struct{
+	/*gainPairs, Q15 gains of the sources, packed in pairs as the samples (MIXER_PACK)*/
+	uint32 gainPairs[MIXER_SOURCES/2];
+	/*bias, offset scaled to the accumulator (Q15), plus half of the last bit to round*/
+	sint32 bias;
+}MIXER_ChannelConfigType;
+
+/*Configuration of each channel; It is declared here for the inline function, but it is only
+ * written by MIXER_setGain and MIXER_setOffset*/
+extern MIXER_ChannelConfigType MIXER_channels[MIXER_CHANNELS];
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures each channel to pass a source as it is: the source 0 to
+ 	 	 the DAC0 and the source 1 to the DAC1, with a unity gain and no offset.
+ 	 \return void
+ */
+void MIXER_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function sets the gain of a source in a channel. It can be called while the
+ 	 	 channel is being mixed; The pair of gains is written at once.
+ 	 \param[in] channel Output channel
+ 	 \param[in] source Source (0 to MIXER_SOURCES - 1)
+ 	 \param[in] gain Q15 gain (MIXER_Q15)
+ 	 \return void
+ */
+void MIXER_setGain(MIXER_ChannelType channel, uint8 source, sint16 gain);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function sets the offset added to the mix of a channel
+ 	 \param[in] channel Output channel
+ 	 \param[in] offset Offset in DAC counts (-4096 to 4095)
+ 	 \return void
+ */
+void MIXER_setOffset(MIXER_ChannelType channel, sint16 offset);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function measures the cost of MIXER_output with the cycle counter, mixing
+ 	 	 MIXER_BENCHMARK_SAMPLES samples of the DAC0 channel; The cycles of the loop are
+ 	 	 included. In the host simulator, it runs in the initialization, where the cycle
+ 	 	 counter counts the host instructions, so the result is an instruction count of the
+ 	 	 host build, only useful to compare changes.
+ 	 \return Cycles spent by the MIXER_BENCHMARK_SAMPLES samples
+ */
+uint32 MIXER_benchmark();
+
+/*Inline check of the gains of a source, for the interruption handlers: TRUE if a channel mixes it
+ * with a gain other than 0, so its samples are needed*/
+static inline BooleanType MIXER_sourceMixed(uint8 source){
+	uint8 channel;
+
+	for(channel = 0; channel < MIXER_CHANNELS; channel++){
+		/*The odd sources are in the upper half of the pair*/
+		if((uint16)(MIXER_channels[channel].gainPairs[source/2] >> ((source % 2)*16))){
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*Inline version of the mix, for the interruption handlers; With a constant channel, the loop is
+ * unrolled to MIXER_SOURCES/2 SMLAD instructions*/
+static inline uint16 MIXER_output(MIXER_ChannelType channel, const uint32* samplePairs){
+	const MIXER_ChannelConfigType* config = &MIXER_channels[channel];
+	uint32 accumulator = 0;
+	uint8 pair;
+
+	/*sample x gain of two sources per instruction, Q15*/
+	for(pair = 0; pair < MIXER_SOURCES/2; pair++){
+		accumulator = __SMLAD(samplePairs[pair],config->gainPairs[pair],accumulator);
+	}
+	/*The offset is added with saturation, and the result is saturated to the DAC range and moved to
+	 * the middle of the scale*/
+	return (uint16)(__SSAT(__QADD((sint32)accumulator,config->bias) >> 15,MIXER_DAC_BITS) + MIXER_MIDDLE);
+}
+
+#endif /* SOURCES_MIXR_H_ */
@@ -3,174 +3,853 @@
 	\brief
 		This is the source file for a DC MOTOR process, which has a programmer defined
 		behavior, using state machines. It uses different interruptions, and "depends"
-		from other processes.
+		from other processes. Each motor is driven by a PWM output of the FTM0, and each
+		sequence of a motor is a motor program (MTRPRG.h), run by the motor scheduler
+		(MTRSCH.h) in the PIT3 interruption; Each speed in RPM of the main motor is held by a
+		PID controller with the speed measured by an encoder (closed loop), or given as a
+		duty with ramps loaded by the DMA (open loop), and the auxiliary motors take the
+		duty of each output at once. In the DMA sequence mode, a program of the main motor
+		made of outputs and waits is compiled to a chain of descriptors, and run by the DMA
+		without interruptions.
 	\author Patricio Gomez Garca
 	\date	26/09/2016
  */
 
+#include <stddef.h>
 #include "MTRCTRL.h"
 #include "GPIO.h"
 #include "NVIC.h"
-#include "PIT.h"
 #include "GlobalFunctions.h"
 #include "MK64F12.h"
+#include "PRFL.h"
+#include "EVNTQ.h"
+#include "TMRWHL.h"
+#include "FTM.h"
+#include "DMA.h"
+#include "CLKMGR.h"
+#include "PIT.h"
+#include "PID.h"
+#include "IDLMGR.h"
+#include "MTRSCH.h"
 
-/*System clock 21MHz*/
-#define SYSTEM_CLOCK 21000000
+/*LED1 and LED2 of the main motor, in PORT C*/
+#define LED1_MASK GPIO_PIN_MASK(BIT16)
+#define LED2_MASK GPIO_PIN_MASK(BIT17)
+/*Motor outputs: PTC1, the channel 0 of the FTM0, is the main motor*/
+#define MOTOR_FTM FTM_0
+#define MOTOR_CHANNEL FTM_CH0
+/*Auxiliary motor 1: PTC2, the channel 1 of the FTM0, and its LED1 and LED2 in PTC8 and PTC9*/
+#define AUXILIARY_CHANNEL FTM_CH1
+#define AUXILIARY_LED1_MASK GPIO_PIN_MASK(BIT8)
+#define AUXILIARY_LED2_MASK GPIO_PIN_MASK(BIT9)
+/*Context of the main motor*/
+#define MAIN_MOTOR (&motors[MOTORCONTROL_MAIN_MOTOR])
+/*DMA channel that loads the duties of a ramp; It is requested by each match of the motor channel,
+ * once per PWM period*/
+#define MOTOR_RAMP_DMA DMA_CH4
+/*Encoder: phases A and B in PTB0 and PTB1, counted by the FTM1 decoder*/
+#define MOTOR_ENCODER FTM_1
+/*Control loop period*/
+#define CONTROL_PIT PIT_1
+#define CONTROL_TICKS PIT_TICKS_FROM_HZ(CLOCKMANAGER_busClock(),MOTORCONTROL_CONTROL_HZ)
+/*Speeds of the control loop: encoder edges per control period, Q8 (1 edge is 256)*/
+#define ENCODER_EDGES (4*MOTORCONTROL_ENCODER_LINES)
+#define RPM_TO_SPEED(rpm) ((sint32)(((uint32)(rpm)*ENCODER_EDGES*256)/(60*MOTORCONTROL_CONTROL_HZ)))
+#define MAX_SPEED RPM_TO_SPEED(MOTORCONTROL_MAX_RPM)
+/*Output of the controller: Q15 duty, from 0 to 1.0 (a high output); Its duty in counts of the FTM
+ * counter is computed with a shift, as the period changes with the bus clock*/
+#define OUTPUT_FULL (1 << 15)
+#define OUTPUT_TO_DUTY(output) (uint16)(((uint32)(output)*periodCounts) >> 15)
+/*Gains of the controller, Q15 duty per Q8 edge per control period; They are tuned for a motor
+ * that takes ~60ms to reach its speed, and makes ~10% more than MOTORCONTROL_MAX_RPM at 100%*/
+#define CONTROL_KP PID_GAIN(0.12)
+#define CONTROL_KI PID_GAIN(0.03)
+#define CONTROL_KD PID_GAIN(0.01)
+/*Duty level (%) of a speed, in the open loop*/
+#define SPEED_LEVEL(rpm) (uint8)(((uint32)(rpm)*100)/MOTORCONTROL_MAX_RPM)
+/*Counts of a PWM period with the current bus clock*/
+#define MOTOR_PERIOD_COUNTS (uint16)(CLOCKMANAGER_busClock()/MOTORCONTROL_PWM_HZ)
+/*Duty of a level (%), in counts of the FTM counter; 100% is a whole period, a high output*/
+#define MOTOR_DUTY_COUNTS(level) (uint16)(((uint32)periodCounts*(level))/100)
+/*Ramp tables: PWM periods per each 1% of the longest ramp, and entries of a table*/
+#define RAMP_MAX_PERIODS_PER_PERCENT ((MOTORCONTROL_RAMP_MAX_MS*MOTORCONTROL_PWM_HZ)/(1000*100))
+#define RAMP_TABLE_SIZE (100*RAMP_MAX_PERIODS_PER_PERCENT + 1)
+#define ACCELERATION_RAMP 0
+#define DECELERATION_RAMP 1
+/*Duration of a number of PWM periods, in ms (rounded up)*/
+#define RAMP_MS(periods) (((uint32)(periods)*1000 + MOTORCONTROL_PWM_HZ - 1)/MOTORCONTROL_PWM_HZ)
+/*The PIT3 times the waits of the programs, in the scheduler. In the DMA sequence mode, with the
+ * scheduler stopped, each expiry requests the DMA channel 3 instead (periodic trigger), that writes
+ * the duty of a behavior and the load value of the next one, and then loads the descriptor of the
+ * next step (scatter gather)*/
+#define SEQUENCE_PIT PIT_3
+#define SEQUENCE_DMA DMA_CH3
+#define SEQUENCE_TICKS(microseconds) PIT_TICKS_FROM_US(CLOCKMANAGER_busClock(),microseconds)
+/*Sequences with programs (FIRST_SEQUENCE and SECOND_SEQUENCE), and the most behaviors of a program
+ * run by the DMA*/
+#define SEQUENCES NULL_SEQUENCE
+#define SEQUENCE_MAX_BEHAVIORS 4
+/*BASEPRI value that masks the timer wheel and the scheduler interruptions, where the behaviors
+ * change, and the control loop, that has a lower priority*/
+#define MOTOR_BASEPRI ((uint32)TIMERWHEEL_PRIORITY << (8 - __NVIC_PRIO_BITS))
 
-/*Constant array that contains the MOTOR behavior and the duration of that behavior, when the state is 1*/
-static const uint8 firstSequenceBehaviorAndDuration[8] = {MOTOR_OFF, 1, MOTOR_ON, 1, MOTOR_OFF, 3, MOTOR_ON, 1};
-/*Constant array that contains the MOTOR behavior and the duration of that behavior, when the state is 2*/
-static const uint8 secondSequenceBehaviorAndDuration[4] = {MOTOR_OFF, 4, MOTOR_ON, 4};
-/*Constant array that contains the MOTOR behavior and the duration of that behavior, when the state is 0*/
-static const uint8 nullSequenceBehaviorAndDuration[2] = {MOTOR_OFF, 0};
+/*Step of a sequence run by the DMA: the duty of a behavior, and the PIT3 load value of the next one,
+ * in the order they are written by the minor loop of its descriptor*/
+typedef struct{
+	uint32 duty;
+	uint32 nextTicks;
+}MOTORCONTROL_SequenceStepType;
+
+/*Constant array that contains the MOTOR program, when the state is 1: 1s off, 1s on, 3s off, 1s on*/
+static const MOTORPROGRAM_InstructionType firstSequenceProgram[] = {
+		MOTORPROGRAM_SET_OUTPUT(MOTOR_OFF), MOTORPROGRAM_WAIT_MS(1000),
+		MOTORPROGRAM_SET_OUTPUT(MOTOR_ON),  MOTORPROGRAM_WAIT_MS(1000),
+		MOTORPROGRAM_SET_OUTPUT(MOTOR_OFF), MOTORPROGRAM_WAIT_MS(3000),
+		MOTORPROGRAM_SET_OUTPUT(MOTOR_ON),  MOTORPROGRAM_WAIT_MS(1000),
+		MOTORPROGRAM_JUMP(0)
+};
+/*Constant array that contains the MOTOR program, when the state is 2: 4s off, 4s on*/
+static const MOTORPROGRAM_InstructionType secondSequenceProgram[] = {
+		MOTORPROGRAM_SET_OUTPUT(MOTOR_OFF), MOTORPROGRAM_WAIT_MS(4000),
+		MOTORPROGRAM_SET_OUTPUT(MOTOR_ON),  MOTORPROGRAM_WAIT_MS(4000),
+		MOTORPROGRAM_JUMP(0)
+};
+/*Constant array that contains the program of an auxiliary motor, when the state is 1: 500ms at 50%,
+ * 500ms off*/
+static const MOTORPROGRAM_InstructionType auxiliaryFirstProgram[] = {
+		MOTORPROGRAM_SET_DUTY(MOTORPROGRAM_DUTY_PERCENT(50)), MOTORPROGRAM_WAIT_MS(500),
+		MOTORPROGRAM_SET_DUTY(0),                             MOTORPROGRAM_WAIT_MS(500),
+		MOTORPROGRAM_JUMP(0)
+};
+/*Constant array that contains the program of an auxiliary motor, when the state is 2: three pulses
+ * of 200ms on, and 1.4s off*/
+static const MOTORPROGRAM_InstructionType auxiliarySecondProgram[] = {
+		MOTORPROGRAM_SET_OUTPUT(MOTOR_ON),  MOTORPROGRAM_WAIT_MS(200),
+		MOTORPROGRAM_SET_OUTPUT(MOTOR_OFF), MOTORPROGRAM_WAIT_MS(200),
+		MOTORPROGRAM_LOOP(3,0),
+		MOTORPROGRAM_WAIT_MS(1400),
+		MOTORPROGRAM_JUMP(0)
+};
 
 /*
- * Struct and enum state machine, containing the pointer to the MOTOR behavior and duration array,
- * the next sequence, two function pointers (ledSequence,changeSequence), and LEDS states
+ * Struct and enum state machine, containing the next sequence, two function pointers
+ * (ledSequence,changeSequence), and LEDS states
  */
 static motorControlState motorConState[3] = {
-		{FIRST_BEHAVIOR_DURATION,4,SECOND_SEQUENCE,MOTORCONTROL_ledSequence,MOTORCONTROL_changeSequence,BIT_OFF, BIT_ON},
-		{SECOND_BEHAVIOR_DURATION,2,NULL_SEQUENCE,MOTORCONTROL_ledSequence,MOTORCONTROL_changeSequence,BIT_ON,BIT_OFF},
-		{NULL_BEHAVIOR_DURATION,1,FIRST_SEQUENCE,MOTORCONTROL_ledSequence,MOTORCONTROL_changeSequence,BIT_ON,BIT_ON}
+		{SECOND_SEQUENCE,MOTORCONTROL_ledSequence,MOTORCONTROL_changeSequence,BIT_OFF, BIT_ON},
+		{NULL_SEQUENCE,MOTORCONTROL_ledSequence,MOTORCONTROL_changeSequence,BIT_ON,BIT_OFF},
+		{FIRST_SEQUENCE,MOTORCONTROL_ledSequence,MOTORCONTROL_changeSequence,BIT_ON,BIT_ON}
 };
 
-/*current state will indicate which is the state or sequence, the motor is in*/
-static uint8 currentState = NULL_SEQUENCE;
-/*index for shifting in the arrays containing the behavior and duration*/
-static uint8 behaviorIndex = 0;
+/*Struct that contains the outputs of a motor, wired in the board*/
+typedef struct{
+	/*channel, of the FTM0 that drives the motor*/
+	FTM_ChannelType channel;
+	/*led1Mask and led2Mask, LED1 and LED2 of the motor, in PORT C*/
+	uint32 led1Mask;
+	uint32 led2Mask;
+	/*programs, of the FIRST_SEQUENCE and the SECOND_SEQUENCE; The NULL_SEQUENCE has none, the
+	 * motor stops*/
+	const MOTORPROGRAM_InstructionType* programs[NULL_SEQUENCE];
+}MOTORCONTROL_MotorConfigType;
+
+/*Struct that contains a motor of the process*/
+typedef struct{
+	/*program, context of the motor in the scheduler; It is the first field, so the outputs of
+	 * the scheduler get the motor*/
+	MOTORSCHEDULER_MotorType program;
+	/*config, outputs of the motor*/
+	const MOTORCONTROL_MotorConfigType* config;
+	/*currentState, the state or sequence the motor is in*/
+	uint8 currentState;
+	/*duty, Q15 duty of an auxiliary motor, written again after a bus clock change*/
+	uint16 duty;
+}MOTORCONTROL_MotorType;
+
+/*Outputs of the motors; The first one is the main motor*/
+static const MOTORCONTROL_MotorConfigType motorConfigs[MOTORCONTROL_MAX_MOTORS] = {
+		{MOTOR_CHANNEL,LED1_MASK,LED2_MASK,{firstSequenceProgram,secondSequenceProgram}},
+		{AUXILIARY_CHANNEL,AUXILIARY_LED1_MASK,AUXILIARY_LED2_MASK,{auxiliaryFirstProgram,auxiliarySecondProgram}}
+};
+/*Motors of the process*/
+static MOTORCONTROL_MotorType motors[MOTORCONTROL_MOTORS];
+/*Auxiliary motors with a duty, one bit per motor*/
+static uint32 auxiliaryOutputs = 0;
+/*logical timer for the end of the stop ramp of the open loop*/
+static TIMERWHEEL_TimerType behaviorTimer;
+
+/*Counts of a PWM period*/
+static uint16 periodCounts;
+/*Speed (RPM) of the current behavior*/
+static uint16 targetRpm = MOTOR_OFF;
+/*Duty level (%) where the last ramp of the open loop ends*/
+static uint8 targetLevel = 0;
+/*Durations (ms) of the ramps from 0% to 100%, PWM periods per each 1% of them (0 changes the duty at
+ * once), and their tables: the duty of each period of a ramp from 0% to 100%. A ramp between two
+ * levels walks the part of the table between them, up or down*/
+static uint16 rampMilliseconds[2] = {0, 0};
+static uint8 periodsPerPercent[2];
+static uint16 rampTables[2][RAMP_TABLE_SIZE];
+
+/*Control loop: mode, state of the PIT1, and TRUE until the first step measures the speed*/
+static BooleanType closedLoop = MOTORCONTROL_CLOSED_LOOP;
+static BooleanType controlRunning = FALSE;
+static BooleanType speedUnknown;
+/*Speed controller, and its last output (Q15 duty)*/
+static PID_ControllerType speedController;
+static sint32 controlOutput = 0;
+/*Encoder counter at the previous step*/
+static uint16 lastEncoderCount;
+/*Speeds (Q8 edges per control period): measured, reference of the controller, and the one of the
+ * behavior, where the reference goes; The reference moves a step per control period*/
+static sint32 measuredSpeed;
+static sint32 speedReference;
+static sint32 targetSpeed = 0;
+static sint32 referenceSteps[2];
+
+/*DMA sequence mode: selected, and a chain running; The steps of each sequence, compiled from its
+ * program with the current bus clock (0 steps if the program can't be run by the DMA), and the ring
+ * of descriptors that writes them*/
+static BooleanType dmaSequence = MOTORCONTROL_DMA_SEQUENCE;
+static BooleanType sequenceRunning = FALSE;
+static uint8 sequenceLength[SEQUENCES];
+static MOTORCONTROL_SequenceStepType sequenceSteps[SEQUENCES][SEQUENCE_MAX_BEHAVIORS];
+static DMA_DescriptorType sequenceChains[SEQUENCES][SEQUENCE_MAX_BEHAVIORS];
+
+static uint32 MOTORCONTROL_lock(){
+	/*Masks the timer wheel interruption, unless it is already masked*/
+	uint32 basePri = __get_BASEPRI();
+	if(basePri == 0 || basePri > MOTOR_BASEPRI){
+		__set_BASEPRI(MOTOR_BASEPRI);
+	}
+	return basePri;
+}
+
+static void MOTORCONTROL_busClockUpdate(){
+	/*The control loop, a chain of the DMA and the duty of an auxiliary motor need the bus clock (PIT,
+	 * FTM and DMA); The programs are kept by the scheduler*/
+	IDLEMANAGER_busClockNeeded(IDLEMANAGER_MOTOR, (BooleanType)(controlRunning || sequenceRunning || auxiliaryOutputs));
+}
+
+static void MOTORCONTROL_rampTablesInit(){
+	uint8 ramp;
+	uint16 entry;
+	uint16 entries;
+	uint16 controlPeriods;
+
+	for(ramp = ACCELERATION_RAMP; ramp <= DECELERATION_RAMP; ramp++){
+		/*Closed loop: the reference goes from 0 to MAX_SPEED in the control periods of the ramp*/
+		controlPeriods = (uint16)(((uint32)rampMilliseconds[ramp]*MOTORCONTROL_CONTROL_HZ)/1000);
+		referenceSteps[ramp] = (controlPeriods)?((MAX_SPEED + controlPeriods - 1)/controlPeriods):(MAX_SPEED);
+		/*Open loop*/
+		periodsPerPercent[ramp] = (uint8)(((uint32)rampMilliseconds[ramp]*MOTORCONTROL_PWM_HZ)/(1000*100));
+		entries = 100*periodsPerPercent[ramp];
+		/*The entry of each level is its duty, as MOTOR_DUTY_COUNTS, so the ramps end at the exact duty;
+		 * Without entries, the duty changes at once*/
+		for(entry = 0; entries && entry <= entries; entry++){
+			rampTables[ramp][entry] = (uint16)(((uint32)periodCounts*entry)/entries);
+		}
+	}
+}
+
+static uint8 MOTORCONTROL_sequenceSteps(uint8 state){
+	const MOTORPROGRAM_InstructionType* program = motorConfigs[MOTORCONTROL_MAIN_MOTOR].programs[state];
+	uint16 instruction;
+	uint8 steps = 0;
+	uint32 wait;
+	uint32 firstWait = 0;
+	BooleanType output = FALSE;
+
+	/*A program can be run by the DMA if it is a list of speeds and waits, repeated by a JUMP to its
+	 * first instruction, that starts with a speed; Each wait ends a step, with the last speed. The load
+	 * value of a step is the wait of the next one, and the one of the last step is the first wait*/
+	for(instruction = 0; instruction < MOTORPROGRAM_MAX_INSTRUCTIONS; instruction++){
+		switch(MOTORPROGRAM_OPCODE(program[instruction])){
+		case MOTORPROGRAM_OP_SET_OUTPUT:
+			if(steps == SEQUENCE_MAX_BEHAVIORS){
+				return 0;
+			}
+			sequenceSteps[state][steps].duty = MOTOR_DUTY_COUNTS(SPEED_LEVEL(MOTORPROGRAM_OPERAND(program[instruction])));
+			output = TRUE;
+			break;
+		case MOTORPROGRAM_OP_WAIT:
+			if(output == FALSE || steps == SEQUENCE_MAX_BEHAVIORS){
+				return 0;
+			}
+			/*The waits are at least MOTORPROGRAM_MIN_WAIT_US, as in the interpreter*/
+			wait = MOTORPROGRAM_OPERAND(program[instruction]);
+			if(wait < MOTORPROGRAM_MIN_WAIT_US){
+				wait = MOTORPROGRAM_MIN_WAIT_US;
+			}
+			if(steps){
+				sequenceSteps[state][steps - 1].nextTicks = SEQUENCE_TICKS(wait);
+			} else {
+				firstWait = wait;
+			}
+			steps++;
+			if(steps < SEQUENCE_MAX_BEHAVIORS){
+				sequenceSteps[state][steps].duty = sequenceSteps[state][steps - 1].duty;
+			}
+			break;
+		case MOTORPROGRAM_OP_JUMP:
+			if(MOTORPROGRAM_OPERAND(program[instruction]) || steps == 0){
+				return 0;
+			}
+			sequenceSteps[state][steps - 1].nextTicks = SEQUENCE_TICKS(firstWait);
+			return steps;
+		default:
+			/*SET_DUTY, LOOP and END are only run by the scheduler*/
+			return 0;
+		}
+	}
+	return 0;
+}
+
+static void MOTORCONTROL_sequencesCompile(){
+	uint8 state;
+	uint8 step;
+	uint8 next;
+	DMA_TransferConfigType stepConfig;
+
+	/*Each request is a single minor loop of two words: the duty, and then the load value, as the
+	 * destination offset is the distance from the duty register to the load value register*/
+	stepConfig.destinationAddress = FTM_dutyRegister(MOTOR_FTM,MOTOR_CHANNEL);
+	stepConfig.sourceOffset = sizeof(uint32);
+	stepConfig.destinationOffset = (sint16)((volatile uint8*)PIT_loadRegister(SEQUENCE_PIT) - (volatile uint8*)FTM_dutyRegister(MOTOR_FTM,MOTOR_CHANNEL));
+	stepConfig.transferSize = DMA_TRANSFER_32BIT;
+	stepConfig.bytesPerRequest = sizeof(MOTORCONTROL_SequenceStepType);
+	stepConfig.majorLoopCount = 1;
+	stepConfig.sourceLastAdjust = 0;
+	stepConfig.destinationLastAdjust = 0;
+	stepConfig.singleMajorLoop = FALSE;
+
+	/*The descriptor of each step is followed by the one of the next behavior, and the last one by the
+	 * first one, so the sequence repeats for ever*/
+	for(state = FIRST_SEQUENCE; state < SEQUENCES; state++){
+		sequenceLength[state] = MOTORCONTROL_sequenceSteps(state);
+		for(step = 0; step < sequenceLength[state]; step++){
+			next = (step == sequenceLength[state] - 1)?(0):(step + 1);
+			stepConfig.sourceAddress = &sequenceSteps[state][step];
+			DMA_descriptorConfig(&sequenceChains[state][step],&stepConfig,&sequenceChains[state][next]);
+		}
+	}
+}
+
+static uint16 MOTORCONTROL_rampTo(uint8 level){
+	uint16 current = FTM_readDuty(MOTOR_FTM,MOTOR_CHANNEL);
+	uint16 target = MOTOR_DUTY_COUNTS(level);
+	uint8 ramp = (target > current)?(ACCELERATION_RAMP):(DECELERATION_RAMP);
+	uint16 entries = 100*periodsPerPercent[ramp];
+	uint16 last = level*periodsPerPercent[ramp];
+	uint16 first;
+	uint16 periods;
+	sint8 direction;
+	DMA_TransferConfigType rampConfig;
+
+	/*A ramp in progress stops where it is, and the new one starts from there*/
+	DMA_requestDisable(MOTOR_RAMP_DMA);
+	targetLevel = level;
+	if(target == current || entries == 0){
+		FTM_fastSetDuty(MOTOR_FTM,MOTOR_CHANNEL,target);
+		return 0;
+	}
+
+	/*First entry of the table after the current duty, in the direction of the ramp*/
+	first = (uint16)(((uint32)current*entries)/periodCounts);
+	if(ramp == ACCELERATION_RAMP){
+		first++;
+		direction = 1;
+		periods = last - first + 1;
+	} else {
+		if(rampTables[ramp][first] == current){
+			first--;
+		}
+		direction = -1;
+		periods = first - last + 1;
+	}
+
+	/*The first duty is written here: at 100% the channel has no match, so it can't request the DMA.
+	 * Then each match loads the duty of the next period, until the last one, and the DMA requests
+	 * are disabled*/
+	FTM_fastSetDuty(MOTOR_FTM,MOTOR_CHANNEL,rampTables[ramp][first]);
+	if(periods > 1){
+		rampConfig.sourceAddress = &rampTables[ramp][first + direction];
+		rampConfig.destinationAddress = FTM_dutyRegister(MOTOR_FTM,MOTOR_CHANNEL);
+		rampConfig.sourceOffset = direction*(sint16)sizeof(uint16);
+		rampConfig.destinationOffset = 0;
+		rampConfig.transferSize = DMA_TRANSFER_16BIT;
+		rampConfig.bytesPerRequest = sizeof(uint16);
+		rampConfig.majorLoopCount = periods - 1;
+		rampConfig.sourceLastAdjust = 0;
+		rampConfig.destinationLastAdjust = 0;
+		rampConfig.singleMajorLoop = TRUE;
+		DMA_channelConfig(MOTOR_RAMP_DMA,&rampConfig);
+		/*A match of a previous period doesn't start the ramp*/
+		FTM_clearChannelFlag(MOTOR_FTM,MOTOR_CHANNEL);
+		DMA_requestEnable(MOTOR_RAMP_DMA);
+	}
+	return periods;
+}
+
+static void MOTORCONTROL_controlStart(sint32 output){
+	/*The controller starts from the current duty; The first step only measures the speed, and the
+	 * reference starts from it, so the loop starts without a bump even if the motor is moving*/
+	if(controlRunning == FALSE){
+		controlRunning = TRUE;
+		speedUnknown = TRUE;
+		controlOutput = output;
+		lastEncoderCount = FTM_readCounter(MOTOR_ENCODER);
+		MOTORCONTROL_busClockUpdate();
+		PIT_timerEnable(CONTROL_PIT);
+	}
+}
+
+static void MOTORCONTROL_controlStop(){
+	/*The duty is left as it is*/
+	PIT_timerDisable(CONTROL_PIT);
+	controlRunning = FALSE;
+	MOTORCONTROL_busClockUpdate();
+}
+
+static void MOTORCONTROL_controlFromDuty(){
+	/*The controller starts from the current duty, where a ramp or a sequence of the DMA left it; With
+	 * the motor off, it only runs to finish the stop*/
+	sint32 output = (sint32)(((uint32)FTM_readDuty(MOTOR_FTM,MOTOR_CHANNEL) << 15)/periodCounts);
+
+	targetSpeed = RPM_TO_SPEED(targetRpm);
+	if(targetRpm || output){
+		MOTORCONTROL_controlStart((output > OUTPUT_FULL)?(OUTPUT_FULL):(output));
+	}
+}
+
+static void MOTORCONTROL_sequenceStart(uint8 state){
+	uint8 last = sequenceLength[state] - 1;
+	uint32 basePri = MOTORCONTROL_lock();
+
+	/*The chain in use, the program, the control loop and a ramp stop; The scheduler leaves the PIT3
+	 * with its single motor. The duty of the first behavior is written here, and its period starts;
+	 * The load value of the second behavior is taken when it expires, and that expiry runs the
+	 * descriptor of the second step. The sequence goes on without the CPU*/
+	DMA_requestDisable(SEQUENCE_DMA);
+	DMA_requestDisable(MOTOR_RAMP_DMA);
+	MOTORSCHEDULER_stop(&MAIN_MOTOR->program);
+	PIT_timerDisable(SEQUENCE_PIT);
+	MOTORCONTROL_controlStop();
+	controlOutput = 0;
+	FTM_fastSetDuty(MOTOR_FTM,MOTOR_CHANNEL,(uint16)sequenceSteps[state][0].duty);
+	PIT_loadTicks(SEQUENCE_PIT,sequenceSteps[state][last].nextTicks);
+	PIT_timerEnable(SEQUENCE_PIT);
+	PIT_fastLoadTicks(SEQUENCE_PIT,sequenceSteps[state][0].nextTicks);
+	DMA_loadDescriptor(SEQUENCE_DMA,&sequenceChains[state][(last)?(1):(0)]);
+	sequenceRunning = TRUE;
+	MOTORCONTROL_busClockUpdate();
+	DMA_requestEnable(SEQUENCE_DMA);
+	__set_BASEPRI(basePri);
+}
+
+static void MOTORCONTROL_sequenceStop(){
+	/*The duty of the behavior in progress is left as it is; The PIT3 is left to the scheduler*/
+	DMA_requestDisable(SEQUENCE_DMA);
+	if(sequenceRunning){
+		PIT_timerDisable(SEQUENCE_PIT);
+	}
+	sequenceRunning = FALSE;
+	MOTORCONTROL_busClockUpdate();
+}
+
+static void MOTORCONTROL_sequenceEnd(){
+	/*The motor goes on from the duty of the behavior in progress, with the selected loop: the
+	 * controller starts from it, or the next ramp*/
+	MOTORCONTROL_sequenceStop();
+	targetRpm = MOTOR_OFF;
+	targetSpeed = 0;
+	if(closedLoop){
+		MOTORCONTROL_controlFromDuty();
+	}
+}
+
+void MOTORCONTROL_controlLoop(){
+	uint16 encoderCount = FTM_readCounter(MOTOR_ENCODER);
+	uint32 basePri;
+
+	/*Speed: encoder edges since the previous step, with the direction; The counter wraps around*/
+	measuredSpeed = (sint32)(sint16)(encoderCount - lastEncoderCount) << 8;
+	lastEncoderCount = encoderCount;
+	if(speedUnknown){
+		speedUnknown = FALSE;
+		speedReference = measuredSpeed;
+		PID_reset(&speedController,measuredSpeed,controlOutput);
+	}
+
+	/*The reference moves a step of the ramp towards the speed of the behavior*/
+	if(speedReference < targetSpeed){
+		speedReference += referenceSteps[ACCELERATION_RAMP];
+		if(speedReference > targetSpeed){
+			speedReference = targetSpeed;
+		}
+	} else if(speedReference > targetSpeed){
+		speedReference -= referenceSteps[DECELERATION_RAMP];
+		if(speedReference < targetSpeed){
+			speedReference = targetSpeed;
+		}
+	}
+
+	/*The new duty is taken by the FTM at the end of the current PWM period*/
+	controlOutput = PID_update(&speedController,speedReference,measuredSpeed);
+	FTM_fastSetDuty(MOTOR_FTM,MOTOR_CHANNEL,OUTPUT_TO_DUTY(controlOutput));
+
+	/*With the motor off, the loop stops when the duty reaches 0, and the motor coasts; A new behavior
+	 * (from the timer wheel) can't come in between*/
+	if(speedReference == 0 && controlOutput == 0){
+		basePri = MOTORCONTROL_lock();
+		if(targetSpeed == 0){
+			MOTORCONTROL_controlStop();
+		}
+		__set_BASEPRI(basePri);
+	}
+}
+
+static void MOTORCONTROL_setSpeed(uint16 rpm){
+	/*The controller, or the open loop ramps, take the motor to the speed*/
+	targetRpm = rpm;
+	if(closedLoop){
+		targetSpeed = RPM_TO_SPEED(rpm);
+		if(rpm || controlOutput){
+			MOTORCONTROL_controlStart(controlOutput);
+		}
+	} else {
+		MOTORCONTROL_rampTo(SPEED_LEVEL(rpm));
+	}
+}
+
+static void MOTORCONTROL_setDuty(uint32 duty){
+	/*The duty is written at once, in both loops: a ramp and the control loop stop. The next speed
+	 * starts from it*/
+	if(duty > OUTPUT_FULL){
+		duty = OUTPUT_FULL;
+	}
+	DMA_requestDisable(MOTOR_RAMP_DMA);
+	MOTORCONTROL_controlStop();
+	controlOutput = (sint32)duty;
+	targetRpm = MOTOR_OFF;
+	targetSpeed = 0;
+	targetLevel = (uint8)((duty*100 + (OUTPUT_FULL >> 1)) >> 15);
+	FTM_fastSetDuty(MOTOR_FTM,MOTOR_CHANNEL,OUTPUT_TO_DUTY(duty));
+}
+
+static void MOTORCONTROL_auxiliaryDuty(MOTORCONTROL_MotorType* motor){
+	uint32 mask = (uint32)1 << (motor - motors);
+
+	/*The duty is written at once, in open loop*/
+	FTM_fastSetDuty(MOTOR_FTM,motor->config->channel,OUTPUT_TO_DUTY(motor->duty));
+	if(motor->duty){
+		auxiliaryOutputs |= mask;
+	} else {
+		auxiliaryOutputs &= ~mask;
+	}
+	MOTORCONTROL_busClockUpdate();
+}
+
+static void MOTORCONTROL_mainOutput(MOTORSCHEDULER_MotorType* program, MOTORPROGRAM_InstructionType output){
+	if(MOTORPROGRAM_OPCODE(output) == MOTORPROGRAM_OP_SET_OUTPUT){
+		MOTORCONTROL_setSpeed((uint16)MOTORPROGRAM_OPERAND(output));
+	} else {
+		MOTORCONTROL_setDuty(MOTORPROGRAM_OPERAND(output));
+	}
+}
+
+static void MOTORCONTROL_auxiliaryOutput(MOTORSCHEDULER_MotorType* program, MOTORPROGRAM_InstructionType output){
+	MOTORCONTROL_MotorType* motor = (MOTORCONTROL_MotorType*)program;
+	uint32 duty = MOTORPROGRAM_OPERAND(output);
+
+	/*A speed is given as its duty, as in the open loop of the main motor*/
+	if(MOTORPROGRAM_OPCODE(output) == MOTORPROGRAM_OP_SET_OUTPUT){
+		duty = (duty*OUTPUT_FULL)/MOTORCONTROL_MAX_RPM;
+	}
+	motor->duty = (uint16)((duty > OUTPUT_FULL)?(OUTPUT_FULL):(duty));
+	MOTORCONTROL_auxiliaryDuty(motor);
+}
+
+static void MOTORCONTROL_clockChanged(){
+	uint32 basePri = MOTORCONTROL_lock();
+	uint8 motor;
+
+	/*The PWM keeps its frequency with the new bus clock; A ramp in progress ends at once, as its table
+	 * is computed again with the new period. The control loop keeps its rate from its next period,
+	 * a sequence of the DMA starts again from its first behavior with its new steps, and the duties of
+	 * the auxiliary motors are written again; The scheduler takes its waits with the new clock*/
+	DMA_requestDisable(MOTOR_RAMP_DMA);
+	DMA_requestDisable(SEQUENCE_DMA);
+	periodCounts = MOTOR_PERIOD_COUNTS;
+	FTM_setModulo(MOTOR_FTM,periodCounts - 1);
+	MOTORCONTROL_rampTablesInit();
+	MOTORCONTROL_sequencesCompile();
+	PIT_loadTicks(CONTROL_PIT,CONTROL_TICKS);
+	for(motor = MOTORCONTROL_MAIN_MOTOR + 1; motor < MOTORCONTROL_MOTORS; motor++){
+		MOTORCONTROL_auxiliaryDuty(&motors[motor]);
+	}
+	if(sequenceRunning){
+		MOTORCONTROL_sequenceStart(MAIN_MOTOR->currentState);
+	} else {
+		FTM_fastSetDuty(MOTOR_FTM,MOTOR_CHANNEL,(closedLoop)?(OUTPUT_TO_DUTY(controlOutput)):(MOTOR_DUTY_COUNTS(targetLevel)));
+	}
+	__set_BASEPRI(basePri);
+}
+
+static void MOTORCONTROL_stopRampEnd(){
+	/*The stop ramp of the open loop ended*/
+	MOTORCONTROL_behaviorChange(MOTORCONTROL_MAIN_MOTOR);
+}
 
 void MOTORCONTROL_init(){
+	uint8 motor;
+
+	/*SW2 presses are attended in the main loop, masking the same interruptions as PORTC_IRQHandler*/
+	EVENTQUEUE_setHandler(EVENTQUEUE_SW2,MOTORCONTROL_switchPressed,PRIORITY_9);
+
+	/*The stop timer of the open loop ends the ramp to 0*/
+	TIMERWHEEL_timerInit(&behaviorTimer,MOTORCONTROL_stopRampEnd);
+
+	/*PWM of the motor, with a duty of 0; Each match of the channel requests the ramp DMA channel*/
+	periodCounts = MOTOR_PERIOD_COUNTS;
+	FTM_pwmInit(MOTOR_FTM,FTM_PRESCALER_1,periodCounts - 1);
+	FTM_pwmChannelInit(MOTOR_FTM,MOTOR_CHANNEL,TRUE);
+	DMA_requestDisable(MOTOR_RAMP_DMA);
+	DMA_muxConfig(MOTOR_RAMP_DMA,FTM_DMA_SOURCE_FTM0_CH0 + MOTOR_CHANNEL,FALSE);
+	/*The ramps given at build time; Out of range, they are left at 0, and the speed changes at once*/
+	MOTORCONTROL_rampTablesInit();
+	MOTORCONTROL_setRamps(MOTORCONTROL_ACCELERATION_MS,MOTORCONTROL_DECELERATION_MS);
+
+	/*Encoder decoder, and the control loop on the PIT channel 1; It is started by the first behavior
+	 * with a speed*/
+	FTM_quadratureInit(MOTOR_ENCODER);
+	PID_init(&speedController,CONTROL_KP,CONTROL_KI,CONTROL_KD,0,OUTPUT_FULL);
+	PROFILER_BENCHMARK("PID_update",PID_BENCHMARK_UPDATES,PID_benchmark());
+	PIT_enable();
+	PIT_loadTicks(CONTROL_PIT,CONTROL_TICKS);
+	PIT_timerInterruptEnable(CONTROL_PIT);
+
+	/*Programs: each motor has its context in the scheduler, and the auxiliary motors their PWM
+	 * channels, with a duty of 0. DMA sequence mode: the PIT3 periods request the DMA channel 3,
+	 * without interruptions*/
+	for(motor = MOTORCONTROL_MAIN_MOTOR; motor < MOTORCONTROL_MOTORS; motor++){
+		motors[motor].config = &motorConfigs[motor];
+		motors[motor].currentState = NULL_SEQUENCE;
+		motors[motor].duty = 0;
+		if(motor == MOTORCONTROL_MAIN_MOTOR){
+			MOTORSCHEDULER_motorInit(&motors[motor].program,MOTORCONTROL_mainOutput);
+		} else {
+			MOTORSCHEDULER_motorInit(&motors[motor].program,MOTORCONTROL_auxiliaryOutput);
+			FTM_pwmChannelInit(MOTOR_FTM,motorConfigs[motor].channel,FALSE);
+		}
+	}
+	DMA_requestDisable(SEQUENCE_DMA);
+	DMA_muxConfig(SEQUENCE_DMA,DMA_SOURCE_ALWAYS_ENABLED_2,TRUE);
+	MOTORCONTROL_sequencesCompile();
 
-	/*Set the configuration needed to use SW2*/
-	GPIO_pinControlRegisterType pinControlRegisterPORTC = GPIO_MUX1|GPIO_PS|GPIO_PE|INTR_FALLING_EDGE;
-	/*Sets PORT C pin 6, with the functionality of MUX_1, as a pull up resistor, pull enabled
-	 * and the interruption is activated with a falling edge*/
-	GPIO_pinControlRegister(GPIOC,BIT6,&pinControlRegisterPORTC);
-	/*Sets PORT C pin 6 as an input (SW2)*/
-	GPIO_dataDirectionPIN(GPIOC,GPIO_INPUT,BIT6);
-
-	/*Sets the configuration for PORT C pins 16 and 17, and PORT B pin 19*/
-	GPIO_pinControlRegisterType pinControlRegisterPORTBC = GPIO_MUX1;
-	/*Sets PORT C pins 16 and 17, and PORT B pin 19 with the functionality MUX_1*/
-	GPIO_pinControlRegister(GPIOC,BIT16,&pinControlRegisterPORTBC);
-	GPIO_pinControlRegister(GPIOC,BIT17,&pinControlRegisterPORTBC);
-	GPIO_pinControlRegister(GPIOB,BIT9,&pinControlRegisterPORTBC);
-	/*Puts a "safe" value for PORT C pins 16 and 17, and PORT B pin 19*/
-	GPIO_clearPIN(GPIOC,BIT16);
-	GPIO_clearPIN(GPIOC,BIT17);
-	GPIO_clearPIN(GPIOB,BIT9);
-	/*Sets PORT C pins 16 and 17, and PORT B pin 19 as outputs*/
-	GPIO_dataDirectionPIN(GPIOC,GPIO_OUTPUT,BIT16);
-	GPIO_dataDirectionPIN(GPIOC,GPIO_OUTPUT,BIT17);
-	GPIO_dataDirectionPIN(GPIOB,GPIO_OUTPUT,BIT9);
-
-	/*Sets the PIT channel 1 interruption, a priority of 8, but doesn't enable the interruption*/
-	NVIC_SetPriority(PIT_CH1_IRQ, PRIORITY_10);
-	/*Sets the PORT C interruption, a priority of 7, but doesn't enable the interruption*/
-	NVIC_SetPriority(PORTC_IRQ, PRIORITY_9);
-	/*Enables the PIT clock Gating*/
-	PIT_clockGating();
+	/*The PWM period, the ramps, the control period and the sequence steps are computed again after each
+	 * bus clock change*/
+	CLOCKMANAGER_addListener(MOTORCONTROL_clockChanged);
+	/*The SW2, LED1, LED2, motor and encoder pins, the FTM0 and FTM1 clock gating, and the PORTC and
+	 * PIT1 interruption priorities, are configured by BOARDCONFIG_init; The scheduler is initialized
+	 * by the main*/
+}
+
+void MOTORCONTROL_setClosedLoop(BooleanType closed){
+	uint32 basePri = MOTORCONTROL_lock();
+
+	if(sequenceRunning){
+		/*The sequence of the DMA goes on; The loop is selected for when it ends*/
+		closedLoop = closed;
+	} else if(closed && closedLoop == FALSE){
+		/*The controller starts from the duty of the open loop, where its ramp is*/
+		DMA_requestDisable(MOTOR_RAMP_DMA);
+		closedLoop = TRUE;
+		MOTORCONTROL_controlFromDuty();
+	} else if(closed == FALSE && closedLoop){
+		/*The duty ramps from the output of the controller*/
+		MOTORCONTROL_controlStop();
+		controlOutput = 0;
+		closedLoop = FALSE;
+		MOTORCONTROL_rampTo(SPEED_LEVEL(targetRpm));
+	}
+	__set_BASEPRI(basePri);
+}
+
+void MOTORCONTROL_setDmaSequence(BooleanType enabled){
+	uint32 basePri = MOTORCONTROL_lock();
+
+	/*A sequence in progress starts again from its first behavior, in the new mode*/
+	if(enabled != dmaSequence){
+		dmaSequence = enabled;
+		if(MAIN_MOTOR->currentState != NULL_SEQUENCE){
+			MOTORCONTROL_behaviorChange(MOTORCONTROL_MAIN_MOTOR);
+		}
+	}
+	__set_BASEPRI(basePri);
+}
+
+BooleanType MOTORCONTROL_setRamps(uint16 accelerationMs, uint16 decelerationMs){
+	uint32 basePri;
+
+	if(accelerationMs > MOTORCONTROL_RAMP_MAX_MS || decelerationMs > MOTORCONTROL_RAMP_MAX_MS){
+		return FALSE;
+	}
+	/*The tables aren't used while they change: the ramp in progress of the open loop ends at its duty
+	 * level*/
+	basePri = MOTORCONTROL_lock();
+	if(closedLoop == FALSE){
+		DMA_requestDisable(MOTOR_RAMP_DMA);
+		FTM_fastSetDuty(MOTOR_FTM,MOTOR_CHANNEL,MOTOR_DUTY_COUNTS(targetLevel));
+	}
+	rampMilliseconds[ACCELERATION_RAMP] = accelerationMs;
+	rampMilliseconds[DECELERATION_RAMP] = decelerationMs;
+	MOTORCONTROL_rampTablesInit();
+	__set_BASEPRI(basePri);
+	return TRUE;
 }
 
 void MOTORCONTROL_enable(){
-	/*Enables the PIT*/
-	PIT_enable();
-	/*Enable the timer PIT channel 1*/
-	PIT_timerEnable(PIT_1);
+	uint8 motor;
+
 	/*Enables the interruption in PORT C; Before this, the SW2 wasn't take on account*/
 	NVIC_EnableIRQ(PORTC_IRQ);
-	/*Sets as current State, the NULL_sequence, so when the SW2 is pressed, and it actually starts to
-	 * produce the motor output, currentState is FIRST_SEQUENCE*/
-	currentState = NULL_SEQUENCE;
-	/*Enables the PIT timer interrupt for channel 1*/
-	PIT_timerInterruptEnable(PIT_1);
+	/*Sets as current State of each motor, the NULL_sequence, so when the SW2 is pressed, and it
+	 * actually starts to produce the motor outputs, currentState is FIRST_SEQUENCE*/
+	for(motor = MOTORCONTROL_MAIN_MOTOR; motor < MOTORCONTROL_MOTORS; motor++){
+		motors[motor].currentState = NULL_SEQUENCE;
+	}
 	/*RGB red led, is on*/
 	GPIO_clearPIN(GPIOB,BIT22); //LED RGB ROJO
 }
 
 void MOTORCONTROL_disable(){
-	/*Disable MOTOR*/
-	GPIO_clearPIN(GPIOB,BIT9);
-	/*Disable the PIT channel 1 interruption*/
-	NVIC_DisableIRQ(PIT_CH1_IRQ);
+	uint8 motor;
+
+	/*Disable the MOTORS at once, without the deceleration ramp nor the controller*/
+	for(motor = MOTORCONTROL_MAIN_MOTOR; motor < MOTORCONTROL_MOTORS; motor++){
+		MOTORSCHEDULER_stop(&motors[motor].program);
+		motors[motor].currentState = NULL_SEQUENCE;
+		/*Verifies that the LEDs corresponding to this motor, are off*/
+		GPIO_clearPINS(GPIOC,motorConfigs[motor].led1Mask|motorConfigs[motor].led2Mask);
+		if(motor != MOTORCONTROL_MAIN_MOTOR){
+			motors[motor].duty = 0;
+			MOTORCONTROL_auxiliaryDuty(&motors[motor]);
+		}
+	}
+	DMA_requestDisable(MOTOR_RAMP_DMA);
+	MOTORCONTROL_sequenceStop();
+	MOTORCONTROL_controlStop();
+	targetRpm = MOTOR_OFF;
+	targetSpeed = 0;
+	targetLevel = 0;
+	controlOutput = 0;
+	FTM_fastSetDuty(MOTOR_FTM,MOTOR_CHANNEL,0);
+	/*Stops the stop timer; The next SW2 press after MOTORCONTROL_enable starts the first
+	 * sequence*/
+	TIMERWHEEL_stop(&behaviorTimer);
 	/*Disable the PORT C interruption*/
 	NVIC_DisableIRQ(PORTC_IRQ);
 	/*RGB red led, is off*/
 	GPIO_setPIN(GPIOB,BIT22); //LED RGB ROJO
-	/*Verifies that the LEDs corresponding to this process, are off*/
-	GPIO_clearPIN(GPIOC,BIT16); //LED1
-	GPIO_clearPIN(GPIOC,BIT17); //LED2
 
 }
 
 void MOTORCONTROL_changeSequence(){
-	/*currentState, is now changed to nextState*/
-	currentState = motorConState[currentState].nextState;
-	/*invokes the function that "updates" the LEDS state*/
-	motorConState[currentState].fptrLedOutput();
-	/*Enables PIT channel 1 interruptions*/
-	NVIC_EnableIRQ(PIT_CH1_IRQ);
-	/*index, begins at 0*/
-	behaviorIndex = 0;
-	/*begins to change the behavior of motor control*/
-	MOTORCONTROL_behaviorChange();
-}
-
-void MOTORCONTROL_ledSequence(){
-	/*As there are 3 fixed states for LEDs, those 3 states are covered in the following
-	 * sentences*/
-	/*If both LEDs are supposed to be on, they are set on */
-	if( ( motorConState[currentState].LED1_state == BIT_ON ) && ( motorConState[currentState].LED2_state == BIT_ON ) ){
-		GPIO_setPIN(GPIOC,BIT16); //LED1
-		GPIO_setPIN(GPIOC,BIT17); //LED2
-	/*If LED1 is supposed to be on, and LED2 is supposed to be off, we configure that way*/
-	} else if ( ( motorConState[currentState].LED1_state == BIT_ON ) && ( motorConState[currentState].LED2_state == BIT_OFF) ){
-		GPIO_setPIN(GPIOC,BIT16); //LED1
-		GPIO_clearPIN(GPIOC,BIT17); //LED2
-	/*Finally, the last case we can have, is when LED1 is off, and LED2 is on*/
-	} else {
-		GPIO_clearPIN(GPIOC,BIT16); //LED1
-		GPIO_setPIN(GPIOC,BIT17); //LED2
+	uint8 motor;
+
+	/*All the motors change their sequence at once*/
+	for(motor = MOTORCONTROL_MAIN_MOTOR; motor < MOTORCONTROL_MOTORS; motor++){
+		/*currentState, is now changed to nextState*/
+		motors[motor].currentState = motorConState[motors[motor].currentState].nextState;
+		/*invokes the function that "updates" the LEDS state*/
+		motorConState[motors[motor].currentState].fptrLedOutput(motor);
+		/*begins to change the behavior of motor control*/
+		MOTORCONTROL_behaviorChange(motor);
 	}
 }
 
-void MOTORCONTROL_behaviorChange(){
-	/*If the currentState is NULL_SEQUENCE, the motor is Off*/
-	if(currentState == NULL_SEQUENCE){
-		GPIO_clearPIN(GPIOB,BIT9);
+void MOTORCONTROL_ledSequence(uint8 motor){
+	const MOTORCONTROL_MotorConfigType* config = &motorConfigs[motor];
+	uint8 currentState = motors[motor].currentState;
+
+	/*Both LEDs are updated at once: the ones that must be on are set, and the other ones are
+	 * cleared*/
+	GPIO_writePINS(GPIOC,config->led1Mask|config->led2Mask,
+			((motorConState[currentState].LED1_state == BIT_ON)?(config->led1Mask):(0)) |
+			((motorConState[currentState].LED2_state == BIT_ON)?(config->led2Mask):(0)));
+}
+
+void MOTORCONTROL_behaviorChange(uint8 motor){
+	uint8 currentState = motors[motor].currentState;
+	uint16 rampPeriods;
+
+#if MOTORCONTROL_MOTORS > 1
+	/*An auxiliary motor runs the program of its sequence, from its first instruction; With the
+	 * NULL_SEQUENCE, it stops at once*/
+	if(motor != MOTORCONTROL_MAIN_MOTOR){
+		if(currentState == NULL_SEQUENCE){
+			MOTORSCHEDULER_stop(&motors[motor].program);
+			motors[motor].duty = 0;
+			MOTORCONTROL_auxiliaryDuty(&motors[motor]);
+		} else {
+			MOTORSCHEDULER_start(&motors[motor].program,motorConfigs[motor].programs[currentState]);
+		}
 		return;
 	}
+#endif
 
-	/*If the currentState is FIRST_SEQUENCE or SECOND_SEQUENCE, the PIT delay is taken from
-	 * the array and the index behavior*/
-	//uint8 temp_debug_currentBehaviorDuration = *(motorConState[currentState].currentBehaviorAndDuration + 1 + behaviorIndex*2);
-	//uint8 temp_debug_currentBehavior = *(motorConState[currentState].currentBehaviorAndDuration + behaviorIndex*2);
-	PIT_delay(PIT_1,SYSTEM_CLOCK,2*(*(motorConState[currentState].currentBehaviorAndDuration + 2*behaviorIndex + 1)));
+	/*If the currentState is NULL_SEQUENCE, the motor is Off; It stops with the deceleration ramp. In
+	 * the closed loop, the control loop runs until the motor stops; In the open loop, the timer runs
+	 * until the ramp ends, as the FTM and the DMA need the bus clock*/
+	if(currentState == NULL_SEQUENCE){
+		MOTORSCHEDULER_stop(&MAIN_MOTOR->program);
+		if(sequenceRunning){
+			MOTORCONTROL_sequenceEnd();
+		}
+		if(closedLoop){
+			MOTORCONTROL_setSpeed(MOTOR_OFF);
+			TIMERWHEEL_stop(&behaviorTimer);
+			return;
+		}
+		targetRpm = MOTOR_OFF;
+		rampPeriods = MOTORCONTROL_rampTo(SPEED_LEVEL(MOTOR_OFF));
+		if(rampPeriods){
+			TIMERWHEEL_start(&behaviorTimer,RAMP_MS(rampPeriods),FALSE);
+		} else {
+			TIMERWHEEL_stop(&behaviorTimer);
+		}
+		return;
+	}
 
-	/*If the current behavior is ON, the motor is ON, otherwise, is OFF*/
-	if(*(motorConState[currentState].currentBehaviorAndDuration + 2*behaviorIndex) == MOTOR_ON){
-		GPIO_setPIN(GPIOB,BIT9);
-	} else {
-		GPIO_clearPIN(GPIOB,BIT9);
+	/*In the DMA sequence mode, with a single motor, the whole sequence is run by the DMA, if its
+	 * program can be compiled to a chain; A change of sequence swaps the chain at once*/
+	TIMERWHEEL_stop(&behaviorTimer);
+	if(dmaSequence && MOTORCONTROL_MOTORS == 1 && sequenceLength[currentState]){
+		MOTORCONTROL_sequenceStart(currentState);
+		return;
 	}
 
-	/*Ensures that the behavior index is shifted, but never beyond the number of behaviors
-	 * of the current state*/
-	if(behaviorIndex == (motorConState[currentState].numberOfBehaviors - 1)){
-		behaviorIndex = 0;
-	} else {
-		behaviorIndex++;
+	/*Otherwise, the program of the sequence is run by the scheduler, from its first instruction; The
+	 * motor goes on from the duty where a chain of the DMA left it*/
+	if(sequenceRunning){
+		MOTORCONTROL_sequenceEnd();
 	}
+	MOTORSCHEDULER_start(&MAIN_MOTOR->program,motorConfigs[MOTORCONTROL_MAIN_MOTOR].programs[currentState]);
+}
 
+void MOTORCONTROL_switchPressed(uint8 pin){
+	/*When the SW2 is pressed, the motor sequences are changed*/
+	motorConState[MAIN_MOTOR->currentState].fptrMotorOutput();
 }
 
 void PORTC_IRQHandler(){
-	/*When the SW2 is pressed, the motor sequence is changed*/
-	motorConState[currentState].fptrMotorOutput();
+	PROFILER_START(PROFILER_PORTC);
+	/*The press is attended in the main loop (MOTORCONTROL_switchPressed), if the edge isn't a bounce*/
+	if(GPIO_debounceAccept(GPIOC,BIT6)){
+		EVENTQUEUE_push(EVENTQUEUE_SW2,BIT6);
+	}
 	/*Clears interrupt flags for PORT C*/
 	GPIO_clearInterrupt(GPIOC);
-	/*digital delay*/
-	delay(30000);
-
+	PROFILER_STOP(PROFILER_PORTC);
 }
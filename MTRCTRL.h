@@ -3,7 +3,26 @@
 	\brief
 		This is the header file for a DC MOTOR process, which has a programmer defined
 		behavior, using state machines. It uses different interruptions, and "depends"
-		from other processes.
+		from other processes. The motors are driven by PWM outputs of the FTM0, and each
+		sequence of a motor is a motor program (MTRPRG.h): speeds in RPM or duties, and
+		waits with a resolution of 1us. The programs of all the motors are run by the motor
+		scheduler (MTRSCH.h), from the PIT3 interruption, a segment per deadline.
+		The main motor (MOTORCONTROL_MAIN_MOTOR) has the encoder: in the closed loop (the
+		default), its speed is measured with a quadrature encoder on the FTM1 decoder, and a
+		fixed point PID controller (PID.h) adjusts the duty at MOTORCONTROL_CONTROL_HZ, in
+		the PIT1 interruption, to hold the speed of the behavior; The reference of the
+		controller follows the acceleration and deceleration ramps. In the open loop, the
+		duty of a behavior is its speed over MOTORCONTROL_MAX_RPM, and the changes of duty
+		follow the ramps, loaded period by period by the DMA, without the CPU. The auxiliary
+		motors (MOTORCONTROL_MOTORS > 1) are driven in open loop, with the duty of each
+		output written at once. The SW2 changes the sequence of all the motors.
+		In the DMA sequence mode, with a single motor, each program made of speeds and
+		waits, that repeats with a JUMP to its start, is compiled into a ring of DMA
+		descriptors, one per wait: each expiry of the PIT3 makes the DMA write the duty of
+		the next behavior and the PIT3 load value of the one after it, and load the next
+		descriptor (scatter gather). The sequence repeats without interruptions; The duties
+		change at once, without the ramps nor the controller. The other programs are run
+		by the scheduler.
 	\author Patricio Gomez Garca
 	\date	26/09/2016
  */
@@ -12,18 +31,59 @@
 #define SOURCES_MTRCTRL_H_
 
 #include "DataTypeDefinitions.h"
-#define MOTOR_ON 0x1
-#define MOTOR_OFF 0x0
+#include "NVIC.h"
+#include "MTRPRG.h"
 
-/*DEFINE the first behvaior duration, as the direcction of the array containing that
- * information. It points the first position of the array*/
-#define FIRST_BEHAVIOR_DURATION &firstSequenceBehaviorAndDuration[0]
-/*DEFINE the second behvaior duration, as the direcction of the array containing that
- * information. It points the first position of the array*/
-#define SECOND_BEHAVIOR_DURATION &secondSequenceBehaviorAndDuration[0]
-/*DEFINE the null behvaior duration, as the direcction of the array containing that
- * information. It points the first position of the array*/
-#define NULL_BEHAVIOR_DURATION &nullSequenceBehaviorAndDuration[0]
+/*Speed of a behavior, in RPM (0 to MOTORCONTROL_MAX_RPM)*/
+#define MOTOR_RPM(rpm) ((uint16)(rpm))
+#define MOTOR_ON MOTOR_RPM(MOTORCONTROL_MAX_RPM)
+#define MOTOR_OFF MOTOR_RPM(0)
+
+/*Highest speed of a behavior (RPM); It must be below the speed of the motor at 100% of duty, so
+ * the controller has room to hold it with load. In the open loop, it is the speed of 100%*/
+#define MOTORCONTROL_MAX_RPM 3000
+/*Lines of the encoder; The decoder counts 4 edges per line. MOTORCONTROL_MAX_RPM times the edges
+ * of a turn, times 256, must fit in 32 bits*/
+#define MOTORCONTROL_ENCODER_LINES 500
+/*Rate of the control loop (Hz)*/
+#define MOTORCONTROL_CONTROL_HZ 100
+/*Priority of the control loop (PIT1); It is below the sample path of the wave generator and the
+ * timer wheel, so a step only delays the next sample by the cost of an interruption entry*/
+#define MOTORCONTROL_CONTROL_PRIORITY PRIORITY_11
+/*Frequency of the PWM output (Hz)*/
+#define MOTORCONTROL_PWM_HZ 1000
+/*Durations of the ramps from 0 to MOTORCONTROL_MAX_RPM (acceleration) and back (deceleration)
+ * after the reset, in ms, until MOTORCONTROL_setRamps is called; A ramp between two other speeds
+ * lasts in proportion. They can be given at build time*/
+#ifndef MOTORCONTROL_ACCELERATION_MS
+#define MOTORCONTROL_ACCELERATION_MS 200
+#endif
+#ifndef MOTORCONTROL_DECELERATION_MS
+#define MOTORCONTROL_DECELERATION_MS 100
+#endif
+/*Longest ramp (ms); In the open loop, the ramps are multiples of 100 PWM periods (one period per
+ * each 1% of duty)*/
+#define MOTORCONTROL_RAMP_MAX_MS 500
+/*Loop after the reset, until MOTORCONTROL_setClosedLoop is called: TRUE for the closed loop, FALSE
+ * for the open loop (duty ramps of the DMA); It can be given at build time*/
+#ifndef MOTORCONTROL_CLOSED_LOOP
+#define MOTORCONTROL_CLOSED_LOOP TRUE
+#endif
+/*DMA sequence mode after the reset, until MOTORCONTROL_setDmaSequence is called; It can be given at
+ * build time, and it only takes effect with a single motor (MOTORCONTROL_MOTORS)*/
+#ifndef MOTORCONTROL_DMA_SEQUENCE
+#define MOTORCONTROL_DMA_SEQUENCE FALSE
+#endif
+
+/*Motors driven by the process, up to MOTORCONTROL_MAX_MOTORS (the outputs wired in the board);
+ * It can be given at build time. The DMA sequence mode needs a single motor, as the scheduler
+ * takes the PIT3*/
+#ifndef MOTORCONTROL_MOTORS
+#define MOTORCONTROL_MOTORS 1
+#endif
+#define MOTORCONTROL_MAX_MOTORS 2
+/*Motor with the encoder, the controller, the ramps and the DMA sequence mode*/
+#define MOTORCONTROL_MAIN_MOTOR 0
 
 /*enum 'sequence' that shows the sequence the state machine follows*/
 typedef enum {
@@ -34,20 +94,10 @@ typedef enum {
 
 /*Struct and Enum state machine*/
 typedef struct {
-	/*currentBehaviorAndDuration; is a pointer to the direction of the first element in the
-	 * array containing that data. Using pointers arithm, and adding a counter, we will
-	 * shift in the array. As the array contains two informations: Behavior and duration,
-	 * each time we move (with the counter) it must be from 2 in 2. So using the pointer
-	 * arith, we will get the Behavior, and by adding 1 to the direction, we will get
-	 * the duration*/
-	const uint8* currentBehaviorAndDuration;
-	/*Number of behaviors each state has, in order to move within the array, without leaving
-	 * the array*/
-	uint8 numberOfBehaviors :3;
 	/*Next state of the state machine*/
 	uint8 nextState:2;
-	/*function pointer, to the function that will 'update' the LEDs*/
-	void(*fptrLedOutput)();
+	/*function pointer, to the function that will 'update' the LEDs of a motor*/
+	void(*fptrLedOutput)(uint8 motor);
 	/*function pointer, to the function that will change the state*/
 	void(*fptrMotorOutput)();
 	/*LED1_state; state of LED1 (ON or OFF)*/
@@ -60,7 +110,66 @@ void MOTORCONTROL_init();
 void MOTORCONTROL_enable();
 void MOTORCONTROL_disable();
 void MOTORCONTROL_changeSequence();
-void MOTORCONTROL_ledSequence();
-void MOTORCONTROL_behaviorChange();
+void MOTORCONTROL_ledSequence(uint8 motor);
+void MOTORCONTROL_behaviorChange(uint8 motor);
+void MOTORCONTROL_switchPressed(uint8 pin);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function runs a step of the control loop: it measures the speed with the
+ 	 	 encoder edges since the previous step, moves the reference along the ramp, and sets
+ 	 	 the duty given by the PID controller. Its cost is constant (see PID.h). It is called
+ 	 	 from PIT1_IRQHandler, at MOTORCONTROL_CONTROL_HZ, only in the closed loop; The loop
+ 	 	 stops itself when the motor is off.
+ 	 \return void
+ */
+void MOTORCONTROL_controlLoop();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function selects the closed loop (speed control with the encoder) or the open
+ 	 	 loop (duty ramps, without the encoder). The speed of the current behavior is kept:
+ 	 	 the controller starts from the current duty, or the duty ramps from the output of
+ 	 	 the controller.
+ 	 \param[in] closed TRUE for the closed loop
+ 	 \return void
+ */
+void MOTORCONTROL_setClosedLoop(BooleanType closed);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function selects the DMA sequence mode, where the programs that can be
+ 	 	 compiled to a chain are run by the DMA, with the duty of each output, or the mode of
+ 	 	 MOTORCONTROL_setClosedLoop. It only takes effect with a single motor
+ 	 	 (MOTORCONTROL_MOTORS). A sequence in progress starts again from its start in the
+ 	 	 new mode. The SW2 press swaps
+ 	 	 the chain of descriptors at once, with the DMA requests stopped, so no step of the
+ 	 	 previous sequence is written after it; The NULL_SEQUENCE stops the chain, and the
+ 	 	 motor stops from the duty where it was, with the loop selected by
+ 	 	 MOTORCONTROL_setClosedLoop.
+ 	 \param[in] enabled TRUE for the DMA sequence mode
+ 	 \return void
+ */
+void MOTORCONTROL_setDmaSequence(BooleanType enabled);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function sets the durations of the ramps, from 0 to MOTORCONTROL_MAX_RPM and
+ 	 	 back; 0 changes the speed at once. In the open loop, they are rounded down to
+ 	 	 multiples of 100 PWM periods, and a ramp in progress ends at once; The next behavior
+ 	 	 ramps with the new durations.
+ 	 \param[in] accelerationMs Duration of the acceleration ramp (0 to MOTORCONTROL_RAMP_MAX_MS)
+ 	 \param[in] decelerationMs Duration of the deceleration ramp (0 to MOTORCONTROL_RAMP_MAX_MS)
+ 	 \return TRUE if the durations were set
+ */
+BooleanType MOTORCONTROL_setRamps(uint16 accelerationMs, uint16 decelerationMs);
 
 #endif /* SOURCES_MTRCTRL_H_ */
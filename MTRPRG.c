@@ -0,0 +1,75 @@
+/**
+	\file
+	\brief
+		This is the source file for the motor programs. It has the interpreter, that runs a
+		program by segments with a bounded cost.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "MTRPRG.h"
+#include "DataTypeDefinitions.h"
+
+void MOTORPROGRAM_start(MOTORPROGRAM_InterpreterType* interpreter, const MOTORPROGRAM_InstructionType* program){
+	interpreter->program = program;
+	interpreter->programCounter = 0;
+	interpreter->loopDepth = 0;
+	interpreter->ended = FALSE;
+}
+
+uint32 MOTORPROGRAM_next(MOTORPROGRAM_InterpreterType* interpreter, MOTORPROGRAM_SegmentType* segment){
+	MOTORPROGRAM_InstructionType instruction;
+	MOTORPROGRAM_LoopType* loop;
+	uint8 executed;
+
+	segment->outputs = 0;
+	segment->waitMicroseconds = 0;
+	for(executed = 0; executed < MOTORPROGRAM_SEGMENT_INSTRUCTIONS && interpreter->ended == FALSE; executed++){
+		instruction = interpreter->program[interpreter->programCounter++];
+		switch(MOTORPROGRAM_OPCODE(instruction)){
+		case MOTORPROGRAM_OP_SET_OUTPUT:
+		case MOTORPROGRAM_OP_SET_DUTY:
+			segment->output[segment->outputs++] = instruction;
+			break;
+		case MOTORPROGRAM_OP_WAIT:
+			segment->waitMicroseconds = MOTORPROGRAM_OPERAND(instruction);
+			if(segment->waitMicroseconds < MOTORPROGRAM_MIN_WAIT_US){
+				segment->waitMicroseconds = MOTORPROGRAM_MIN_WAIT_US;
+			}
+			return segment->waitMicroseconds;
+		case MOTORPROGRAM_OP_LOOP:
+			/*The first time a LOOP is reached, its loop starts with the repetitions left; The inner loops
+			 * end before the outer ones are reached again, so the loop of a LOOP is always the last one*/
+			if(interpreter->loopDepth == 0 || interpreter->loops[interpreter->loopDepth - 1].instruction != interpreter->programCounter - 1){
+				if(interpreter->loopDepth == MOTORPROGRAM_LOOP_DEPTH){
+					interpreter->ended = TRUE;
+					break;
+				}
+				interpreter->loops[interpreter->loopDepth].instruction = interpreter->programCounter - 1;
+				interpreter->loops[interpreter->loopDepth].remaining = MOTORPROGRAM_LOOP_REPETITIONS(instruction);
+				interpreter->loopDepth++;
+			}
+			loop = &interpreter->loops[interpreter->loopDepth - 1];
+			if(loop->remaining > 1){
+				loop->remaining--;
+				interpreter->programCounter = MOTORPROGRAM_LOOP_TARGET(instruction);
+			} else {
+				interpreter->loopDepth--;
+			}
+			break;
+		case MOTORPROGRAM_OP_JUMP:
+			interpreter->programCounter = (uint16)MOTORPROGRAM_OPERAND(instruction);
+			break;
+		default:
+			/*END, or an unknown opcode*/
+			interpreter->ended = TRUE;
+			break;
+		}
+	}
+
+	/*A segment that didn't reach a wait goes on after the shortest wait, unless the program ended*/
+	if(interpreter->ended == FALSE){
+		segment->waitMicroseconds = MOTORPROGRAM_MIN_WAIT_US;
+	}
+	return segment->waitMicroseconds;
+}
@@ -0,0 +1,127 @@
+/**
+	\file
+	\brief
+		This is the header file for the motor programs: a compact bytecode for the motor
+		sequences, and its interpreter. Each instruction is a 32 bits word, with the opcode
+		in the upper byte and a 24 bits operand:
+			- SET_OUTPUT: speed of the motor (RPM), reached with the loop of the motor control.
+			- SET_DUTY: duty of the PWM (Q15, 0 to 1.0), written at once.
+			- WAIT: time until the next instruction (us, up to 16.7s).
+			- LOOP: repeats the instructions from a target up to the LOOP itself, N times in
+			  total; The loops can be nested up to MOTORPROGRAM_LOOP_DEPTH.
+			- JUMP: goes on from a target instruction; It must not leave a loop in progress.
+			- END: stops the program.
+		The interpreter runs a program by segments: the instructions up to the next wait
+		(the outputs to set, and the wait). Each call runs at most
+		MOTORPROGRAM_SEGMENT_INSTRUCTIONS instructions, without searches, so its cost is
+		bounded whatever the length of the program (up to MOTORPROGRAM_MAX_INSTRUCTIONS); A
+		segment that doesn't reach a wait ends with MOTORPROGRAM_MIN_WAIT_US. The interpreter
+		doesn't touch the hardware: the motor scheduler (MTRSCH.h) times the waits, and
+		the motor control applies the outputs. The programs are written with the macros below, or generated by the host
+		assembler (HostSim/tools/MotorAssembler.c), that also runs them on a virtual clock.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_MTRPRG_H_
+#define SOURCES_MTRPRG_H_
+
+#include "DataTypeDefinitions.h"
+
+/*Longest program; The targets of the loops have 12 bits*/
+#define MOTORPROGRAM_MAX_INSTRUCTIONS 4096
+/*Most repetitions of a loop*/
+#define MOTORPROGRAM_MAX_REPETITIONS 4095
+/*Loops in progress at once*/
+#define MOTORPROGRAM_LOOP_DEPTH 4
+/*Most instructions run by MOTORPROGRAM_next*/
+#define MOTORPROGRAM_SEGMENT_INSTRUCTIONS 8
+/*Shortest wait (us); A segment without a wait, or a shorter wait, lasts this*/
+#define MOTORPROGRAM_MIN_WAIT_US 20
+/*Longest wait (us)*/
+#define MOTORPROGRAM_MAX_WAIT_US 0xFFFFFF
+/*Q15 duty of a percentage*/
+#define MOTORPROGRAM_DUTY_PERCENT(percent) ((uint32)(percent)*(1 << 15)/100)
+
+/*! This enumerated constant are used to select the operation of an instruction*/
+typedef enum {MOTORPROGRAM_OP_END,        /*!< Stops the program */
+			  MOTORPROGRAM_OP_SET_OUTPUT, /*!< Sets the speed (RPM) */
+			  MOTORPROGRAM_OP_SET_DUTY,   /*!< Sets the duty (Q15) */
+			  MOTORPROGRAM_OP_WAIT,       /*!< Waits (us) */
+			  MOTORPROGRAM_OP_LOOP,       /*!< Repeats from a target, N times in total */
+			  MOTORPROGRAM_OP_JUMP        /*!< Goes on from a target */
+			 }MOTORPROGRAM_OpcodeType;
+
+/*Instruction: opcode in the bits 31 to 24, and operand in the bits 23 to 0*/
+typedef uint32 MOTORPROGRAM_InstructionType;
+
+#define MOTORPROGRAM_INSTRUCTION(opcode,operand) ((MOTORPROGRAM_InstructionType)(((uint32)(opcode) << 24) | ((uint32)(operand) & 0xFFFFFF)))
+#define MOTORPROGRAM_OPCODE(instruction) ((MOTORPROGRAM_OpcodeType)((instruction) >> 24))
+#define MOTORPROGRAM_OPERAND(instruction) ((instruction) & 0xFFFFFF)
+/*Instructions*/
+#define MOTORPROGRAM_END MOTORPROGRAM_INSTRUCTION(MOTORPROGRAM_OP_END,0)
+#define MOTORPROGRAM_SET_OUTPUT(rpm) MOTORPROGRAM_INSTRUCTION(MOTORPROGRAM_OP_SET_OUTPUT,rpm)
+#define MOTORPROGRAM_SET_DUTY(duty) MOTORPROGRAM_INSTRUCTION(MOTORPROGRAM_OP_SET_DUTY,duty)
+#define MOTORPROGRAM_WAIT_US(microseconds) MOTORPROGRAM_INSTRUCTION(MOTORPROGRAM_OP_WAIT,microseconds)
+#define MOTORPROGRAM_WAIT_MS(milliseconds) MOTORPROGRAM_WAIT_US((uint32)(milliseconds)*1000)
+#define MOTORPROGRAM_LOOP(repetitions,target) MOTORPROGRAM_INSTRUCTION(MOTORPROGRAM_OP_LOOP,((uint32)(repetitions) << 12) | (target))
+#define MOTORPROGRAM_JUMP(target) MOTORPROGRAM_INSTRUCTION(MOTORPROGRAM_OP_JUMP,target)
+/*Fields of the operand of a loop*/
+#define MOTORPROGRAM_LOOP_TARGET(instruction) ((uint16)((instruction) & 0xFFF))
+#define MOTORPROGRAM_LOOP_REPETITIONS(instruction) ((uint16)(((instruction) >> 12) & 0xFFF))
+
+/*Struct that contains a loop in progress*/
+typedef struct{
+	/*instruction, index of its LOOP instruction*/
+	uint16 instruction;
+	/*remaining, repetitions left*/
+	uint16 remaining;
+}MOTORPROGRAM_LoopType;
+
+/*Struct that contains the state of the interpreter of a program*/
+typedef struct{
+	/*program, first instruction*/
+	const MOTORPROGRAM_InstructionType* program;
+	/*programCounter, index of the next instruction*/
+	uint16 programCounter;
+	/*loopDepth and loops, loops in progress, the innermost one last*/
+	uint8 loopDepth;
+	MOTORPROGRAM_LoopType loops[MOTORPROGRAM_LOOP_DEPTH];
+	/*ended, TRUE after the END*/
+	BooleanType ended;
+}MOTORPROGRAM_InterpreterType;
+
+/*Struct that contains a segment of a program*/
+typedef struct{
+	/*outputs and output, SET_OUTPUT and SET_DUTY instructions of the segment, in order*/
+	uint8 outputs;
+	MOTORPROGRAM_InstructionType output[MOTORPROGRAM_SEGMENT_INSTRUCTIONS];
+	/*waitMicroseconds, time from the outputs to the next segment; 0 if the program ended*/
+	uint32 waitMicroseconds;
+}MOTORPROGRAM_SegmentType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function starts an interpreter at the first instruction of a program
+ 	 \param[out] interpreter Interpreter
+ 	 \param[in] program Program; It must end with an END or a JUMP
+ 	 \return void
+ */
+void MOTORPROGRAM_start(MOTORPROGRAM_InterpreterType* interpreter, const MOTORPROGRAM_InstructionType* program);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function runs the next segment of a program: the instructions up to the next
+ 	 	 WAIT or END, and at most MOTORPROGRAM_SEGMENT_INSTRUCTIONS of them. Its cost is
+ 	 	 bounded, so it can be called from an interruption.
+ 	 \param[in,out] interpreter Interpreter
+ 	 \param[out] segment Outputs of the segment, and its wait
+ 	 \return Wait of the segment (us), from MOTORPROGRAM_MIN_WAIT_US; 0 if the program ended
+ */
+uint32 MOTORPROGRAM_next(MOTORPROGRAM_InterpreterType* interpreter, MOTORPROGRAM_SegmentType* segment);
+
+#endif /* SOURCES_MTRPRG_H_ */
@@ -0,0 +1,354 @@
+/**
+	\file
+	\brief
+		This is the source file for the motor scheduler. The heap is an array of pointers to
+		the running motors, where each motor is earlier than its two children, and each motor
+		keeps its position, so it is removed without searching. The time of the scheduler
+		(us) is kept at the expiries of the PIT channel 3; Between them, it is given by the
+		counter of the channel.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "MTRSCH.h"
+#include "MTRPRG.h"
+#include "PIT.h"
+#include "IDLMGR.h"
+#include "CLKMGR.h"
+#include "PRFL.h"
+#include "NVIC.h"
+#include "GlobalFunctions.h"
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*PIT channel of the scheduler*/
+#define SCHEDULER_PIT PIT_3
+/*BASEPRI value that masks the PIT channel 3 interruption*/
+#define SCHEDULER_BASEPRI ((uint32)MOTORSCHEDULER_PRIORITY << (8 - __NVIC_PRIO_BITS))
+/*Ticks of a time (us), and time of a number of ticks, with the current bus clock*/
+#define TICKS_FROM_US(microseconds) ((uint32)(((uint64)(microseconds)*ticksPerMicrosecond) >> 16))
+#define US_FROM_TICKS(ticks) ((uint32)(((uint64)(ticks) << 16)/ticksPerMicrosecond))
+/*Shortest period of the PIT channel 3, for the deadlines that are already due*/
+#define MINIMUM_TICKS TICKS_FROM_US(MOTORPROGRAM_MIN_WAIT_US)
+/*TRUE if the deadline of a motor is before the one of another one; The times wrap around*/
+#define EARLIER(motor,other) ((sint32)((motor)->deadline - (other)->deadline) < 0)
+
+/*Struct that contains a heap of motors*/
+typedef struct{
+	/*motors, the earliest one first; The children of the motor n are 2n + 1 and 2n + 2*/
+	MOTORSCHEDULER_MotorType* motors[MOTORSCHEDULER_MAX_MOTORS];
+	/*count, of running motors*/
+	uint8 count;
+}MOTORSCHEDULER_HeapType;
+
+/*Running motors*/
+static MOTORSCHEDULER_HeapType heap;
+/*Time (us) of the last expiry of the PIT channel 3*/
+static uint32 schedulerTime = 0;
+/*Current period of the PIT channel 3: the deadline where it ends, its load value, and the ticks
+ * from schedulerTime to its start*/
+static uint32 periodDeadline;
+static uint32 periodLoad;
+static uint32 periodStart;
+/*State of the PIT channel 3*/
+static BooleanType schedulerRunning = FALSE;
+/*Ticks of the PIT channel 3 per us, Q16, and the bus clock they were computed with*/
+static uint32 ticksPerMicrosecond;
+static uint32 schedulerClock;
+
+static uint32 MOTORSCHEDULER_lock(){
+	/*Masks the PIT channel 3 interruption, unless it is already masked*/
+	uint32 basePri = __get_BASEPRI();
+	if(basePri == 0 || basePri > SCHEDULER_BASEPRI){
+		__set_BASEPRI(SCHEDULER_BASEPRI);
+	}
+	return basePri;
+}
+
+static void MOTORSCHEDULER_place(MOTORSCHEDULER_HeapType* motorHeap, MOTORSCHEDULER_MotorType* motor, uint8 index){
+	motorHeap->motors[index] = motor;
+	motor->heapIndex = index;
+}
+
+static void MOTORSCHEDULER_siftUp(MOTORSCHEDULER_HeapType* motorHeap, uint8 index){
+	MOTORSCHEDULER_MotorType* motor = motorHeap->motors[index];
+	uint8 parent;
+
+	/*The parents that are later move down, and the motor takes the place of the last one*/
+	while(index){
+		parent = (index - 1) >> 1;
+		if(!EARLIER(motor,motorHeap->motors[parent])){
+			break;
+		}
+		MOTORSCHEDULER_place(motorHeap,motorHeap->motors[parent],index);
+		index = parent;
+	}
+	MOTORSCHEDULER_place(motorHeap,motor,index);
+}
+
+static void MOTORSCHEDULER_siftDown(MOTORSCHEDULER_HeapType* motorHeap, uint8 index){
+	MOTORSCHEDULER_MotorType* motor = motorHeap->motors[index];
+	uint8 child;
+
+	/*The earliest child moves up while it is earlier than the motor*/
+	for(;;){
+		child = 2*index + 1;
+		if(child >= motorHeap->count){
+			break;
+		}
+		if(child + 1 < motorHeap->count && EARLIER(motorHeap->motors[child + 1],motorHeap->motors[child])){
+			child++;
+		}
+		if(!EARLIER(motorHeap->motors[child],motor)){
+			break;
+		}
+		MOTORSCHEDULER_place(motorHeap,motorHeap->motors[child],index);
+		index = child;
+	}
+	MOTORSCHEDULER_place(motorHeap,motor,index);
+}
+
+static void MOTORSCHEDULER_push(MOTORSCHEDULER_HeapType* motorHeap, MOTORSCHEDULER_MotorType* motor){
+	MOTORSCHEDULER_place(motorHeap,motor,motorHeap->count);
+	motorHeap->count++;
+	MOTORSCHEDULER_siftUp(motorHeap,motor->heapIndex);
+}
+
+static void MOTORSCHEDULER_remove(MOTORSCHEDULER_HeapType* motorHeap, MOTORSCHEDULER_MotorType* motor){
+	MOTORSCHEDULER_MotorType* last;
+	uint8 index = motor->heapIndex;
+
+	/*The last motor takes the place, and moves up or down from it*/
+	motor->heapIndex = MOTORSCHEDULER_IDLE;
+	motorHeap->count--;
+	if(index < motorHeap->count){
+		last = motorHeap->motors[motorHeap->count];
+		MOTORSCHEDULER_place(motorHeap,last,index);
+		MOTORSCHEDULER_siftDown(motorHeap,index);
+		MOTORSCHEDULER_siftUp(motorHeap,last->heapIndex);
+	}
+}
+
+static void MOTORSCHEDULER_apply(MOTORSCHEDULER_MotorType* motor, const MOTORPROGRAM_SegmentType* segment){
+	uint8 output;
+
+	for(output = 0; output < segment->outputs; output++){
+		motor->fptrOutput(motor,segment->output[output]);
+	}
+}
+
+static uint8 MOTORSCHEDULER_run(MOTORSCHEDULER_HeapType* motorHeap, uint32 time){
+	MOTORSCHEDULER_MotorType* motor;
+	uint8 segments = 0;
+
+	/*The earliest motor, while it is due, applies its pending segment and goes down the heap with
+	 * its next deadline; The interpreter runs the segment after it, so its wait is known*/
+	while(motorHeap->count && (sint32)(motorHeap->motors[0]->deadline - time) <= 0){
+		motor = motorHeap->motors[0];
+		MOTORSCHEDULER_apply(motor,&motor->pendingSegment);
+		if(motor->pendingSegment.waitMicroseconds == 0){
+			MOTORSCHEDULER_remove(motorHeap,motor);
+		} else {
+			motor->deadline += motor->pendingSegment.waitMicroseconds;
+			MOTORPROGRAM_next(&motor->interpreter,&motor->pendingSegment);
+			MOTORSCHEDULER_siftDown(motorHeap,0);
+		}
+		segments++;
+	}
+	return segments;
+}
+
+static uint32 MOTORSCHEDULER_elapsed(){
+	/*Ticks from schedulerTime*/
+	return periodStart + periodLoad - PIT_fastReadTimerValue(SCHEDULER_PIT);
+}
+
+static uint32 MOTORSCHEDULER_now(){
+	if(schedulerRunning == FALSE){
+		return schedulerTime;
+	}
+	/*If the period ended and its interruption is masked, the time goes on from its deadline*/
+	if(PIT_fastReadFlag(SCHEDULER_PIT)){
+		return periodDeadline + US_FROM_TICKS(periodLoad - PIT_fastReadTimerValue(SCHEDULER_PIT));
+	}
+	return schedulerTime + US_FROM_TICKS(MOTORSCHEDULER_elapsed());
+}
+
+static void MOTORSCHEDULER_timerUpdate(){
+	MOTORSCHEDULER_MotorType* first = heap.motors[0];
+	uint32 elapsed;
+	uint32 ticks;
+
+	/*The PIT channel 3 only runs while there are motors*/
+	if(heap.count == 0){
+		if(schedulerRunning){
+			schedulerTime = MOTORSCHEDULER_now();
+			schedulerRunning = FALSE;
+			PIT_timerDisable(SCHEDULER_PIT);
+			PIT_timerInterruptDisable(SCHEDULER_PIT);
+			IDLEMANAGER_busClockNeeded(IDLEMANAGER_MOTORSCHEDULER, FALSE);
+		}
+		return;
+	}
+	if(schedulerRunning && periodDeadline == first->deadline){
+		return;
+	}
+
+	/*The channel restarts with the rest of the time to the earliest deadline; The ticks already
+	 * counted in the current period are kept in periodStart*/
+	elapsed = (schedulerRunning)?(MOTORSCHEDULER_elapsed()):(0);
+	ticks = ((sint32)(first->deadline - schedulerTime) > 0)?(TICKS_FROM_US(first->deadline - schedulerTime)):(0);
+	ticks = (ticks > elapsed + MINIMUM_TICKS)?(ticks - elapsed):(MINIMUM_TICKS);
+	PIT_timerDisable(SCHEDULER_PIT);
+	PIT_fastLoadTicks(SCHEDULER_PIT,ticks - 1);
+	PIT_fastClearFlag(SCHEDULER_PIT);
+	PIT_timerEnable(SCHEDULER_PIT);
+	periodStart = elapsed;
+	periodLoad = ticks - 1;
+	periodDeadline = first->deadline;
+	if(schedulerRunning == FALSE){
+		schedulerRunning = TRUE;
+		PIT_timerInterruptEnable(SCHEDULER_PIT);
+		IDLEMANAGER_busClockNeeded(IDLEMANAGER_MOTORSCHEDULER, TRUE);
+	}
+}
+
+static void MOTORSCHEDULER_changed(){
+	/*A period that ended with its interruption masked is attended by the interruption, that
+	 * loads the next one; Otherwise, the current period is loaded again if the earliest deadline
+	 * changed*/
+	if(schedulerRunning == FALSE || PIT_fastReadFlag(SCHEDULER_PIT) == FALSE){
+		MOTORSCHEDULER_timerUpdate();
+	}
+}
+
+static void MOTORSCHEDULER_clockChanged(){
+	uint32 basePri = MOTORSCHEDULER_lock();
+	uint32 remaining;
+
+	/*The PIT counter keeps its counts with the new clock, so the rest of the current period is
+	 * converted, and the channel restarts with it; The ticks from schedulerTime are counted
+	 * again with the new clock*/
+	ticksPerMicrosecond = (uint32)(((uint64)CLOCKMANAGER_busClock() << 16)/1000000);
+	if(schedulerRunning){
+		remaining = (uint32)((((uint64)PIT_readTimerValue(SCHEDULER_PIT) + 1)*CLOCKMANAGER_busClock())/schedulerClock) - 1;
+		PIT_timerDisable(SCHEDULER_PIT);
+		PIT_loadTicks(SCHEDULER_PIT,remaining);
+		PIT_timerEnable(SCHEDULER_PIT);
+		periodLoad = remaining;
+		periodStart = TICKS_FROM_US(periodDeadline - schedulerTime);
+		periodStart = (periodStart > remaining + 1)?(periodStart - remaining - 1):(0);
+	}
+	schedulerClock = CLOCKMANAGER_busClock();
+	__set_BASEPRI(basePri);
+}
+
+void MOTORSCHEDULER_init(){
+	heap.count = 0;
+
+	/*PIT channel 3; It is enabled by the first motor. The PIT clock gating and the NVIC are
+	 * configured by BOARDCONFIG_init*/
+	PIT_enable();
+	PIT_timerDisable(SCHEDULER_PIT);
+	PIT_timerInterruptDisable(SCHEDULER_PIT);
+	schedulerClock = CLOCKMANAGER_busClock();
+	ticksPerMicrosecond = (uint32)(((uint64)schedulerClock << 16)/1000000);
+	CLOCKMANAGER_addListener(MOTORSCHEDULER_clockChanged);
+
+	PROFILER_BENCHMARK("MOTORSCHEDULER(1)",MOTORSCHEDULER_BENCHMARK_SEGMENTS,MOTORSCHEDULER_benchmark(1));
+	PROFILER_BENCHMARK("MOTORSCHEDULER(4)",MOTORSCHEDULER_BENCHMARK_SEGMENTS,MOTORSCHEDULER_benchmark(4));
+	PROFILER_BENCHMARK("MOTORSCHEDULER(16)",MOTORSCHEDULER_BENCHMARK_SEGMENTS,MOTORSCHEDULER_benchmark(16));
+}
+
+void MOTORSCHEDULER_motorInit(MOTORSCHEDULER_MotorType* motor, void(*output)(MOTORSCHEDULER_MotorType*, MOTORPROGRAM_InstructionType)){
+	motor->heapIndex = MOTORSCHEDULER_IDLE;
+	motor->deadline = 0;
+	motor->pendingSegment.outputs = 0;
+	motor->pendingSegment.waitMicroseconds = 0;
+	motor->fptrOutput = output;
+}
+
+void MOTORSCHEDULER_start(MOTORSCHEDULER_MotorType* motor, const MOTORPROGRAM_InstructionType* program){
+	MOTORPROGRAM_SegmentType segment;
+	uint32 basePri = MOTORSCHEDULER_lock();
+
+	/*The first segment is applied now, and the motor waits in the heap for the second one*/
+	if(MOTORSCHEDULER_isRunning(motor)){
+		MOTORSCHEDULER_remove(&heap,motor);
+	}
+	MOTORPROGRAM_start(&motor->interpreter,program);
+	MOTORPROGRAM_next(&motor->interpreter,&segment);
+	MOTORSCHEDULER_apply(motor,&segment);
+	if(segment.waitMicroseconds){
+		motor->deadline = MOTORSCHEDULER_now() + segment.waitMicroseconds;
+		MOTORPROGRAM_next(&motor->interpreter,&motor->pendingSegment);
+		MOTORSCHEDULER_push(&heap,motor);
+	}
+	MOTORSCHEDULER_changed();
+	__set_BASEPRI(basePri);
+}
+
+void MOTORSCHEDULER_stop(MOTORSCHEDULER_MotorType* motor){
+	uint32 basePri = MOTORSCHEDULER_lock();
+	if(MOTORSCHEDULER_isRunning(motor)){
+		MOTORSCHEDULER_remove(&heap,motor);
+		MOTORSCHEDULER_changed();
+	}
+	__set_BASEPRI(basePri);
+}
+
+BooleanType MOTORSCHEDULER_isRunning(const MOTORSCHEDULER_MotorType* motor){
+	return (motor->heapIndex != MOTORSCHEDULER_IDLE);
+}
+
+void MOTORSCHEDULER_dispatch(){
+	/*A period loaded again after its expiry can't be attended*/
+	if(schedulerRunning == FALSE){
+		return;
+	}
+	/*The period ended at its deadline; The counter goes on with the same load value, until the
+	 * next one is loaded*/
+	schedulerTime = periodDeadline;
+	periodStart = 0;
+	MOTORSCHEDULER_run(&heap,schedulerTime);
+	MOTORSCHEDULER_timerUpdate();
+}
+
+static void MOTORSCHEDULER_benchmarkOutput(MOTORSCHEDULER_MotorType* motor, MOTORPROGRAM_InstructionType output){
+	/*The outputs aren't applied*/
+}
+
+uint32 MOTORSCHEDULER_benchmark(uint8 motors){
+	/*Program of the motors: two outputs and two waits; Each motor takes a different wait, so the
+	 * deadlines interleave and the motors move through the heap*/
+	static MOTORPROGRAM_InstructionType programs[MOTORSCHEDULER_MAX_MOTORS][5];
+	static MOTORSCHEDULER_MotorType benchmarkMotors[MOTORSCHEDULER_MAX_MOTORS];
+	MOTORSCHEDULER_HeapType benchmarkHeap;
+	uint32 segments = 0;
+	uint32 start;
+	uint8 motor;
+
+	if(motors == 0 || motors > MOTORSCHEDULER_MAX_MOTORS){
+		return 0;
+	}
+	benchmarkHeap.count = 0;
+	for(motor = 0; motor < motors; motor++){
+		programs[motor][0] = MOTORPROGRAM_SET_DUTY(0);
+		programs[motor][1] = MOTORPROGRAM_WAIT_US(1000 + 37*motor);
+		programs[motor][2] = MOTORPROGRAM_SET_DUTY(MOTORPROGRAM_DUTY_PERCENT(50));
+		programs[motor][3] = MOTORPROGRAM_WAIT_US(500 + 53*motor);
+		programs[motor][4] = MOTORPROGRAM_JUMP(0);
+		MOTORSCHEDULER_motorInit(&benchmarkMotors[motor],MOTORSCHEDULER_benchmarkOutput);
+		MOTORPROGRAM_start(&benchmarkMotors[motor].interpreter,programs[motor]);
+		benchmarkMotors[motor].deadline = 0;
+		MOTORPROGRAM_next(&benchmarkMotors[motor].interpreter,&benchmarkMotors[motor].pendingSegment);
+		MOTORSCHEDULER_push(&benchmarkHeap,&benchmarkMotors[motor]);
+	}
+
+	/*Each pass is an expiry at the earliest deadline, that attends the motors due*/
+	start = cycleCounter();
+	while(segments < MOTORSCHEDULER_BENCHMARK_SEGMENTS){
+		segments += MOTORSCHEDULER_run(&benchmarkHeap,benchmarkHeap.motors[0]->deadline);
+	}
+	return cycleCounter() - start;
+}
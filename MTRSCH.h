@@ -0,0 +1,130 @@
+/**
+	\file
+	\brief
+		This is the header file for the motor scheduler. The programs (MTRPRG.h) of all the
+		motors share the PIT channel 3: the running motors are kept in a binary min heap,
+		ordered by the deadline of their next segment, and the channel is loaded with the
+		time to the earliest one. So it only interrupts when a motor has a segment due, and
+		an interruption only attends the motors that are due: starting, stopping and running
+		a segment of a motor are O(log N), whatever the number of motors, without polling
+		them. The deadlines are absolute (us), so the waits don't add the latency of the
+		interruption. The segments are applied from the PIT channel 3 interruption, with
+		priority MOTORSCHEDULER_PRIORITY.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_MTRSCH_H_
+#define SOURCES_MTRSCH_H_
+
+#include "DataTypeDefinitions.h"
+#include "NVIC.h"
+#include "MTRPRG.h"
+
+/*Most motors running at once*/
+#define MOTORSCHEDULER_MAX_MOTORS 16
+/*Priority of the PIT channel 3 interruption, where the outputs are applied*/
+#define MOTORSCHEDULER_PRIORITY PRIORITY_10
+/*Segments run by MOTORSCHEDULER_benchmark*/
+#define MOTORSCHEDULER_BENCHMARK_SEGMENTS 256
+/*heapIndex of a motor that isn't running*/
+#define MOTORSCHEDULER_IDLE 0xFF
+
+/*Struct that contains a motor of the scheduler; It must be kept by its user (static), and
+ * initialized with MOTORSCHEDULER_motorInit before being started*/
+typedef struct MOTORSCHEDULER_Motor{
+	/*interpreter, of the program of the motor*/
+	MOTORPROGRAM_InterpreterType interpreter;
+	/*pendingSegment, outputs applied at the deadline, and the wait from them to the next one*/
+	MOTORPROGRAM_SegmentType pendingSegment;
+	/*deadline, time of the pending segment (us of the scheduler)*/
+	uint32 deadline;
+	/*heapIndex, position in the heap; MOTORSCHEDULER_IDLE if the program isn't running*/
+	uint8 heapIndex;
+	/*fptrOutput, function that applies an output (SET_OUTPUT or SET_DUTY) to the motor; It
+	 * must not start nor stop any motor*/
+	void(*fptrOutput)(struct MOTORSCHEDULER_Motor* motor, MOTORPROGRAM_InstructionType output);
+}MOTORSCHEDULER_MotorType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures the PIT channel 3 for the scheduler. The channel and its
+ 	 	 interruption only run while any motor is running.
+ 	 \return void
+ */
+void MOTORSCHEDULER_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function initializes a motor, stopped
+ 	 \param[out] motor Motor to be initialized
+ 	 \param[in] output Function that applies the outputs of the program to the motor
+ 	 \return void
+ */
+void MOTORSCHEDULER_motorInit(MOTORSCHEDULER_MotorType* motor, void(*output)(MOTORSCHEDULER_MotorType*, MOTORPROGRAM_InstructionType));
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function starts a program on a motor; If it was running, it starts again.
+ 	 	 The outputs of the first segment are applied here, and the next ones at the end of
+ 	 	 each wait.
+ 	 \param[in,out] motor Motor
+ 	 \param[in] program Program; It must end with an END or a JUMP
+ 	 \return void
+ */
+void MOTORSCHEDULER_start(MOTORSCHEDULER_MotorType* motor, const MOTORPROGRAM_InstructionType* program);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function stops the program of a motor; The outputs are left as they are
+ 	 \param[in,out] motor Motor
+ 	 \return void
+ */
+void MOTORSCHEDULER_stop(MOTORSCHEDULER_MotorType* motor);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function indicates if the program of a motor is running
+ 	 \param[in] motor Motor
+ 	 \return TRUE if the program is running
+ */
+BooleanType MOTORSCHEDULER_isRunning(const MOTORSCHEDULER_MotorType* motor);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function applies the segments of the motors that are due, and loads the PIT
+ 	 	 channel 3 with the time to the next deadline. It is invoked from the PIT channel 3
+ 	 	 interruption.
+ 	 \return void
+ */
+void MOTORSCHEDULER_dispatch();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function measures the cost of the scheduling with the cycle counter: it runs
+ 	 	 MOTORSCHEDULER_BENCHMARK_SEGMENTS segments (or a few more, as an expiry can find
+ 	 	 several motors due) of a number of motors, with a heap of its own and outputs that
+ 	 	 do nothing, so only the heap and the interpreter are measured.
+ 	 	 In the host simulator, it runs in the initialization, where the cycle counter counts
+ 	 	 the host instructions, so the result is an instruction count of the host build, only
+ 	 	 useful to compare changes.
+ 	 \param[in] motors Motors, 1 to MOTORSCHEDULER_MAX_MOTORS
+ 	 \return Cycles spent by the segments; 0 with a wrong number of motors
+ */
+uint32 MOTORSCHEDULER_benchmark(uint8 motors);
+
+#endif /* SOURCES_MTRSCH_H_ */
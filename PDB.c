@@ -0,0 +1,48 @@
+/**
+	\file
+	\brief
+		This is the source file for the PDB in the Kinetis 64F. It has the functions needed
+		to use the PDB0 as a periodic hardware trigger for the DAC0 (DAC interval trigger).
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "MK64F12.h"
+#include "PDB.h"
+#include "DataTypeDefinitions.h"
+
+/*Software trigger as the input trigger of the PDB*/
+#define PDB_SOFTWARE_TRIGGER 15
+
+void PDB_clockGating(){
+	SIM->SCGC6 |= SIM_SCGC6_PDB_MASK;
+}
+
+void PDB_dacTriggerInit(PDB_PrescalerType prescaler, uint16 interval){
+	/*Enables the PDB, in continuous mode and started by software*/
+	PDB0->SC = PDB_SC_PRESCALER(prescaler) | PDB_SC_TRGSEL(PDB_SOFTWARE_TRIGGER) | PDB_SC_CONT_MASK | PDB_SC_PDBEN_MASK;
+	/*The counter restarts each interval*/
+	PDB0->MOD = interval - 1;
+	/*DAC0 interval trigger*/
+	PDB0->DAC[0].INT = interval - 1;
+	PDB0->DAC[0].INTC = PDB_INTC_TOE_MASK;
+	/*Loads MOD and INT values*/
+	PDB0->SC |= PDB_SC_LDOK_MASK;
+}
+
+void PDB_dacTriggerInterval(uint16 interval){
+	PDB0->MOD = interval - 1;
+	PDB0->DAC[0].INT = interval - 1;
+	/*Loads MOD and INT values, if the PDB is enabled*/
+	PDB0->SC |= PDB_SC_LDOK_MASK;
+}
+
+void PDB_start(){
+	/*Makes sure the PDB is enabled, and starts the counter*/
+	PDB0->SC |= PDB_SC_PDBEN_MASK;
+	PDB0->SC |= PDB_SC_SWTRIG_MASK;
+}
+
+void PDB_stop(){
+	PDB0->SC &= ~(PDB_SC_PDBEN_MASK);
+}
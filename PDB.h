@@ -0,0 +1,71 @@
+/**
+	\file
+	\brief
+		This is the header file for the PDB in the Kinetis 64F. It has the functions needed
+		to use the PDB0 as a periodic hardware trigger for the DAC0 (DAC interval trigger).
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_PDB_H_
+#define SOURCES_PDB_H_
+
+#include "DataTypeDefinitions.h"
+
+/*! This enumerated constant are used to select the division of the bus clock for the PDB counter*/
+typedef enum {PDB_PRESCALER_1, PDB_PRESCALER_2, PDB_PRESCALER_4, PDB_PRESCALER_8,
+			  PDB_PRESCALER_16, PDB_PRESCALER_32, PDB_PRESCALER_64, PDB_PRESCALER_128
+			 }PDB_PrescalerType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function enables the PDB clock gating
+ 	 \return void
+ */
+void PDB_clockGating();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures the PDB0 in continuous mode, and the DAC0 interval trigger;
+ 	 	 The DAC0 receives a trigger each 'interval' counts of the PDB counter. The PDB counter
+ 	 	 doesn't start until PDB_start() is called.
+ 	 \param[in] prescaler division of the bus clock for the PDB counter
+ 	 \param[in] interval counts between DAC0 triggers
+ 	 \return void
+ */
+void PDB_dacTriggerInit(PDB_PrescalerType prescaler, uint16 interval);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 rief This function changes the interval of the DAC0 trigger, keeping the prescaler; It is
+ 	 	 used after a bus clock change. The new interval is loaded at once, if the PDB is enabled.
+ 	 \param[in] interval counts between DAC0 triggers
+ 	 eturn void
+ */
+void PDB_dacTriggerInterval(uint16 interval);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function starts the PDB counter, with a software trigger
+ 	 \return void
+ */
+void PDB_start();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function stops the PDB counter, by disabling the PDB
+ 	 \return void
+ */
+void PDB_stop();
+
+#endif /* SOURCES_PDB_H_ */
@@ -0,0 +1,67 @@
+/**
+	\file
+	\brief
+		This is the source file for the fixed point PID controller. It has the update of
+		the controller, with a constant cost, and its benchmark.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "PID.h"
+#include "DataTypeDefinitions.h"
+#include "GlobalFunctions.h"
+
+void PID_init(PID_ControllerType* pid, sint16 kp, sint16 ki, sint16 kd, sint32 outputMinimum, sint32 outputMaximum){
+	pid->kp = kp;
+	pid->ki = ki;
+	pid->kd = kd;
+	pid->outputMinimum = outputMinimum;
+	pid->outputMaximum = outputMaximum;
+	PID_reset(pid, 0, 0);
+}
+
+void PID_reset(PID_ControllerType* pid, sint32 measure, sint32 output){
+	pid->integral = output << PID_SHIFT;
+	pid->lastMeasure = measure;
+}
+
+sint32 PID_update(PID_ControllerType* pid, sint32 reference, sint32 measure){
+	sint32 error = reference - measure;
+	sint32 output;
+
+	/*The integral can't go beyond the range of the output, so it starts to come back as soon as
+	 * the error changes its sign*/
+	pid->integral += pid->ki*error;
+	if(pid->integral > (pid->outputMaximum << PID_SHIFT)){
+		pid->integral = pid->outputMaximum << PID_SHIFT;
+	} else if(pid->integral < (pid->outputMinimum << PID_SHIFT)){
+		pid->integral = pid->outputMinimum << PID_SHIFT;
+	}
+
+	/*The derivative of the measure has the opposite sign of the derivative of the error*/
+	output = (pid->kp*error + pid->integral + pid->kd*(pid->lastMeasure - measure)) >> PID_SHIFT;
+	pid->lastMeasure = measure;
+
+	if(output > pid->outputMaximum){
+		output = pid->outputMaximum;
+	} else if(output < pid->outputMinimum){
+		output = pid->outputMinimum;
+	}
+	return output;
+}
+
+uint32 PID_benchmark(){
+	PID_ControllerType pid;
+	/*The outputs are added, so the updates aren't removed by the compiler*/
+	volatile sint32 outputs = 0;
+	uint32 start;
+	uint32 update;
+
+	PID_init(&pid, PID_GAIN(0.5), PID_GAIN(0.1), PID_GAIN(0.05), 0, 1 << 15);
+	start = cycleCounter();
+	for(update = 0; update < PID_BENCHMARK_UPDATES; update++){
+		/*The measure follows a saw tooth around the reference, so every branch is taken*/
+		outputs += PID_update(&pid, 1 << 16, (sint32)((update & 0x3F) << 11));
+	}
+	return cycleCounter() - start;
+}
@@ -0,0 +1,102 @@
+/**
+	\file
+	\brief
+		This is the header file for the fixed point PID controller. It is used by the motor
+		control loop, in an interruption, so each update has a constant cost: no loops, no
+		divisions and no float math, only multiplications, additions, shifts and the clamps.
+			- The reference and the measure are in any fixed point unit (the motor uses encoder
+			  counts per control period, Q8).
+			- The gains are Q8: a gain of PID_GAIN(1.0) gives one unit of output per unit of
+			  error.
+			- The output is saturated to a range (the motor uses a Q15 duty, 0 to 1.0).
+		The derivative is taken from the measure, not from the error, so a step of the
+		reference doesn't kick the output. The integral is kept inside the range of the
+		output (anti windup), so it doesn't overshoot after a saturation.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_PID_H_
+#define SOURCES_PID_H_
+
+#include "DataTypeDefinitions.h"
+
+/*Fractional bits of the gains and of the integral*/
+#define PID_SHIFT 8
+/*Q8 gain*/
+#define PID_GAIN(gain) ((sint16)((gain)*(1 << PID_SHIFT)))
+/*Updates done by PID_benchmark*/
+#define PID_BENCHMARK_UPDATES 256
+
+/*Struct that contains a PID controller*/
+typedef struct{
+	/*kp, ki, kd, Q8 gains of the proportional, integral (per update) and derivative (per update) terms*/
+	sint16 kp;
+	sint16 ki;
+	sint16 kd;
+	/*integral, sum of ki*error, scaled by 2^PID_SHIFT as the output*/
+	sint32 integral;
+	/*lastMeasure, of the previous update, for the derivative*/
+	sint32 lastMeasure;
+	/*outputMinimum, outputMaximum, range of the output*/
+	sint32 outputMinimum;
+	sint32 outputMaximum;
+}PID_ControllerType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures the gains and the output range of a controller, and
+ 	 	 resets it with a measure and an output of 0 (see PID_reset).
+ 	 \param[out] pid Controller
+ 	 \param[in] kp Proportional gain (PID_GAIN)
+ 	 \param[in] ki Integral gain, per update (PID_GAIN)
+ 	 \param[in] kd Derivative gain, per update (PID_GAIN)
+ 	 \param[in] outputMinimum Lowest output
+ 	 \param[in] outputMaximum Highest output; The range times 2^PID_SHIFT must fit in 31 bits
+ 	 \return void
+ */
+void PID_init(PID_ControllerType* pid, sint16 kp, sint16 ki, sint16 kd, sint32 outputMinimum, sint32 outputMaximum);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function resets a controller without a bump: the integral takes the current
+ 	 	 output, so the first update gives the same output if there is no error.
+ 	 \param[in,out] pid Controller
+ 	 \param[in] measure Current measure
+ 	 \param[in] output Current output, inside the range of the controller
+ 	 \return void
+ */
+void PID_reset(PID_ControllerType* pid, sint32 measure, sint32 output);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function computes the next output of a controller; It is called at a fixed
+ 	 	 rate. The products must fit in 32 bits: the errors and the changes of the measure
+ 	 	 times the gains, up to 2^31.
+ 	 \param[in,out] pid Controller
+ 	 \param[in] reference Wanted measure
+ 	 \param[in] measure Current measure
+ 	 \return Output, inside the range of the controller
+ */
+sint32 PID_update(PID_ControllerType* pid, sint32 reference, sint32 measure);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function measures the cost of PID_update with the cycle counter, doing
+ 	 	 PID_BENCHMARK_UPDATES updates with a controller of its own. In the host simulator,
+ 	 	 it runs in the initialization, where the cycle counter counts the host instructions,
+ 	 	 so the result is an instruction count of the host build, only useful to compare
+ 	 	 changes.
+ 	 \return Cycles spent by the PID_BENCHMARK_UPDATES updates
+ */
+uint32 PID_benchmark();
+
+#endif /* SOURCES_PID_H_ */
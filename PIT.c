@@ -10,8 +10,11 @@
 #include "DataTypeDefinitions.h"
 #include "PIT.h"
 #include "WVGN.h"
-#include "PSSWRD.h"
+#include "TMRWHL.h"
 #include "MTRCTRL.h"
+#include "MTRSCH.h"
+#include "PRFL.h"
+#include "GlobalFunctions.h"
 
 
 void PIT_clockGating(){
@@ -117,31 +120,46 @@ void PIT_delay(PIT_TimerType pitTimer,float systemClock ,float period){
 
 }
 
-void PIT0_clearInterrupt(){
+void PIT_loadTicks(PIT_TimerType pitTimer, uint32 ticks){
+	if(pitTimer <= PIT_3){
+		PIT_fastLoadTicks(pitTimer,ticks);
+	}
+}
+
+uint32 PIT_msToTicks(uint32 clock, uint32 milliseconds){
+	return PIT_TICKS_FROM_MS(clock,milliseconds);
+}
+
+uint32 PIT_usToTicks(uint32 clock, uint32 microseconds){
+	return PIT_TICKS_FROM_US(clock,microseconds);
+}
+
+RAM_FUNCTION void PIT0_clearInterrupt(){
 	/*Clear interruption flag for PIT channel 0*/
-	PIT_TFLG0 |= PIT_TFLG_TIF_MASK;
+	PIT_fastClearFlag(PIT_0);
 	PIT_TCTRL0;
-	/*Enable the timer again*/
-	PIT_timerInterruptEnable(PIT_0);
-	PIT_timerEnable(PIT_0);
+	/*Enable the timer again; It is called from PIT0_IRQHandler, in SRAM, so the PIT_timer functions
+	 * (in flash) aren't used*/
+	PIT_TCTRL0 |= PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
 }
 
 void PIT1_clearInterrupt(){
-	/*Clear interruption flag for PIT channel 0*/
-	PIT_TFLG1 |= PIT_TFLG_TIF_MASK;
+	/*Clear interruption flag for PIT channel 1; The timer keeps running*/
+	PIT_fastClearFlag(PIT_1);
 	PIT_TCTRL1;
-	/*Enable the timer again*/
-	PIT_timerInterruptEnable(PIT_1);
-	PIT_timerEnable(PIT_1);
+}
+
+void PIT2_clearInterrupt(){
+	/*Clear interruption flag for PIT channel 2; The timer keeps running*/
+	PIT_fastClearFlag(PIT_2);
+	PIT_TCTRL2;
 }
 
 void PIT3_clearInterrupt(){
-	/*Clear interruption flag for PIT channel 3*/
-	PIT_TFLG3 |= PIT_TFLG_TIF_MASK;
+	/*Clear interruption flag for PIT channel 3; The timer keeps running, with the load value of the
+	 * next wait*/
+	PIT_fastClearFlag(PIT_3);
 	PIT_TCTRL3;
-	/*Enable the timer again*/
-	PIT_timerInterruptEnable(PIT_3);
-	PIT_timerEnable(PIT_3);
 }
 
 /********************************************************************************************/
@@ -149,13 +167,17 @@ void PIT3_clearInterrupt(){
 /********************************************************************************************/
 /*!
  	 \brief This function attends the PIT channel 0 interruption, it clears the interruption
- 	 	 flags, and has a functionality according to this project
+ 	 	 flags, and has a functionality according to this project. It is placed in SRAM, with all
+ 	 	 the functions of the sample path (RAM_FUNCTION)
  	 \return void
  */
-void PIT0_IRQHandler(){
+RAM_FUNCTION void PIT0_IRQHandler(){
+	PROFILER_START(PROFILER_PIT0);
+	PROFILER_PERIOD(PROFILER_PIT0,PIT_0);
 	PIT0_clearInterrupt();
 	/*project functionality added to the PIT channel 0 interruption*/
 	WAVEGEN_indexShifting();
+	PROFILER_STOP(PROFILER_PIT0);
  }
 
 /********************************************************************************************/
@@ -163,41 +185,55 @@ void PIT0_IRQHandler(){
 /********************************************************************************************/
 /*!
  	 \brief This function attends the PIT channel 1 interruption, it clears the interruption
- 	 	 flags, and has a functionality according to this project
+ 	 	 flags, and runs a step of the motor control loop
  	 \return void
  */
 void PIT1_IRQHandler(){
+	PROFILER_START(PROFILER_PIT1);
 	PIT1_clearInterrupt();
-	/*project functionality added to the PIT channel 0 interruption*/
-	MOTORCONTROL_behaviorChange();
- }
+	/*project functionality added to the PIT channel 1 interruption*/
+	MOTORCONTROL_controlLoop();
+	PROFILER_STOP(PROFILER_PIT1);
+}
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function attends the PIT channel 2 interruption, it clears the interruption
+ 	 	 flags, and moves the timer wheel, that calls the callbacks of the expired timers
+ 	 	 (motor stop ramp, password LED, etc.)
+ 	 \return void
+ */
+void PIT2_IRQHandler(){
+	PROFILER_START(PROFILER_PIT2);
+	PIT2_clearInterrupt();
+	/*project functionality added to the PIT channel 2 interruption*/
+	TIMERWHEEL_tick();
+	PROFILER_STOP(PROFILER_PIT2);
+}
 
 /********************************************************************************************/
 /********************************************************************************************/
 /********************************************************************************************/
 /*!
  	 \brief This function attends the PIT channel 3 interruption, it clears the interruption
- 	 	 flags, and has a functionality according to this project
+ 	 	 flags, and runs the segments of the motor programs that are due
  	 \return void
  */
 void PIT3_IRQHandler(){
+	PROFILER_START(PROFILER_PIT3);
 	PIT3_clearInterrupt();
 	/*project functionality added to the PIT channel 3 interruption*/
-	PASSWORD_ledCorrectPassword();
+	MOTORSCHEDULER_dispatch();
+	PROFILER_STOP(PROFILER_PIT3);
 }
 
 uint32 PIT_readTimerValue(PIT_TimerType pitTimer){
 	/*According to the pit Timer, we return the value of the counter in the requested
 	 * channel*/
-	switch(pitTimer){
-	case PIT_0:
-		return PIT_CVAL0;
-	case PIT_1:
-		return PIT_CVAL1;
-	case PIT_2:
-		return PIT_CVAL2;
-	case PIT_3:
-		return PIT_CVAL3;
+	if(pitTimer <= PIT_3){
+		return PIT_fastReadTimerValue(pitTimer);
 	}
 	return FALSE;
 }
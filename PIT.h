@@ -17,6 +17,15 @@
 /*! This enumerated constant are used to select the PIT to be used*/
 typedef enum {PIT_0,PIT_1,PIT_2,PIT_3} PIT_TimerType;
 
+/*Conversions to PIT load values (ticks), from a frequency in Hz, or a period in ms or us. The PIT counts with
+ * the clock (Hz) given as first parameter (CLOCKMANAGER_busClock()), and the timer expires when the counter goes
+ * from the load value to 0, so the load value is the number of counts minus 1. The product is done in 64 bits,
+ * so clocks that aren't a multiple of 1MHz (the FLL) don't lose precision. With constant parameters, the value
+ * is computed by the compiler*/
+#define PIT_TICKS_FROM_HZ(clock,hertz) ((uint32)((clock)/(hertz)) - 1)
+#define PIT_TICKS_FROM_MS(clock,milliseconds) ((uint32)(((uint64)(clock)*(milliseconds))/1000) - 1)
+#define PIT_TICKS_FROM_US(clock,microseconds) ((uint32)(((uint64)(clock)*(microseconds))/1000000) - 1)
+
 /********************************************************************************************/
 /********************************************************************************************/
 /********************************************************************************************/
@@ -101,6 +110,43 @@ void PIT_timerDisable(PIT_TimerType pitTimer);
  */
 void PIT_delay(PIT_TimerType pitTimer,float systemClock ,float perior);
 
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function receives a PIT channel number and a load value already converted to
+ 	 	 ticks (see PIT_TICKS_FROM_HZ, PIT_TICKS_FROM_MS, PIT_TICKS_FROM_US), and loads it in the PIT
+ 	 	 channel. There is no float math, so it can be used in interruptions.
+ 	 \param[in] pitTimer PIT channel
+ 	 \param[in] ticks load value
+ 	 \return void
+ */
+void PIT_loadTicks(PIT_TimerType pitTimer, uint32 ticks);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function converts a period in ms to a PIT load value, when the period is only
+ 	 	 known in run time (for example, during the initialization)
+ 	 \param[in] clock PIT clock in Hz
+ 	 \param[in] milliseconds period
+ 	 \return load value (ticks)
+ */
+uint32 PIT_msToTicks(uint32 clock, uint32 milliseconds);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function converts a period in us to a PIT load value, when the period is only
+ 	 	 known in run time (for example, during the initialization)
+ 	 \param[in] clock PIT clock in Hz
+ 	 \param[in] microseconds period
+ 	 \return load value (ticks)
+ */
+uint32 PIT_usToTicks(uint32 clock, uint32 microseconds);
+
 /********************************************************************************************/
 /********************************************************************************************/
 /********************************************************************************************/
@@ -111,6 +157,26 @@ void PIT_delay(PIT_TimerType pitTimer,float systemClock ,float perior);
  */
 void PIT0_clearInterrupt();
 
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function clears the corresponding flags when a PIT channel 1 interruption
+ 	 	 occurs
+ 	 \return void
+ */
+void PIT1_clearInterrupt();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function clears the corresponding flags when a PIT channel 2 interruption
+ 	 	 occurs
+ 	 \return void
+ */
+void PIT2_clearInterrupt();
+
 /********************************************************************************************/
 /********************************************************************************************/
 /********************************************************************************************/
@@ -131,4 +197,30 @@ void PIT3_clearInterrupt();
  	 \return counter value in the PIT channel
  */
 uint32 PIT_readTimerValue(PIT_TimerType pitTimer);
+
+/*Inline versions of the channel functions, for the interruption handlers. They don't check
+ * the channel, so it must be PIT_0 to PIT_3; With a constant channel, the register address is
+ * computed by the compiler and each one compiles to a single register access, without branches*/
+static inline void PIT_fastLoadTicks(PIT_TimerType pitTimer, uint32 ticks){
+	PIT->CHANNEL[pitTimer].LDVAL = ticks;
+}
+
+static inline void PIT_fastClearFlag(PIT_TimerType pitTimer){
+	/*TIF is cleared writing 1; It is the only bit of TFLG*/
+	PIT->CHANNEL[pitTimer].TFLG = PIT_TFLG_TIF_MASK;
+}
+
+static inline BooleanType PIT_fastReadFlag(PIT_TimerType pitTimer){
+	return (PIT->CHANNEL[pitTimer].TFLG & PIT_TFLG_TIF_MASK)?(TRUE):(FALSE);
+}
+
+static inline uint32 PIT_fastReadTimerValue(PIT_TimerType pitTimer){
+	return PIT->CHANNEL[pitTimer].CVAL;
+}
+
+/*Address of the load value register of a channel, as the destination of a DMA transfer; A value
+ * written while the channel runs is taken when the current period expires*/
+static inline volatile void* PIT_loadRegister(PIT_TimerType pitTimer){
+	return &PIT->CHANNEL[pitTimer].LDVAL;
+}
 #endif /* PIT_H_ */
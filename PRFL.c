@@ -0,0 +1,149 @@
+/**
+	\file
+	\brief
+		This is the source file for the interruption profiler. It measures the core cycles
+		spent by each interruption handler of this project with the DWT cycle counter.
+		It is empty unless PROFILER_ENABLE is defined.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include <stdint.h>
+#include "PRFL.h"
+#include "MK64F12.h"
+#include "DataTypeDefinitions.h"
+#include "GlobalFunctions.h"
+
+#ifdef PROFILER_ENABLE
+
+/*Limits of the memory regions*/
+#define FLASH_END 0x00100000
+#define SRAM_L_START 0x1FFF0000
+#define SRAM_U_START 0x20000000
+#define SRAM_U_END 0x20030000
+
+volatile PROFILER_StatsType PROFILER_stats[PROFILER_HANDLERS];
+PROFILER_PlacementType PROFILER_memoryMap[PROFILER_PLACEMENTS];
+uint8 PROFILER_memoryMapCount = 0;
+PROFILER_BenchmarkType PROFILER_benchmarks[PROFILER_BENCHMARKS];
+uint8 PROFILER_benchmarkCount = 0;
+uint8 PROFILER_benchmarkDrops = 0;
+
+/*Profiled handlers, in the order of PROFILER_HandlerType*/
+extern void PIT0_IRQHandler();
+extern void PIT1_IRQHandler();
+extern void PIT2_IRQHandler();
+extern void PIT3_IRQHandler();
+extern void PORTA_IRQHandler();
+extern void PORTB_IRQHandler();
+extern void PORTC_IRQHandler();
+extern void DAC0_IRQHandler();
+extern void LPTMR0_IRQHandler();
+
+void PROFILER_init(){
+	/*Enable the cycle counter of the DWT*/
+	cycleCounterInit();
+	PROFILER_reset();
+
+	PROFILER_PLACEMENT(PIT0_IRQHandler);
+	PROFILER_PLACEMENT(PIT1_IRQHandler);
+	PROFILER_PLACEMENT(PIT2_IRQHandler);
+	PROFILER_PLACEMENT(PIT3_IRQHandler);
+	PROFILER_PLACEMENT(PORTA_IRQHandler);
+	PROFILER_PLACEMENT(PORTB_IRQHandler);
+	PROFILER_PLACEMENT(PORTC_IRQHandler);
+	PROFILER_PLACEMENT(DAC0_IRQHandler);
+	PROFILER_PLACEMENT(LPTMR0_IRQHandler);
+}
+
+void PROFILER_reset(){
+	uint8 handler;
+	uint8 bin;
+	for(handler = 0; handler < PROFILER_HANDLERS; handler++){
+		PROFILER_stats[handler].count = 0;
+		PROFILER_stats[handler].minimum = 0xFFFFFFFF;
+		PROFILER_stats[handler].maximum = 0;
+		PROFILER_stats[handler].total = 0;
+		PROFILER_stats[handler].minimumPeriod = 0xFFFFFFFF;
+		PROFILER_stats[handler].maximumPeriod = 0;
+		for(bin = 0; bin < PROFILER_HISTOGRAM_BINS; bin++){
+			PROFILER_stats[handler].histogram[bin] = 0;
+		}
+	}
+}
+
+void PROFILER_record(PROFILER_HandlerType handler, uint32 cycles){
+	volatile PROFILER_StatsType* stats = &PROFILER_stats[handler];
+	/*Number of significant bits of the duration (CLZ instruction), limited to the last bin*/
+	uint32 bin = (cycles)?(32 - __builtin_clz(cycles)):(0);
+	if(bin >= PROFILER_HISTOGRAM_BINS){
+		bin = PROFILER_HISTOGRAM_BINS - 1;
+	}
+
+	stats->count++;
+	stats->total += cycles;
+	if(cycles < stats->minimum){
+		stats->minimum = cycles;
+	}
+	if(cycles > stats->maximum){
+		stats->maximum = cycles;
+	}
+	stats->histogram[bin]++;
+}
+
+void PROFILER_recordPeriod(PROFILER_HandlerType handler, uint32 timerPeriod, uint32 latency){
+	volatile PROFILER_StatsType* stats = &PROFILER_stats[handler];
+
+	/*The period needs two executions; It is called before PROFILER_record counts this one*/
+	if(stats->count){
+		uint32 period = timerPeriod + latency - stats->lastLatency;
+		if(period < stats->minimumPeriod){
+			stats->minimumPeriod = period;
+		}
+		if(period > stats->maximumPeriod){
+			stats->maximumPeriod = period;
+		}
+	}
+	stats->lastLatency = latency;
+}
+
+void PROFILER_place(const char* name, const void* address){
+	uintptr_t value = (uintptr_t)address;
+	PROFILER_PlacementType* entry;
+
+	if(PROFILER_memoryMapCount >= PROFILER_PLACEMENTS){
+		return;
+	}
+	entry = &PROFILER_memoryMap[PROFILER_memoryMapCount++];
+	entry->name = name;
+	entry->address = address;
+	if(value < FLASH_END){
+		entry->region = PROFILER_FLASH;
+	} else if(value >= SRAM_L_START && value < SRAM_U_START){
+		entry->region = PROFILER_SRAM_L;
+	} else if(value >= SRAM_U_START && value < SRAM_U_END){
+		entry->region = PROFILER_SRAM_U;
+	} else {
+		entry->region = PROFILER_OTHER;
+	}
+}
+
+void PROFILER_addBenchmark(const char* name, uint32 items, uint32 cycles){
+	if(PROFILER_benchmarkCount >= PROFILER_BENCHMARKS){
+		PROFILER_benchmarkDrops++;
+		return;
+	}
+	PROFILER_benchmarks[PROFILER_benchmarkCount].name = name;
+	PROFILER_benchmarks[PROFILER_benchmarkCount].items = items;
+	PROFILER_benchmarks[PROFILER_benchmarkCount].cycles = cycles;
+	PROFILER_benchmarkCount++;
+}
+
+uint32 PROFILER_mean(PROFILER_HandlerType handler){
+	if(PROFILER_stats[handler].count == 0){
+		return 0;
+	}
+	return (uint32)(PROFILER_stats[handler].total/PROFILER_stats[handler].count);
+}
+
+#endif /* PROFILER_ENABLE */
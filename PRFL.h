@@ -0,0 +1,214 @@
+/**
+	\file
+	\brief
+		This is the header file for the interruption profiler. It measures the core cycles
+		spent by each interruption handler of this project with the DWT cycle counter, and
+		keeps count, minimum, maximum, total and a log2 histogram of each handler in a RAM
+		block (PROFILER_stats) that can be read from a debugger or a console.
+		The profiler is only compiled when PROFILER_ENABLE is defined (-DPROFILER_ENABLE);
+		otherwise PROFILER_START, PROFILER_STOP and PROFILER_init expand to nothing, and
+		no RAM or code is used.
+		The cycles of a handler include the cycles of any interruption with higher priority
+		that preempts it. The period between the starts of a PIT handler is also measured, with
+		the counts of its PIT channel (the cycle counter stops while the core sleeps); For
+		PIT0, maximumPeriod - minimumPeriod is the jitter of the DAC sample period.
+		The memory map (PROFILER_memoryMap) records where the handlers, and the code and
+		tables placed in SRAM (RAM_FUNCTION, RAM_TABLE), landed after the link.
+		The benchmarks (PROFILER_benchmarks) record the cost of the sample path stages,
+		measured by the modules at the initialization.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_PRFL_H_
+#define SOURCES_PRFL_H_
+
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*Bins of the histogram; bin n counts the durations with n significant bits (from 2^(n-1) to
+ * 2^n - 1 cycles), and the last bin also counts the longer ones*/
+#define PROFILER_HISTOGRAM_BINS 24
+
+/*! This enumerated constant are used to select the profiled interruption handler*/
+typedef enum {PROFILER_PIT0,  /*!< PIT0_IRQHandler, wave generator samples */
+			  PROFILER_PIT1,  /*!< PIT1_IRQHandler, motor control loop */
+			  PROFILER_PIT2,  /*!< PIT2_IRQHandler, timer wheel (motor stop ramp, password LED) */
+			  PROFILER_PIT3,  /*!< PIT3_IRQHandler, motor scheduler */
+			  PROFILER_PORTA, /*!< PORTA_IRQHandler, SW3 */
+			  PROFILER_PORTB, /*!< PORTB_IRQHandler, keyboard */
+			  PROFILER_PORTC, /*!< PORTC_IRQHandler, SW2 */
+			  PROFILER_DAC0,  /*!< DAC0_IRQHandler, DAC buffer refill */
+			  PROFILER_LPTMR0,/*!< LPTMR0_IRQHandler, overflow of the millisecond time base */
+			  PROFILER_HANDLERS
+			 }PROFILER_HandlerType;
+
+/*Struct that contains the statistics of a handler*/
+typedef struct{
+	/*count, number of times the handler has been executed*/
+	uint32 count;
+	/*minimum, shortest execution (cycles)*/
+	uint32 minimum;
+	/*maximum, longest execution (cycles)*/
+	uint32 maximum;
+	/*total, sum of all the executions (cycles); The mean is total/count*/
+	uint64 total;
+	/*histogram, executions by the number of significant bits of its duration*/
+	uint32 histogram[PROFILER_HISTOGRAM_BINS];
+	/*minimumPeriod, shortest time between the starts of two executions (counts of the timer)*/
+	uint32 minimumPeriod;
+	/*maximumPeriod, longest time between the starts of two executions (counts of the timer)*/
+	uint32 maximumPeriod;
+	/*lastLatency, counts of the timer from its expiry to the start of the last execution*/
+	uint32 lastLatency;
+}PROFILER_StatsType;
+
+/*Entries of the memory map*/
+#define PROFILER_PLACEMENTS 24
+
+/*! This enumerated constant are used to select a memory region of the K64*/
+typedef enum {PROFILER_FLASH,  /*!< Program flash, 0x00000000 to 0x000FFFFF */
+			  PROFILER_SRAM_L, /*!< SRAM lower, 0x1FFF0000 to 0x1FFFFFFF, code bus */
+			  PROFILER_SRAM_U, /*!< SRAM upper, 0x20000000 to 0x2002FFFF, system bus */
+			  PROFILER_OTHER   /*!< Any other address (for example, the host simulator) */
+			 }PROFILER_RegionType;
+
+/*Struct that contains an entry of the memory map*/
+typedef struct{
+	/*name, of the function or table*/
+	const char* name;
+	/*address, where it was linked*/
+	const void* address;
+	/*region, that contains the address*/
+	PROFILER_RegionType region;
+}PROFILER_PlacementType;
+
+/*Entries of the benchmarks*/
+#define PROFILER_BENCHMARKS 16
+
+/*Struct that contains the result of a benchmark*/
+typedef struct{
+	/*name, of the measured function*/
+	const char* name;
+	/*items, measured (samples, events...)*/
+	uint32 items;
+	/*cycles, spent by all the items*/
+	uint32 cycles;
+}PROFILER_BenchmarkType;
+
+#ifdef PROFILER_ENABLE
+
+/*Statistics of each handler*/
+extern volatile PROFILER_StatsType PROFILER_stats[PROFILER_HANDLERS];
+/*Memory map, and its number of entries*/
+extern PROFILER_PlacementType PROFILER_memoryMap[PROFILER_PLACEMENTS];
+extern uint8 PROFILER_memoryMapCount;
+/*Benchmarks, its number of entries, and the results that didn't fit*/
+extern PROFILER_BenchmarkType PROFILER_benchmarks[PROFILER_BENCHMARKS];
+extern uint8 PROFILER_benchmarkCount;
+extern uint8 PROFILER_benchmarkDrops;
+
+/*Takes the cycle counter at the beginning of a handler; It must be the first statement*/
+#define PROFILER_START(handler) uint32 profilerStart = DWT->CYCCNT
+/*Records the cycles spent since PROFILER_START; It must be the last statement*/
+#define PROFILER_STOP(handler) PROFILER_record((handler),DWT->CYCCNT - profilerStart)
+/*Records the period of the handler of a PIT channel, that counts down from LDVAL and loads it again
+ * at the expiry; It must follow PROFILER_START*/
+#define PROFILER_PERIOD(handler,channel) PROFILER_recordPeriod((handler),PIT->CHANNEL[channel].LDVAL + 1,\
+		PIT->CHANNEL[channel].LDVAL - PIT->CHANNEL[channel].CVAL)
+/*Adds a function or a table to the memory map, with its name*/
+#define PROFILER_PLACEMENT(object) PROFILER_place(#object,(const void*)(object))
+/*Runs a benchmark function, that returns the cycles spent by a number of items, and records its
+ * result with a name; The cycle counter must be enabled*/
+#define PROFILER_BENCHMARK(name,items,benchmark) PROFILER_addBenchmark((name),(items),(benchmark))
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function enables the DWT cycle counter, clears the statistics, and adds the
+ 	 	 profiled handlers to the memory map
+ 	 \return void
+ */
+void PROFILER_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function clears the statistics of all the handlers
+ 	 \return void
+ */
+void PROFILER_reset();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function adds an execution to the statistics of a handler
+ 	 \param[in] handler Profiled handler
+ 	 \param[in] cycles Duration of the execution (cycles)
+ 	 \return void
+ */
+void PROFILER_record(PROFILER_HandlerType handler, uint32 cycles);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function adds the period since the previous execution of a timer handler to its
+ 	 	 statistics: the timer period, plus the change of the latency from the expiry to the start
+ 	 	 of the handler
+ 	 \param[in] handler Profiled handler
+ 	 \param[in] timerPeriod Counts of the timer between two expiries
+ 	 \param[in] latency Counts of the timer from its last expiry to the start of the handler
+ 	 \return void
+ */
+void PROFILER_recordPeriod(PROFILER_HandlerType handler, uint32 timerPeriod, uint32 latency);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function adds an entry to the memory map, if there is room
+ 	 \param[in] name Name of the function or table
+ 	 \param[in] address Address of the function or table
+ 	 \return void
+ */
+void PROFILER_place(const char* name, const void* address);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function adds the result of a benchmark, if there is room; Otherwise, it is
+ 	 	 counted in PROFILER_benchmarkDrops
+ 	 \param[in] name Name of the measured function
+ 	 \param[in] items Items measured
+ 	 \param[in] cycles Cycles spent by all the items
+ 	 \return void
+ */
+void PROFILER_addBenchmark(const char* name, uint32 items, uint32 cycles);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the mean duration of the executions of a handler
+ 	 \param[in] handler Profiled handler
+ 	 \return Mean duration (cycles), 0 if the handler hasn't been executed
+ */
+uint32 PROFILER_mean(PROFILER_HandlerType handler);
+
+#else
+
+#define PROFILER_START(handler)
+#define PROFILER_STOP(handler)
+#define PROFILER_PERIOD(handler,channel)
+#define PROFILER_PLACEMENT(object)
+#define PROFILER_BENCHMARK(name,items,benchmark)
+#define PROFILER_init()
+
+#endif /* PROFILER_ENABLE */
+
+#endif /* SOURCES_PRFL_H_ */
@@ -12,10 +12,11 @@
 #include "PSSWRD.h"
 #include "KYBRD.h"
 #include "WVGN.h"
-#include "PIT.h"
 #include "GPIO.h"
 #include "NVIC.h"
 #include "MTRCTRL.h"
+#include "TMRWHL.h"
+#include "PWRGOV.h"
 
 #define MASTER_PROCESS 0x00000001
 #define MOTOR_CONTROL_PROCESS 0x00000002
@@ -26,11 +27,9 @@
 #define MOTOR_CONTROL_CODE 0x0000D59E
 /*Wave generator code representation in hexadecimal (7890)*/
 #define WAVE_GENERATOR_CODE 0x0000E6A4
-/*System clock to be used in this process*/
-#define SYSTEM_CLOCK 21000000
 /*Delay to be used in this process, in order to turn on or off for 1 second periods, the LEDs
  * that indicate if the password was right or wrong*/
-#define DELAY 2
+#define DELAY_MS 1000
 /*struct that specifies currentData in the Password process (detailed in PSSWRD.h)*/
 static Password_FlagsData password_flagsData = {
 		/*Button pressed counter, starts in 0*/
@@ -50,36 +49,24 @@ static Password_FlagsData password_flagsData = {
 		/*The LED that will be taken on account, will be the correct password LED*/
 		BIT_ON
 };
+/*logical timer that blinks the LEDs that indicate if the password was right or wrong*/
+static TIMERWHEEL_TimerType ledTimer;
+
+/*Attends a key event, only the code of the key is used*/
+static void PASSWORD_keyEvent(const KEYBOARD_EventType* event){
+	PASSWORD_getNewData(event->code);
+}
 
 void PASSWORD_init(){
 	/*Initializes Keyboard peripheral*/
 	KEYBOARD_init();
+	/*The keys are received in PASSWORD_getNewData*/
+	KEYBOARD_setHandler(PASSWORD_keyEvent);
 
-	/*Sets the configuration needed to use the PORTB pins as MUX1*/
-	GPIO_pinControlRegisterType pinControlRegisterPORTB = GPIO_MUX1;
-	/*Sets PORTB pin 18, with the funcionality of MUX_1*/
-	GPIO_pinControlRegister(GPIOB,BIT18,&pinControlRegisterPORTB);
-	/*Sets PORTB pin 19, with the funcionality of MUX_1*/
-	GPIO_pinControlRegister(GPIOB,BIT19,&pinControlRegisterPORTB);
-	/*Sets LEDincorrect as turned off*/
-	GPIO_clearPIN(GPIOB,BIT18); //LEDincorrect
-	/*Sets LEDcorrect as turned off*/
-	GPIO_clearPIN(GPIOB,BIT19); //LEDcorrect
-	/*Sets PORT B pin 18 as an output*/
-	GPIO_dataDirectionPIN(GPIOB,GPIO_OUTPUT,BIT18); //LEDincorrect
-	/*Sets PORT B pin 19 as an output*/
-	GPIO_dataDirectionPIN(GPIOB,GPIO_OUTPUT,BIT19); //LEDcorrect
-
-	/*Enables PIT*/
- 	PIT_enable();
-
- 	/*Enables the interruption for PIT channel 3, with priority 10
- 	 * This PIT channel is in charge of blinking the LEDs for 1 second
- 	 * */
-	NVIC_enableInterruptAndPriority(PIT_CH3_IRQ, PRIORITY_10);
-
-	/*Set a delay to PIT channel 3*/
-	PIT_delay(PIT_3,SYSTEM_CLOCK,DELAY);
+	/*The LEDincorrect (PTB18) and LEDcorrect (PTB19) pins are configured by BOARDCONFIG_init*/
+
+	/*The LED timer is in charge of blinking the LEDs for 1 second*/
+	TIMERWHEEL_timerInit(&ledTimer,PASSWORD_ledCorrectPassword);
 }
 
 void PASSWORD_stateMachine(){
@@ -154,10 +141,14 @@ void PASSWORD_stateMachine(){
 
 			/*If the currentCode equals the MOTOR_CONTROL_CODE, and if ..*/
 			password_flagsData.processMotorStart = (password_flagsData.processMotorStart)?(BIT_OFF):(BIT_ON);
+			/*The RUN clocks are selected before the process is enabled, and VLPR may be selected after
+			 * it is disabled*/
 			if(password_flagsData.processMotorStart){
+				POWERGOVERNOR_processEnabled(POWERGOVERNOR_MOTORCONTROL,TRUE);
 				MOTORCONTROL_enable();
 			} else {
 				MOTORCONTROL_disable();
+				POWERGOVERNOR_processEnabled(POWERGOVERNOR_MOTORCONTROL,FALSE);
 			}
 		} else {
 
@@ -200,9 +191,11 @@ void PASSWORD_stateMachine(){
 			 * "toogled", if the process was enabled, now will be disabled, and vice versa*/
 			password_flagsData.processWaveGenStart = (password_flagsData.processWaveGenStart)?(BIT_OFF):(BIT_ON);
 			if(password_flagsData.processWaveGenStart){
+				POWERGOVERNOR_processEnabled(POWERGOVERNOR_WAVEGEN,TRUE);
 				WAVEGEN_enable();
 			} else {
 				WAVEGEN_disable();
+				POWERGOVERNOR_processEnabled(POWERGOVERNOR_WAVEGEN,FALSE);
 			}
 
 		} else {
@@ -267,23 +260,22 @@ void PASSWORD_ledCorrectPassword(){
 	/*Verifies which LED should blink, from the ledCorrectAnswerFlag*/
 	if(password_flagsData.ledCorrectAnswerFlag){
 
-		/*toogles led correct (green)*/
-		GPIO_tooglePIN(GPIOB,BIT19); //LEDcorrect
+		/*toogles led correct (green); It is called from the timer wheel interruption*/
+		GPIO_fastTooglePINS(GPIOB,GPIO_PIN_MASK(BIT19)); //LEDcorrect
 	} else {
 		/*toogles led incorrect (red)*/
-		GPIO_tooglePIN(GPIOB,BIT18); //LEDincorrect
+		GPIO_fastTooglePINS(GPIOB,GPIO_PIN_MASK(BIT18)); //LEDincorrect
 	}
 
-	/*Depending on the pitCounter, the PIT is loaded again with a delay value*/
+	/*Depending on the pitCounter, the LED timer keeps running*/
 	if(password_flagsData.pitCounter == 3){
-		PIT_timerInterruptDisable(PIT_3);
+		TIMERWHEEL_stop(&ledTimer);
 		password_flagsData.pitCounter = 0;
 	} else {
-		PIT_delay(PIT_3,SYSTEM_CLOCK,DELAY);
-		/*Enable the timer interruption for PIT channel 3*/
-		PIT_timerInterruptEnable(PIT_3);
-		/*Enables the timer for PIT channel 3*/
-		PIT_timerEnable(PIT_3);
+		/*The LED timer expires each second, until it is stopped*/
+		if(!TIMERWHEEL_isRunning(&ledTimer)){
+			TIMERWHEEL_start(&ledTimer,DELAY_MS,DELAY_MS);
+		}
 		password_flagsData.pitCounter++;
 	}
 }
@@ -33,7 +33,7 @@ typedef struct{
 	/*processWaveGenStart, indicates to the state machine if this process is activated or not, in order to
 	 * enable or disable this process, when requested from user*/
 	uint8 processWaveGenStart :1;
-	/*pitCounter, when a right or wrong full password is obtained, the pitCounter will indicate to the PIT,
+	/*pitCounter, when a right or wrong full password is obtained, the pitCounter will indicate to the LED timer,
 	 * if its needed to start the counter again, in order to blink a LED*/
 	uint8 pitCounter :2;
 	/*ledCorrectAnswerFlag, indicates to the ledCorrectPassword() function, which LED should blink*/
@@ -0,0 +1,87 @@
+/**
+	\file
+	\brief
+		This is the source file for the power governor. Each mode has a clock profile of
+		the clock manager; The time in each mode is measured with the LPTMR time base, that
+		doesn't depend on the bus clock.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "PWRGOV.h"
+#include "CLKMGR.h"
+#include "LPTMR.h"
+#include "DataTypeDefinitions.h"
+
+/*Clock profile of each mode, indexed by POWERGOVERNOR_ModeType*/
+static const CLOCKMANAGER_ProfileType modeProfiles[POWERGOVERNOR_MODES] = {
+		CLOCKMANAGER_PEE_120MHZ, CLOCKMANAGER_VLPR_4MHZ
+};
+
+/*Processes that are enabled*/
+static BooleanType clientEnabled[POWERGOVERNOR_CLIENTS];
+/*Current mode, and time base when it was entered*/
+static POWERGOVERNOR_ModeType currentMode = POWERGOVERNOR_RUN;
+static uint32 modeStart;
+/*Governor statistics*/
+static POWERGOVERNOR_StatsType stats;
+
+static void POWERGOVERNOR_accountTime(){
+	uint32 milliseconds = LPTMR_milliseconds();
+	stats.milliseconds[currentMode] += milliseconds - modeStart;
+	modeStart = milliseconds;
+}
+
+static void POWERGOVERNOR_select(){
+	POWERGOVERNOR_ModeType mode = POWERGOVERNOR_VLPR;
+	uint8 client;
+
+	for(client = 0; client < POWERGOVERNOR_CLIENTS; client++){
+		if(clientEnabled[client]){
+			mode = POWERGOVERNOR_RUN;
+		}
+	}
+	if(mode == currentMode){
+		return;
+	}
+	POWERGOVERNOR_accountTime();
+	CLOCKMANAGER_setProfile(modeProfiles[mode]);
+	currentMode = mode;
+	stats.transitions[mode]++;
+	stats.lastLatency[mode] = CLOCKMANAGER_changeMicroseconds();
+	if(stats.lastLatency[mode] > stats.maximumLatency[mode]){
+		stats.maximumLatency[mode] = stats.lastLatency[mode];
+	}
+}
+
+void POWERGOVERNOR_init(){
+	uint8 index;
+
+	for(index = 0; index < POWERGOVERNOR_CLIENTS; index++){
+		clientEnabled[index] = FALSE;
+	}
+	for(index = 0; index < POWERGOVERNOR_MODES; index++){
+		stats.transitions[index] = 0;
+		stats.lastLatency[index] = 0;
+		stats.maximumLatency[index] = 0;
+		stats.milliseconds[index] = 0;
+	}
+	/*The mode of the profile selected in main*/
+	currentMode = (CLOCKMANAGER_profile() == modeProfiles[POWERGOVERNOR_VLPR])?(POWERGOVERNOR_VLPR):(POWERGOVERNOR_RUN);
+	modeStart = LPTMR_milliseconds();
+	POWERGOVERNOR_select();
+}
+
+void POWERGOVERNOR_processEnabled(POWERGOVERNOR_ClientType client, BooleanType enabled){
+	clientEnabled[client] = enabled;
+	POWERGOVERNOR_select();
+}
+
+POWERGOVERNOR_ModeType POWERGOVERNOR_mode(){
+	return currentMode;
+}
+
+const POWERGOVERNOR_StatsType* POWERGOVERNOR_stats(){
+	POWERGOVERNOR_accountTime();
+	return &stats;
+}
@@ -0,0 +1,88 @@
+/**
+	\file
+	\brief
+		This is the header file for the power governor. It selects the run mode of the MCU
+		with the processes that are enabled by the password process:
+			- RUN (PEE, 120MHz core and 60MHz bus): while the wave generator or the motor
+			  control is enabled, as they need the full bus clock for their timers, DMA, DAC
+			  and PDB.
+			- VLPR (BLPI, 4MHz core and bus): while only the keyboard and the password process
+			  are active; The keys, the LEDs and the timer wheel work with the 4MHz bus clock.
+		The clocks are changed by the clock manager, that calls the modules that load their
+		timers with the bus clock. The transitions, their latency and the time spent in each
+		mode are counted.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_PWRGOV_H_
+#define SOURCES_PWRGOV_H_
+
+#include "DataTypeDefinitions.h"
+
+/*! This enumerated constant are used to select a run mode*/
+typedef enum {POWERGOVERNOR_RUN,  /*!< RUN mode, PEE clock profile */
+			  POWERGOVERNOR_VLPR, /*!< Very low power run mode, BLPI clock profile */
+			  POWERGOVERNOR_MODES
+			 }POWERGOVERNOR_ModeType;
+
+/*! This enumerated constant are used to select a process that needs the RUN mode*/
+typedef enum {POWERGOVERNOR_WAVEGEN,      /*!< Wave generator */
+			  POWERGOVERNOR_MOTORCONTROL, /*!< Motor control */
+			  POWERGOVERNOR_CLIENTS
+			 }POWERGOVERNOR_ClientType;
+
+/*Struct that contains the governor statistics*/
+typedef struct{
+	/*transitions, to each mode*/
+	uint32 transitions[POWERGOVERNOR_MODES];
+	/*lastLatency and maximumLatency, of the transitions to each mode (us)*/
+	uint32 lastLatency[POWERGOVERNOR_MODES];
+	uint32 maximumLatency[POWERGOVERNOR_MODES];
+	/*milliseconds, time spent in each mode; The current mode is updated by POWERGOVERNOR_stats*/
+	uint32 milliseconds[POWERGOVERNOR_MODES];
+}POWERGOVERNOR_StatsType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function clears the statistics, and selects the mode for the processes
+ 	 	 enabled at the start (none, so VLPR). It is called in main after IDLEMANAGER_init
+ 	 	 (that allows VLPR) and the initialization of the processes.
+ 	 \return void
+ */
+void POWERGOVERNOR_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function indicates that a process is enabled or disabled, and changes the
+ 	 	 mode if needed. It is called from the main loop before a process is enabled, so it
+ 	 	 starts with the RUN clocks, and after it is disabled.
+ 	 \param[in] client Process
+ 	 \param[in] enabled TRUE if the process is enabled
+ 	 \return void
+ */
+void POWERGOVERNOR_processEnabled(POWERGOVERNOR_ClientType client, BooleanType enabled);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the current mode
+ 	 \return Run mode
+ */
+POWERGOVERNOR_ModeType POWERGOVERNOR_mode();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function returns the governor statistics
+ 	 \return Pointer to the statistics
+ */
+const POWERGOVERNOR_StatsType* POWERGOVERNOR_stats();
+
+#endif /* SOURCES_PWRGOV_H_ */
@@ -0,0 +1,129 @@
+/**
+	\file
+	\brief
+		This is the source file for the additive synthesizer of the wave generator. The
+		rendering and its sine table are placed in SRAM, with the sample path.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "SNTH.h"
+#include "MIXR.h"
+#include "WVGN.h"
+#include "DataTypeDefinitions.h"
+#include "GlobalFunctions.h"
+
+/*Bits of the phase that select a value of the sine table*/
+#define SYNTH_TABLE_BITS 8
+/*Half of the last bit of the result, added to the accumulator to round instead of truncate*/
+#define SYNTH_ROUNDING (1 << 14)
+
+/*Constant array containing a period of a sine signal, in signed DAC counts (amplitude 2047)*/
+RAM_TABLE static const sint16 sineTable[1 << SYNTH_TABLE_BITS] = {0, 50, 100, 151, 201, 251, 300, 350, 399, 449, 497, 546, 594, 642, 690, 737, 783, 830, 875, 920, 965, 1009, 1052, 1095, 1137, 1179, 1219, 1259, 1299, 1337, 1375, 1411, 1447, 1483, 1517, 1550, 1582, 1614, 1644, 1674, 1702, 1729, 1756, 1781, 1805, 1828, 1850, 1871, 1891, 1910, 1927, 1944, 1959, 1973, 1986, 1997, 2008, 2017, 2025, 2032, 2037, 2041, 2045, 2046, 2047, 2046, 2045, 2041, 2037, 2032, 2025, 2017, 2008, 1997, 1986, 1973, 1959, 1944, 1927, 1910, 1891, 1871, 1850, 1828, 1805, 1781, 1756, 1729, 1702, 1674, 1644, 1614, 1582, 1550, 1517, 1483, 1447, 1411, 1375, 1337, 1299, 1259, 1219, 1179, 1137, 1095, 1052, 1009, 965, 920, 875, 830, 783, 737, 690, 642, 594, 546, 497, 449, 399, 350, 300, 251, 201, 151, 100, 50, 0, -50, -100, -151, -201, -251, -300, -350, -399, -449, -497, -546, -594, -642, -690, -737, -783, -830, -875, -920, -965, -1009, -1052, -1095, -1137, -1179, -1219, -1259, -1299, -1337, -1375, -1411, -1447, -1483, -1517, -1550, -1582, -1614, -1644, -1674, -1702, -1729, -1756, -1781, -1805, -1828, -1850, -1871, -1891, -1910, -1927, -1944, -1959, -1973, -1986, -1997, -2008, -2017, -2025, -2032, -2037, -2041, -2045, -2046, -2047, -2046, -2045, -2041, -2037, -2032, -2025, -2017, -2008, -1997, -1986, -1973, -1959, -1944, -1927, -1910, -1891, -1871, -1850, -1828, -1805, -1781, -1756, -1729, -1702, -1674, -1644, -1614, -1582, -1550, -1517, -1483, -1447, -1411, -1375, -1337, -1299, -1259, -1219, -1179, -1137, -1095, -1052, -1009, -965, -920, -875, -830, -783, -737, -690, -642, -594, -546, -497, -449, -399, -350, -300, -251, -201, -151, -100, -50};
+
+void SYNTH_init(SYNTH_EngineType* engine){
+	uint8 voice;
+
+	/*No frequency, until SYNTH_setFundamental*/
+	engine->tuningWord = 0;
+	for(voice = 0; voice < SYNTH_VOICES; voice++){
+		engine->phases[voice] = 0;
+		SYNTH_setVoice(engine, voice, SYNTH_RATIO(voice + 1), (voice == 0)?(MIXER_UNITY_GAIN):(0));
+	}
+	engine->voices = 1;
+}
+
+void SYNTH_setVoice(SYNTH_EngineType* engine, uint8 voice, uint16 ratio, sint16 amplitude){
+	uint32* amplitudePair = &engine->amplitudePairs[voice/2];
+
+	engine->ratios[voice] = ratio;
+	/*The product overflows 32 bits with ratios above 1, it is done in 64 bits*/
+	engine->increments[voice] = (uint32)(((uint64)engine->tuningWord*ratio) >> 8);
+	/*The odd voices are in the upper half of the pair*/
+	if(voice % 2){
+		*amplitudePair = MIXER_PACK(*amplitudePair, amplitude);
+	} else {
+		*amplitudePair = MIXER_PACK(amplitude, *amplitudePair >> 16);
+	}
+}
+
+void SYNTH_setVoices(SYNTH_EngineType* engine, uint8 voices){
+	/*The pairs rendered can't go past the arrays*/
+	if(voices > SYNTH_VOICES){
+		voices = SYNTH_VOICES;
+	}
+	/*With an odd number, the next voice is rendered with the last one, so it is muted*/
+	if(voices % 2){
+		SYNTH_setVoice(engine, voices, engine->ratios[voices], 0);
+	}
+	engine->voices = voices;
+}
+
+void SYNTH_setFundamental(SYNTH_EngineType* engine, uint32 tuningWord){
+	uint8 voice;
+
+	if(tuningWord == engine->tuningWord){
+		return;
+	}
+	engine->tuningWord = tuningWord;
+	for(voice = 0; voice < SYNTH_VOICES; voice++){
+		engine->increments[voice] = (uint32)(((uint64)tuningWord*engine->ratios[voice]) >> 8);
+	}
+}
+
+RAM_FUNCTION void SYNTH_render(SYNTH_EngineType* engine, sint16* samples, uint8 count){
+	/*accumulators, sum of the voices of each sample (Q15); They start with the rounding*/
+	uint32 accumulators[SYNTH_BLOCK_SIZE];
+	uint8 pair;
+	uint8 sample;
+
+	for(sample = 0; sample < count; sample++){
+		accumulators[sample] = SYNTH_ROUNDING;
+	}
+	for(pair = 0; pair < (engine->voices + 1)/2; pair++){
+		uint32 phase0 = engine->phases[2*pair];
+		uint32 phase1 = engine->phases[2*pair + 1];
+		uint32 increment0 = engine->increments[2*pair];
+		uint32 increment1 = engine->increments[2*pair + 1];
+		uint32 amplitudes = engine->amplitudePairs[pair];
+
+		for(sample = 0; sample < count; sample++){
+			phase0 += increment0;
+			phase1 += increment1;
+			/*Both sine values in a word, multiplied by both amplitudes and accumulated at once*/
+			accumulators[sample] = __SMLAD(__PKHBT(sineTable[phase0 >> (32 - SYNTH_TABLE_BITS)],
+					sineTable[phase1 >> (32 - SYNTH_TABLE_BITS)], 16), amplitudes, accumulators[sample]);
+		}
+		engine->phases[2*pair] = phase0;
+		engine->phases[2*pair + 1] = phase1;
+	}
+	/*From Q15 to DAC counts, saturated to its 12 bits*/
+	for(sample = 0; sample < count; sample++){
+		samples[sample] = (sint16)__SSAT((sint32)accumulators[sample] >> 15, MIXER_DAC_BITS);
+	}
+}
+
+uint32 SYNTH_benchmark(uint8 voices){
+	SYNTH_EngineType engine;
+	sint16 samples[SYNTH_BLOCK_SIZE];
+	/*The rendering is called through a pointer, so it isn't inlined and its samples aren't discarded*/
+	void(*volatile render)(SYNTH_EngineType*, sint16*, uint8) = SYNTH_render;
+	uint32 start;
+	uint8 voice;
+	uint8 block;
+
+	/*Harmonics with decreasing amplitudes, 1/(k*voices) for the harmonic k; Their sum, the harmonic
+	 * number H(voices) over voices, is 1 at most*/
+	SYNTH_init(&engine);
+	for(voice = 0; voice < SYNTH_VOICES; voice++){
+		SYNTH_setVoice(&engine, voice, SYNTH_RATIO(voice + 1), (voice < voices)?(MIXER_Q15(1.0)/((voice + 1)*voices)):(0));
+	}
+	SYNTH_setVoices(&engine, voices);
+	SYNTH_setFundamental(&engine, WAVEGEN_TUNING_WORD(WAVEGEN_DEFAULT_FREQUENCY));
+
+	start = cycleCounter();
+	for(block = 0; block < SYNTH_BENCHMARK_BLOCKS; block++){
+		render(&engine, samples, SYNTH_BLOCK_SIZE);
+	}
+	return cycleCounter() - start;
+}
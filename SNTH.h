@@ -0,0 +1,130 @@
+/**
+	\file
+	\brief
+		This is the header file for the additive synthesizer of the wave generator. It sums
+		up to SYNTH_VOICES sine voices per sample; Each voice has its own phase accumulator,
+		a frequency ratio to the fundamental (the tuning word of the current signal), and an
+		amplitude. It renders blocks of samples ahead of time, out of the interruptions: the
+		wave generator takes the samples of a rendered block, as a source of the mixer.
+		The voices are rendered in pairs with the DSP instructions of the Cortex-M4: the sine
+		values of two voices are packed in a 32 bits word (PKHBT), and SMLAD multiplies them by
+		the packed amplitudes of both and accumulates, in a single instruction.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_SNTH_H_
+#define SOURCES_SNTH_H_
+
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*Maximum number of voices; It must be even, as they are rendered in pairs. With 12 bits sine
+ * values and Q15 amplitudes, the accumulator (32 bits) can't overflow with up to 16 voices*/
+#define SYNTH_VOICES 8
+/*Samples in a block*/
+#define SYNTH_BLOCK_SIZE 32
+/*Frequency ratio of a voice to the fundamental, Q8.8 (up to 255.99)*/
+#define SYNTH_RATIO(ratio) ((uint16)((ratio)*256))
+/*Blocks rendered by SYNTH_benchmark*/
+#define SYNTH_BENCHMARK_BLOCKS 32
+
+/*Struct that contains the voices of a synthesizer*/
+typedef struct{
+	/*phases, phase accumulator of each voice; A full period is 2^32*/
+	uint32 phases[SYNTH_VOICES];
+	/*increments, added to the phase of each voice each sample: the tuning word of the fundamental
+	 * times the ratio of the voice*/
+	uint32 increments[SYNTH_VOICES];
+	/*ratios, frequency of each voice over the fundamental (SYNTH_RATIO)*/
+	uint16 ratios[SYNTH_VOICES];
+	/*amplitudePairs, Q15 amplitudes of the voices, packed in pairs (the even voice in the lower half)*/
+	uint32 amplitudePairs[SYNTH_VOICES/2];
+	/*tuningWord, of the fundamental*/
+	uint32 tuningWord;
+	/*voices, number of voices rendered; With an odd number, the next voice is rendered too, so its
+	 * amplitude is set to 0 by SYNTH_setVoices*/
+	uint8 voices;
+}SYNTH_EngineType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures a synthesizer with a single voice, the fundamental with
+ 	 	 a unity amplitude; The other voices are its harmonics (ratios 2 to SYNTH_VOICES), with
+ 	 	 amplitude 0.
+ 	 \param[out] engine Synthesizer
+ 	 \return void
+ */
+void SYNTH_init(SYNTH_EngineType* engine);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function sets the ratio and the amplitude of a voice. The phase of the voice
+ 	 	 isn't changed. The output is saturated to the 12 bits of the DAC, so the sum of the
+ 	 	 amplitudes of the voices must be up to 1 to avoid clipping.
+ 	 \param[in,out] engine Synthesizer
+ 	 \param[in] voice Voice (0 to SYNTH_VOICES - 1)
+ 	 \param[in] ratio Frequency of the voice over the fundamental (SYNTH_RATIO)
+ 	 \param[in] amplitude Q15 amplitude (MIXER_Q15); A negative one inverts the voice
+ 	 \return void
+ */
+void SYNTH_setVoice(SYNTH_EngineType* engine, uint8 voice, uint16 ratio, sint16 amplitude);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function sets the number of voices that are rendered. A number above
+ 	 	 SYNTH_VOICES is taken as SYNTH_VOICES; With an odd number, the amplitude of the next
+ 	 	 voice is set to 0, as it is rendered in the same pair as the last one.
+ 	 \param[in,out] engine Synthesizer
+ 	 \param[in] voices Number of voices (1 to SYNTH_VOICES)
+ 	 \return void
+ */
+void SYNTH_setVoices(SYNTH_EngineType* engine, uint8 voices);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function sets the frequency of the fundamental; The increments of the voices
+ 	 	 are computed again only if it changed, so it can be called before each block.
+ 	 \param[in,out] engine Synthesizer
+ 	 \param[in] tuningWord Tuning word of the fundamental (WAVEGEN_TUNING_WORD)
+ 	 \return void
+ */
+void SYNTH_setFundamental(SYNTH_EngineType* engine, uint32 tuningWord);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function renders the next samples of the sum of the voices. Each pair of
+ 	 	 voices is accumulated over the whole block, so its phases, increments and amplitudes
+ 	 	 stay in registers; Then the block is saturated to the range of the DAC.
+ 	 \param[in,out] engine Synthesizer
+ 	 \param[out] samples Signed samples, in DAC counts around the middle of the scale
+ 	 \param[in] count Number of samples (1 to SYNTH_BLOCK_SIZE)
+ 	 \return void
+ */
+void SYNTH_render(SYNTH_EngineType* engine, sint16* samples, uint8 count);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function measures the cost of SYNTH_render with the cycle counter, rendering
+ 	 	 SYNTH_BENCHMARK_BLOCKS blocks with a number of voices, in a synthesizer of its own. In
+ 	 	 the host simulator, it runs in the initialization, where the cycle counter counts the
+ 	 	 host instructions, so the result is an instruction count of the host build, only
+ 	 	 useful to compare changes.
+ 	 \param[in] voices Number of voices (1 to SYNTH_VOICES)
+ 	 \return Cycles spent by the SYNTH_BENCHMARK_BLOCKS*SYNTH_BLOCK_SIZE samples
+ */
+uint32 SYNTH_benchmark(uint8 voices);
+
+#endif /* SOURCES_SNTH_H_ */
@@ -0,0 +1,184 @@
+/**
+	\file
+	\brief
+		This is the source file for the software timer wheel. Many logical timers share the
+		PIT channel 2. Each slot of the wheel is a circular doubly linked list, with the slot
+		itself as the head, so a timer is linked or unlinked without searching.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#include "TMRWHL.h"
+#include "PIT.h"
+#include "IDLMGR.h"
+#include "CLKMGR.h"
+#include "NVIC.h"
+#include "DataTypeDefinitions.h"
+#include "MK64F12.h"
+
+/*PIT channel 2 load value for the period of the wheel, with the current bus clock*/
+#define TICK_DELAY PIT_msToTicks(CLOCKMANAGER_busClock(),TIMERWHEEL_TICK_MS)
+/*Mask to get the slot of a tick*/
+#define SLOT_MASK (TIMERWHEEL_SLOTS - 1)
+/*BASEPRI value that masks the PIT channel 2 interruption*/
+#define WHEEL_BASEPRI ((uint32)TIMERWHEEL_PRIORITY << (8 - __NVIC_PRIO_BITS))
+
+/*Slots of the wheel; Only next and previous are used*/
+static TIMERWHEEL_TimerType slots[TIMERWHEEL_SLOTS];
+/*Timers that expired in the current tick, and wait for its callback*/
+static TIMERWHEEL_TimerType expired;
+/*Ticks since the wheel was initialized*/
+static uint32 currentTick = 0;
+/*Timers running, and state of the PIT channel 2*/
+static uint16 runningTimers = 0;
+static BooleanType wheelRunning = FALSE;
+/*Bus clock used for the PIT channel 2 load values*/
+static uint32 wheelClock;
+
+static void TIMERWHEEL_unlink(TIMERWHEEL_TimerType* timer){
+	timer->previous->next = timer->next;
+	timer->next->previous = timer->previous;
+	timer->next = timer;
+	timer->previous = timer;
+}
+
+static void TIMERWHEEL_link(TIMERWHEEL_TimerType* head, TIMERWHEEL_TimerType* timer){
+	/*The timer is added at the end of the list*/
+	timer->next = head;
+	timer->previous = head->previous;
+	head->previous->next = timer;
+	head->previous = timer;
+}
+
+static void TIMERWHEEL_insert(TIMERWHEEL_TimerType* timer, uint32 ticks){
+	/*The slot is visited each TIMERWHEEL_SLOTS ticks; the first visit is in less than one turn*/
+	timer->rounds = (ticks - 1)/TIMERWHEEL_SLOTS;
+	TIMERWHEEL_link(&slots[(currentTick + ticks) & SLOT_MASK], timer);
+}
+
+static uint32 TIMERWHEEL_lock(){
+	/*Masks the PIT channel 2 interruption, unless it is already masked*/
+	uint32 basePri = __get_BASEPRI();
+	if(basePri == 0 || basePri > WHEEL_BASEPRI){
+		__set_BASEPRI(WHEEL_BASEPRI);
+	}
+	return basePri;
+}
+
+static void TIMERWHEEL_clockChanged(){
+	uint32 basePri = TIMERWHEEL_lock();
+	uint32 remaining;
+
+	/*The PIT counter keeps its counts with the new clock, so the rest of the current tick is
+	 * converted, and the channel restarts with it; The period of the wheel, loaded after that,
+	 * is taken at the end of the tick*/
+	if(wheelRunning){
+		remaining = (uint32)((((uint64)PIT_readTimerValue(PIT_2) + 1)*CLOCKMANAGER_busClock())/wheelClock) - 1;
+		PIT_timerDisable(PIT_2);
+		PIT_loadTicks(PIT_2,remaining);
+		PIT_timerEnable(PIT_2);
+	}
+	wheelClock = CLOCKMANAGER_busClock();
+	PIT_loadTicks(PIT_2,TICK_DELAY);
+	__set_BASEPRI(basePri);
+}
+
+void TIMERWHEEL_init(){
+	uint8 slot;
+	for(slot = 0; slot < TIMERWHEEL_SLOTS; slot++){
+		slots[slot].next = &slots[slot];
+		slots[slot].previous = &slots[slot];
+	}
+	expired.next = &expired;
+	expired.previous = &expired;
+
+	/*PIT channel 2, with the period of the wheel; It is enabled by the first timer. The PIT clock
+	 * gating and the NVIC are configured by BOARDCONFIG_init*/
+	PIT_enable();
+	wheelClock = CLOCKMANAGER_busClock();
+	PIT_loadTicks(PIT_2,TICK_DELAY);
+	PIT_timerInterruptEnable(PIT_2);
+	CLOCKMANAGER_addListener(TIMERWHEEL_clockChanged);
+}
+
+void TIMERWHEEL_timerInit(TIMERWHEEL_TimerType* timer, void(*callback)()){
+	timer->next = timer;
+	timer->previous = timer;
+	timer->rounds = 0;
+	timer->period = 0;
+	timer->fptrCallback = callback;
+}
+
+void TIMERWHEEL_start(TIMERWHEEL_TimerType* timer, uint32 milliseconds, uint32 periodMilliseconds){
+	uint32 basePri = TIMERWHEEL_lock();
+	uint32 ticks = TIMERWHEEL_TICKS_FROM_MS(milliseconds);
+
+	if(TIMERWHEEL_isRunning(timer)){
+		TIMERWHEEL_unlink(timer);
+	} else {
+		runningTimers++;
+	}
+	timer->period = TIMERWHEEL_TICKS_FROM_MS(periodMilliseconds);
+	TIMERWHEEL_insert(timer, (ticks)?(ticks):(1));
+
+	/*The PIT channel 2 only runs while there are timers*/
+	if(!wheelRunning){
+		wheelRunning = TRUE;
+		IDLEMANAGER_busClockNeeded(IDLEMANAGER_TIMERWHEEL, TRUE);
+		PIT_timerEnable(PIT_2);
+	}
+	__set_BASEPRI(basePri);
+}
+
+void TIMERWHEEL_stop(TIMERWHEEL_TimerType* timer){
+	uint32 basePri = TIMERWHEEL_lock();
+	if(TIMERWHEEL_isRunning(timer)){
+		TIMERWHEEL_unlink(timer);
+		runningTimers--;
+	}
+	__set_BASEPRI(basePri);
+}
+
+BooleanType TIMERWHEEL_isRunning(const TIMERWHEEL_TimerType* timer){
+	return (timer->next != timer);
+}
+
+void TIMERWHEEL_tick(){
+	TIMERWHEEL_TimerType* head;
+	TIMERWHEEL_TimerType* timer;
+	TIMERWHEEL_TimerType* next;
+
+	currentTick++;
+	head = &slots[currentTick & SLOT_MASK];
+
+	/*The timers of the slot that complete their turns are moved to the expired list; The others
+	 * wait one more turn*/
+	for(timer = head->next; timer != head; timer = next){
+		next = timer->next;
+		if(timer->rounds){
+			timer->rounds--;
+		} else {
+			TIMERWHEEL_unlink(timer);
+			TIMERWHEEL_link(&expired, timer);
+		}
+	}
+
+	/*The callbacks can start or stop any timer, even the ones still in the expired list, so the
+	 * list is emptied one timer at a time*/
+	while(expired.next != &expired){
+		timer = expired.next;
+		TIMERWHEEL_unlink(timer);
+		if(timer->period){
+			TIMERWHEEL_insert(timer, timer->period);
+		} else {
+			runningTimers--;
+		}
+		timer->fptrCallback();
+	}
+
+	if(runningTimers == 0){
+		wheelRunning = FALSE;
+		PIT_timerDisable(PIT_2);
+		IDLEMANAGER_busClockNeeded(IDLEMANAGER_TIMERWHEEL, FALSE);
+	}
+}
@@ -0,0 +1,108 @@
+/**
+	\file
+	\brief
+		This is the header file for the software timer wheel. Many logical timers share the
+		PIT channel 2, that interrupts each TIMERWHEEL_TICK_MS while any timer is running.
+		The timers are kept in a hashed wheel of TIMERWHEEL_SLOTS lists: a timer is stored in
+		the slot of its expiration tick, with the number of wheel turns left, so starting,
+		stopping and expiring a timer are O(1). The callbacks are called from the PIT channel 2
+		interruption, with priority TIMERWHEEL_PRIORITY.
+	\author Patricio Gomez Garca
+	\date	18/10/2026
+ */
+
+#ifndef SOURCES_TMRWHL_H_
+#define SOURCES_TMRWHL_H_
+
+#include "DataTypeDefinitions.h"
+#include "NVIC.h"
+
+/*Period of the wheel (ms); It is the resolution of the timers*/
+#define TIMERWHEEL_TICK_MS 10
+/*Slots of the wheel; It must be a power of two*/
+#define TIMERWHEEL_SLOTS 64
+/*Priority of the PIT channel 2 interruption, where the callbacks are called*/
+#define TIMERWHEEL_PRIORITY PRIORITY_10
+/*Conversion from ms to ticks of the wheel, rounded up*/
+#define TIMERWHEEL_TICKS_FROM_MS(milliseconds) (((uint32)(milliseconds) + TIMERWHEEL_TICK_MS - 1)/TIMERWHEEL_TICK_MS)
+
+/*Struct that contains a logical timer; It must be kept by its user (static), and initialized
+ * with TIMERWHEEL_timerInit before being started*/
+typedef struct TIMERWHEEL_Timer{
+	/*next and previous, timers in the same slot of the wheel; Both point to the timer itself
+	 * when it isn't running*/
+	struct TIMERWHEEL_Timer* next;
+	struct TIMERWHEEL_Timer* previous;
+	/*rounds, turns of the wheel left before the expiration*/
+	uint32 rounds;
+	/*period, ticks to start the timer again after each expiration; 0 for a single expiration*/
+	uint32 period;
+	/*fptrCallback, function called when the timer expires*/
+	void(*fptrCallback)();
+}TIMERWHEEL_TimerType;
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function configures the PIT channel 2 with the period of the wheel, and its
+ 	 	 interruption. The channel only runs while any timer is running.
+ 	 \return void
+ */
+void TIMERWHEEL_init();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function initializes a logical timer, stopped
+ 	 \param[in] timer Timer to be initialized
+ 	 \param[in] callback Function called when the timer expires
+ 	 \return void
+ */
+void TIMERWHEEL_timerInit(TIMERWHEEL_TimerType* timer, void(*callback)());
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function starts a logical timer; If it was running, it starts again
+ 	 \param[in] timer Timer to be started
+ 	 \param[in] milliseconds Time until the first expiration (at least one tick); As the timer
+ 	 	 starts between two ticks, it can expire up to one tick earlier
+ 	 \param[in] periodMilliseconds Time between the next expirations; 0 for a single expiration
+ 	 \return void
+ */
+void TIMERWHEEL_start(TIMERWHEEL_TimerType* timer, uint32 milliseconds, uint32 periodMilliseconds);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function stops a logical timer; Its callback won't be called
+ 	 \param[in] timer Timer to be stopped
+ 	 \return void
+ */
+void TIMERWHEEL_stop(TIMERWHEEL_TimerType* timer);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function indicates if a logical timer is running
+ 	 \param[in] timer Timer
+ 	 \return TRUE if the timer is running
+ */
+BooleanType TIMERWHEEL_isRunning(const TIMERWHEEL_TimerType* timer);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief This function moves the wheel one tick, and calls the callbacks of the timers that
+ 	 	 expire. It is invoked from the PIT channel 2 interruption.
+ 	 \return void
+ */
+void TIMERWHEEL_tick();
+
+#endif /* SOURCES_TMRWHL_H_ */
@@ -12,183 +12,453 @@
 #include "NVIC.h"
 #include "PIT.h"
 #include "DAC.h"
+#include "DMA.h"
+#include "PDB.h"
 #include "DataTypeDefinitions.h"
 #include "MK64F12.h"
 #include "GlobalFunctions.h"
+#include "PRFL.h"
+#include "EVNTQ.h"
+#include "IDLMGR.h"
+#include "CLKMGR.h"
+#include "MIXR.h"
+#include "SNTH.h"
 
-/*System clock 21MHz*/
-#define SYSTEM_CLOCK 21000000
-/*Needed delay to show the samples of a sine/square/triangle signal of 5Hz*/
-#define DELAY 0.004878*2
+/*The delays are computed with the current bus clock (PIT and PDB), when the generator is enabled and
+ * after each clock change*/
+/*Needed delay to show the samples of a sine/square/triangle signal of 5Hz, in the DMA mode (4.878ms)*/
+#define DELAY PIT_usToTicks(CLOCKMANAGER_busClock(),4878)
+/*Needed delay for the sample clock of the phase accumulator*/
+#define SAMPLE_DELAY PIT_TICKS_FROM_HZ(CLOCKMANAGER_busClock(),WAVEGEN_SAMPLE_RATE)
+/*PDB counts between DAC triggers in the buffered mode, with the bus clock divided by 2*/
+#define PDB_INTERVAL (uint16)(CLOCKMANAGER_busClock()/(2*WAVEGEN_SAMPLE_RATE))
+/*Half of the DAC buffer, loaded each DAC0 interruption in the buffered mode*/
+#define DAC_BUFFER_HALF (DAC_BUFFER_SIZE/2)
+/*LED1 and LED2 of this process, in PORT C*/
+#define LED1_MASK GPIO_PIN_MASK(BIT10)
+#define LED2_MASK GPIO_PIN_MASK(BIT11)
 
+/*The arrays are read by each sample (PIT0, DAC0 and DMA), so they are placed in SRAM (RAM_TABLE)*/
 /*Constant array containing the values of a period of a square signal of 5Hz, this values will be loaded in the
  * DAC*/
-static const uint16 squareSignalValues[41] = {4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4095};
+RAM_TABLE static const uint16 squareSignalValues[WAVEGEN_NUMBER_OF_SAMPLES] = {4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 4095};
 /*Constant array containing the values of a period of a sine signal of 5Hz, this values will be loaded in the
  * DAC*/
-static const uint16 sineSignalValues[41] = {2048, 2368, 2680, 2977, 3251, 3495, 3704, 3872, 3995, 4070, 4095, 4070, 3995, 3872, 3704, 3495, 3251, 2977, 2680, 2368, 2048, 1727, 1415, 1118, 844, 600, 391, 223, 100, 25, 0, 25, 100, 223, 391, 600, 844, 1118, 1415, 1727, 2047};
+RAM_TABLE static const uint16 sineSignalValues[WAVEGEN_NUMBER_OF_SAMPLES] = {2048, 2368, 2680, 2977, 3251, 3495, 3704, 3872, 3995, 4070, 4095, 4070, 3995, 3872, 3704, 3495, 3251, 2977, 2680, 2368, 2048, 1727, 1415, 1118, 844, 600, 391, 223, 100, 25, 0, 25, 100, 223, 391, 600, 844, 1118, 1415, 1727, 2047};
 /*Constant array containing the values of a period of a triangle signal of 5Hz, this values will be loaded in the
  * DAC*/
-static const uint16 triangleSignalValues[41] = {0, 205, 409, 614, 819, 1024, 1228, 1433, 1638, 1843, 2048, 2252, 2457, 2662, 2867, 3071, 3276, 3481, 3685, 3890, 4095, 3890, 3685, 3481, 3276, 3071, 2866, 2662, 2457, 2252, 2047, 1843, 1638, 1433, 1229, 1024, 819, 614, 409, 205, 0};
+RAM_TABLE static const uint16 triangleSignalValues[WAVEGEN_NUMBER_OF_SAMPLES] = {0, 205, 409, 614, 819, 1024, 1228, 1433, 1638, 1843, 2048, 2252, 2457, 2662, 2867, 3071, 3276, 3481, 3685, 3890, 4095, 3890, 3685, 3481, 3276, 3071, 2866, 2662, 2457, 2252, 2047, 1843, 1638, 1433, 1229, 1024, 819, 614, 409, 205, 0};
 
 /*
  * Linked State machine, with three states (SQUARE, SINE, TRIANGLE), each state contains the next state direction
- * the function WAVEGEN_ledSequence, the direction of the array containing the values to be loaded to the DAC, and the
- * LED1 and LED2 status
+ * the function WAVEGEN_ledSequence, the direction of the array containing the values to be loaded to the DAC, the
+ * tuning word for its frequency, and the LED1 and LED2 status
  */
 static waveGeneratorState waveGenState[3] = {
-		{SINE_SIGNAL,WAVEGEN_ledSequence,WAVEGEN_changeSequence,SQUARE_SIGNAL_INDEX,BIT_OFF,BIT_ON},
-		{TRIANGLE_SIGNAL,WAVEGEN_ledSequence,WAVEGEN_changeSequence,SINE_SIGNAL_INDEX,BIT_ON,BIT_OFF},
-		{SQUARE_SIGNAL,WAVEGEN_ledSequence,WAVEGEN_changeSequence,TRIANGLE_SIGNAL_INDEX,BIT_ON,BIT_ON}
+		{SINE_SIGNAL,WAVEGEN_ledSequence,WAVEGEN_changeSequence,SQUARE_SIGNAL_INDEX,WAVEGEN_TUNING_WORD(WAVEGEN_DEFAULT_FREQUENCY),BIT_OFF,BIT_ON},
+		{TRIANGLE_SIGNAL,WAVEGEN_ledSequence,WAVEGEN_changeSequence,SINE_SIGNAL_INDEX,WAVEGEN_TUNING_WORD(WAVEGEN_DEFAULT_FREQUENCY),BIT_ON,BIT_OFF},
+		{SQUARE_SIGNAL,WAVEGEN_ledSequence,WAVEGEN_changeSequence,TRIANGLE_SIGNAL_INDEX,WAVEGEN_TUNING_WORD(WAVEGEN_DEFAULT_FREQUENCY),BIT_ON,BIT_ON}
 };
 
 /*currentState, will indicate to this file, what values to take to the DAC, which LED configuration to take, etc.*/
 static waveGeneratorState* currentState;
-/*index_shift, will shift the index in the arrays containing the values to be loaded in the DAC, to generate the
- * desired signal*/
-uint8 index_shift = 0;
+/*phaseAccumulator, is the phase of the output signal; a full period of the signal is 2^32. Its upper bits
+ * select the value in the arrays containing the values to be loaded in the DAC*/
+static uint32 phaseAccumulator = 0;
+/*outputMode, indicates if the values are loaded to the DAC by the PIT channel 0 interruption, or by the DMA*/
+static WAVEGEN_OutputModeType outputMode = WAVEGEN_OUTPUT_MODE;
+/*secondChannelValues and secondChannelOffset, array of values and phase offset of the second channel (source 1
+ * of the mixer, the DAC1 in the dual mode); Its phase is the phase accumulator plus the offset. They are set
+ * by WAVEGEN_init*/
+static const uint16* secondChannelValues;
+static uint32 secondChannelOffset;
+/*samplePairs, samples of the mixer sources: the signal of the sequence (source 0), the second channel
+ * (source 1) and the synthesizer (source 2); The other sources are 0*/
+static uint32 samplePairs[MIXER_SOURCES/2];
+/*synthesizer, additive synthesizer with the frequency of the current signal*/
+static SYNTH_EngineType synthesizer;
+/*synthBlocks, blocks of samples of the synthesizer: one is taken by the sample path, while the other one
+ * is rendered in the main loop*/
+static sint16 synthBlocks[2][SYNTH_BLOCK_SIZE];
+/*synthReady, the block was rendered after it was taken the last time*/
+static volatile BooleanType synthReady[2];
+/*synthBlock and synthSample, block and sample that the sample path takes next*/
+static uint8 synthBlock = 0;
+static uint8 synthSample = 0;
+/*synthUnderruns, blocks that the sample path started to take before they were rendered*/
+static uint32 synthUnderruns = 0;
 
+/*Configuration of DMA channel 0 for the DMA mode; Each request copies one 16 bit value from the signal array
+ * to the DAC0 data register (DAT0L and DAT0H are written at once), and when the period is completed, the source
+ * goes back to the beginning of the array*/
+static const DMA_TransferConfigType waveGenDmaConfig = {
+		/*The source is changed with the current state, when the sequence changes*/
+		TRIANGLE_SIGNAL_INDEX,
+		&DAC0_DAT0L,
+		sizeof(uint16),
+		0,
+		DMA_TRANSFER_16BIT,
+		sizeof(uint16),
+		WAVEGEN_NUMBER_OF_SAMPLES,
+		-(sint32)(WAVEGEN_NUMBER_OF_SAMPLES*sizeof(uint16)),
+		0,
+		FALSE
+};
+
+
+static void WAVEGEN_clockChanged(){
+	/*The sample clock keeps its frequency with the new bus clock; The PIT channel 0 takes the load
+	 * value at the end of the current period, and the PDB at once*/
+	if(outputMode == WAVEGEN_DMA_MODE){
+		PIT_loadTicks(PIT_0,DELAY);
+	} else if(outputMode == WAVEGEN_BUFFERED_MODE){
+		PDB_dacTriggerInterval(PDB_INTERVAL);
+	} else {
+		PIT_loadTicks(PIT_0,SAMPLE_DELAY);
+	}
+}
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function renders a block of the synthesizer, with the frequency of the current signal. It is
+ 	 	 called from the main loop, when the sample path has taken the block.
+ 	 \param[in] block Block to be rendered (0 or 1)
+ 	 \return void
+
+ */
+static void WAVEGEN_renderBlock(uint8 block){
+	SYNTH_setFundamental(&synthesizer,currentState->tuningWord);
+	SYNTH_render(&synthesizer,synthBlocks[block],SYNTH_BLOCK_SIZE);
+	synthReady[block] = TRUE;
+}
 
 void WAVEGEN_init(){
 
-	/*Enables the clock gating for PORT A, in order to use the SW3*/
-	GPIO_clockGating(GPIOA);
-	/*Sets the configuration needed to use the SW3*/
-	GPIO_pinControlRegisterType pinControlRegisterPORTA = GPIO_MUX1|GPIO_PS|GPIO_PE|INTR_FALLING_EDGE;
-	/*Sets PORT A pin 4, with the functionality of MUX_1, as a pull up resistor, pull enable, and the interruption
-	 * actives with the falling edge*/
-	GPIO_pinControlRegister(GPIOA,BIT4,&pinControlRegisterPORTA);
-	/*Sets PORT A pin 4 as an input (SW3)*/
-	GPIO_dataDirectionPIN(GPIOA,GPIO_INPUT,BIT4);
-
-	/*Enables the clock gating for PORT C, in order to use pin 10 and 11 as outputs for LEDS 1 and 2*/
-	GPIO_clockGating(GPIOC);
-	/*Sets the configuration needed to use the PORTC pins as MUX1*/
-	GPIO_pinControlRegisterType pinControlRegisterPORTC = GPIO_MUX1;
-	/*Sets PORTC pin 10, with the funcionality of MUX_1*/
-	GPIO_pinControlRegister(GPIOC,BIT10,&pinControlRegisterPORTC);
-	/*Sets PORTC pin 11, with the funcionality of MUX_1*/
-	GPIO_pinControlRegister(GPIOC,BIT11,&pinControlRegisterPORTC);
-	/*Sets LED1 as turned off*/
-	GPIO_clearPIN(GPIOC,BIT10); //LED1
-	/*Sets LED2 as turned off*/
-	GPIO_clearPIN(GPIOC,BIT11); //LED2
-	/*Sets PORT C pin 10 as an output*/
-	GPIO_dataDirectionPIN(GPIOC,GPIO_OUTPUT,BIT10);
-	/*Sets PORT C pin 11 as an output*/
-	GPIO_dataDirectionPIN(GPIOC,GPIO_OUTPUT,BIT11);
-
-	/*Sets the PIT channel 0 interruption, a priority of 9, but doesn't enable the interruption*/
-	NVIC_SetPriority(PIT_CH0_IRQ, PRIORITY_9);
-	/*Sets the PORT A interruption, a priority of 9, but doesn't enable the interruption*/
-	NVIC_SetPriority(PORTA_IRQ, PRIORITY_10);
-
-	/*Initializes the DAC*/
-	DAC_init();
-	/*Disables de DAC; The DAC is initialized, but disabled*/
-	DAC_disable();
-	/*Enables the PIT clock Gating*/
-	PIT_clockGating();
+	/*SW3 presses are attended in the main loop, masking the same interruptions as PORTA_IRQHandler*/
+	EVENTQUEUE_setHandler(EVENTQUEUE_SW3,WAVEGEN_switchPressed,PRIORITY_10);
+	/*The blocks of the synthesizer are rendered in the main loop, without masking the sample path*/
+	EVENTQUEUE_setHandler(EVENTQUEUE_SYNTH,WAVEGEN_renderBlock,PRIORITY_15);
+	/*The PIT channel 0 and the PDB count with the bus clock*/
+	CLOCKMANAGER_addListener(WAVEGEN_clockChanged);
+
+	/*Code and tables of the sample path, placed in SRAM*/
+	PROFILER_PLACEMENT(WAVEGEN_sendToDac);
+	PROFILER_PLACEMENT(WAVEGEN_indexShifting);
+	PROFILER_PLACEMENT(WAVEGEN_bufferRefill);
+	PROFILER_PLACEMENT(PIT0_clearInterrupt);
+	PROFILER_PLACEMENT(DAC_bufferClearFlags);
+	PROFILER_PLACEMENT(squareSignalValues);
+	PROFILER_PLACEMENT(sineSignalValues);
+	PROFILER_PLACEMENT(triangleSignalValues);
+	PROFILER_PLACEMENT(SYNTH_render);
+
+	/*The second channel given at build time (the sine at +90 degrees, unless it is changed)*/
+	WAVEGEN_setSecondChannel(WAVEGEN_SECOND_SIGNAL,WAVEGEN_PHASE_DEGREES(WAVEGEN_SECOND_PHASE));
+	/*Each DAC passes its source as it is, until the gains and offsets are changed*/
+	MIXER_init();
+	/*The synthesizer is only mixed in the DAC0 with the gain given at build time*/
+	MIXER_setGain(MIXER_DAC0,WAVEGEN_SYNTH_SOURCE,WAVEGEN_SYNTH_GAIN);
+	PROFILER_BENCHMARK("MIXER_output",MIXER_BENCHMARK_SAMPLES,MIXER_benchmark());
+	/*The synthesizer starts with the fundamental only; Its cost with 1, 4 and 8 voices*/
+	SYNTH_init(&synthesizer);
+	PROFILER_BENCHMARK("SYNTH_render(1)",SYNTH_BENCHMARK_BLOCKS*SYNTH_BLOCK_SIZE,SYNTH_benchmark(1));
+	PROFILER_BENCHMARK("SYNTH_render(4)",SYNTH_BENCHMARK_BLOCKS*SYNTH_BLOCK_SIZE,SYNTH_benchmark(4));
+	PROFILER_BENCHMARK("SYNTH_render(8)",SYNTH_BENCHMARK_BLOCKS*SYNTH_BLOCK_SIZE,SYNTH_benchmark(8));
+
+	/*Initializes the DACs; The DAC1 is only used by the dual mode*/
+	DAC_init(DAC_0);
+	DAC_init(DAC_1);
+	/*Disables de DACs; The DACs are initialized, but disabled*/
+	DAC_disable(DAC_0);
+	DAC_disable(DAC_1);
+	/*The SW3, LED1 and LED2 pins, the interruption priorities, and the PIT, DMA and PDB clock
+	 * gating are configured by BOARDCONFIG_init*/
+}
 
+void WAVEGEN_setOutputMode(WAVEGEN_OutputModeType mode){
+	outputMode = mode;
+}
+
+BooleanType WAVEGEN_setFrequency(WAVEGEN_SignalType signal, uint32 milliHertz){
+	/*From half of the sample rate on, the signal aliases, and the tuning word overflows further on*/
+	if(signal > WAVEGEN_TRIANGLE || milliHertz >= WAVEGEN_MAX_FREQUENCY){
+		return FALSE;
+	}
+	/*A single 32 bits write; the phase accumulator isn't touched, so the output continues from the same
+	 * phase with the new frequency*/
+	waveGenState[signal].tuningWord = WAVEGEN_TUNING_WORD(milliHertz);
+	return TRUE;
+}
 
+void WAVEGEN_setSecondChannel(WAVEGEN_SignalType signal, uint32 phaseOffset){
+	/*Two 32 bits writes; A sample between them takes the new array with the old offset*/
+	secondChannelValues = waveGenState[signal].current_index;
+	secondChannelOffset = phaseOffset;
+}
+
+void WAVEGEN_setVoice(uint8 voice, uint16 ratio, sint16 amplitude){
+	SYNTH_setVoice(&synthesizer,voice,ratio,amplitude);
+}
+
+void WAVEGEN_setVoices(uint8 voices){
+	SYNTH_setVoices(&synthesizer,voices);
+}
+
+uint32 WAVEGEN_synthUnderruns(){
+	return synthUnderruns;
 }
 
 void WAVEGEN_enable(){
-	/*Enables the DAC*/
-	DAC_enable();
-	/*Enables the PIT*/
-	PIT_enable();
-	/*Set the delay for PIT*/
-	PIT_delay(PIT_0,SYSTEM_CLOCK,DELAY);
-	/*Enable the timer PIT channel 0*/
-	PIT_timerEnable(PIT_0);
+	/*index used to fill the DAC buffer*/
+	uint8 bufferIndex;
+
+	/*The PIT, DMA, DAC and PDB need the bus clock, so the MCU can't sleep in VLPS*/
+	IDLEMANAGER_busClockNeeded(IDLEMANAGER_WAVEGEN, TRUE);
+
+	/*Enables the DAC, and the DAC1 for the second channel of the dual mode*/
+	DAC_enable(DAC_0);
+	if(outputMode == WAVEGEN_DUAL_MODE){
+		DAC_enable(DAC_1);
+	}
+	/*The PIT module was enabled by TIMERWHEEL_init*/
+	/*Set the delay for PIT; The DMA mode sends the arrays as they are, the other modes use the sample clock*/
+	if(outputMode == WAVEGEN_DMA_MODE){
+		PIT_loadTicks(PIT_0,DELAY);
+	} else {
+		PIT_loadTicks(PIT_0,SAMPLE_DELAY);
+	}
+	/*The signal starts from phase 0*/
+	phaseAccumulator = 0;
 	/*Enables the interruption in PORT A; Before this, the SW3 wasn't take on account*/
 	NVIC_EnableIRQ(PORTA_IRQ);
 	/*Sets as current State, a triangle signal, so when the SW3 is pressed, and it actually starts to
 	 * produce the wave output, currentState is square signal*/
 	currentState = TRIANGLE_SIGNAL;
-	/*Enables the PIT timer interrupt for channel 0*/
-	PIT_timerInterruptEnable(PIT_0);
+	/*Both blocks of the synthesizer are rendered before the first sample*/
+	synthBlock = 0;
+	synthSample = 0;
+	WAVEGEN_renderBlock(0);
+	WAVEGEN_renderBlock(1);
+	if(outputMode == WAVEGEN_DMA_MODE){
+		/*DMA channel 0 is triggered by PIT channel 0, but its requests aren't enabled until the SW3 is pressed*/
+		DMA_requestDisable(DMA_CH0);
+		DMA_muxConfig(DMA_CH0,DMA_SOURCE_ALWAYS_ENABLED,TRUE);
+		DMA_channelConfig(DMA_CH0,&waveGenDmaConfig);
+		/*The PIT channel 0 interruption isn't needed*/
+		PIT_timerInterruptDisable(PIT_0);
+	} else if(outputMode == WAVEGEN_BUFFERED_MODE){
+		/*The PIT channel 0 isn't needed, the DAC is triggered by the PDB*/
+		PIT_timerInterruptDisable(PIT_0);
+		PIT_timerDisable(PIT_0);
+		/*The buffer starts with an output of 0, until the SW3 is pressed*/
+		DAC_bufferInit(DAC_0,DAC_BUFFER_NORMAL,DAC_WATERMARK_4_WORDS,DAC_BUFFER_SIZE - 1,DAC_TRIGGER_HARDWARE);
+		for(bufferIndex = 0; bufferIndex < DAC_BUFFER_SIZE; bufferIndex++){
+			DAC_bufferLoadValue(DAC_0,bufferIndex,0);
+		}
+		/*When the read pointer is zero, the upper half was sent; when it reaches the watermark (4 words before
+		 * the end), the lower half was sent*/
+		DAC_bufferInterruptEnable(DAC_0,DAC_BUFFER_TOP | DAC_BUFFER_WATERMARK);
+		PDB_dacTriggerInit(PDB_PRESCALER_2,PDB_INTERVAL);
+		PDB_start();
+		/*Green RGB led, and the buffered mode doesn't use the PIT*/
+		GPIO_clearPIN(GPIOE,BIT26); //LED RGB VERDE
+		return;
+	} else {
+		/*Enables the PIT timer interrupt for channel 0, in the ISR and dual modes*/
+		PIT_timerInterruptEnable(PIT_0);
+	}
+	/*Enable the timer PIT channel 0*/
+	PIT_timerEnable(PIT_0);
 	/*RGB green led, is on*/
 	GPIO_clearPIN(GPIOE,BIT26); //LED RGB VERDE
 
 }
 
 void WAVEGEN_disable(){
-	/*Disable the PIT channel 0 interruption*/
+	/*Disable the PIT channel 0 interruption, and stops the sample clock*/
 	NVIC_DisableIRQ(PIT_CH0_IRQ);
+	PIT_timerDisable(PIT_0);
 	/*Disable the PORT A interruption*/
 	NVIC_DisableIRQ(PORTA_IRQ);
-	/*Loads to the DAC, an output value of 0*/
-	DAC_loadValues(0);
-	/*Disables the DAC*/
-	DAC_disable();
+	/*Stops the DMA transfers to the DAC*/
+	DMA_requestDisable(DMA_CH0);
+	/*Disable the DAC0 interruption, the PDB and the DAC buffer*/
+	NVIC_DisableIRQ(DAC0_IRQ);
+	PDB_stop();
+	DAC_bufferDisable(DAC_0);
+	/*Loads to the DACs, an output value of 0*/
+	DAC_loadValues(DAC_0,0);
+	DAC_loadValues(DAC_1,0);
+	/*Disables the DACs*/
+	DAC_disable(DAC_0);
+	DAC_disable(DAC_1);
 	/*RGB green led, is off*/
 	GPIO_setPIN(GPIOE,BIT26); //LED RGB VERDE
 	/*Verifies that the LEDs corresponding to this process, are off*/
-	GPIO_clearPIN(GPIOC,BIT10); //LED1
-	GPIO_clearPIN(GPIOC,BIT11); //LED2
+	GPIO_clearPINS(GPIOC,LED1_MASK|LED2_MASK);
+	/*The MCU can sleep in VLPS again*/
+	IDLEMANAGER_busClockNeeded(IDLEMANAGER_WAVEGEN, FALSE);
 
 }
 
 void WAVEGEN_ledSequence(){
-	/*As there are 3 fixed states for LEDs, those 3 states are covered in the following
-	 * sentences*/
-	/*If both LEDs are supposed to be on, they are set on */
-	if( ( currentState->LED1_state == BIT_ON ) && ( currentState->LED2_state == BIT_ON ) ){
-		GPIO_setPIN(GPIOC,BIT10); //LED1
-		GPIO_setPIN(GPIOC,BIT11); //LED2
-	/*If LED1 is supposed to be on, and LED2 is supposed to be off, we configure that way*/
-	} else if ( ( currentState->LED1_state == BIT_ON ) && ( currentState->LED2_state == BIT_OFF) ){
-		GPIO_setPIN(GPIOC,BIT10); //LED1
-		GPIO_clearPIN(GPIOC,BIT11); //LED2
-	/*Finally, the last case we can have, is when LED1 is off, and LED2 is on*/
-	} else {
-		GPIO_clearPIN(GPIOC,BIT10); //LED1
-		GPIO_setPIN(GPIOC,BIT11); //LED2
-	}
+	/*Both LEDs are updated at once: the ones that must be on are set, and the other ones are
+	 * cleared*/
+	GPIO_writePINS(GPIOC,LED1_MASK|LED2_MASK,
+			((currentState->LED1_state == BIT_ON)?(LED1_MASK):(0)) |
+			((currentState->LED2_state == BIT_ON)?(LED2_MASK):(0)));
 }
 
 
 
 void WAVEGEN_changeSequence(){
-	/*Always make sure the interruptions for PIT channel 0, are enabled*/
-	NVIC_EnableIRQ(PIT_CH0_IRQ);
 	/*Always make sure DAC, is enabled*/
-	DAC_enable();
+	DAC_enable(DAC_0);
+	if(outputMode == WAVEGEN_DUAL_MODE){
+		DAC_enable(DAC_1);
+	}
 	/*currentState, is now the next state*/
 	currentState = currentState->next;
+	if(outputMode == WAVEGEN_DMA_MODE){
+		/*The DMA now reads the array of the new state, from its first value*/
+		DMA_setSourceAddress(DMA_CH0,currentState->current_index);
+		/*Always make sure the DMA requests are enabled*/
+		DMA_requestEnable(DMA_CH0);
+	} else if(outputMode == WAVEGEN_BUFFERED_MODE){
+		/*Always make sure the interruptions for DAC0, are enabled*/
+		NVIC_EnableIRQ(DAC0_IRQ);
+	} else {
+		/*The flag left by the expiries before the first press is cleared, so the first sample is taken
+		 * at an expiry of the sample clock; Afterwards, the PIT channel 0 preempts this main loop
+		 * handler, so no sample is pending here*/
+		PIT_fastClearFlag(PIT_0);
+		/*Always make sure the interruptions for PIT channel 0, are enabled (ISR and dual modes)*/
+		NVIC_EnableIRQ(PIT_CH0_IRQ);
+	}
 	/*LEDs state are changed, according to the fixed sequence*/
 	currentState->fptrLedOutput();
 }
 
- void WAVEGEN_sendToDac(){
-	 /*index_shift, makes sure that the index is in the range of the elements of
-	  * the array*/
-	if(index_shift == 40){
-		index_shift = 0;
-	} else {
-		index_shift = index_shift + 1;
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function returns the value of an array of values for a phase
+ 	 \param[in] values beginning of the array of values
+ 	 \param[in] phase phase of the signal (a full period is 2^32)
+ 	 \return value to be loaded in the DAC
+
+ */
+static inline uint16 WAVEGEN_valueAtPhase(const uint16* values, uint32 phase){
+	/*The upper 16 bits of the phase are scaled to the period of the arrays (0 to WAVEGEN_TABLE_PERIOD - 1),
+	 * and the value of the pointer plus that index is returned*/
+	return *(values + (((phase >> 16)*WAVEGEN_TABLE_PERIOD) >> 16));
+}
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function moves the phase accumulator one sample, and takes the next samples of the
+ 	 	 signal and of the second channel, for the mixer
+ 	 \return void
+
+ */
+RAM_FUNCTION static void WAVEGEN_nextSamples(){
+	/*The phase accumulator overflows at the end of each period, so no range check is needed*/
+	phaseAccumulator += currentState->tuningWord;
+
+	/*The arrays go from 0 to 4095, and the mixer takes the samples around the middle of the scale*/
+	samplePairs[0] = MIXER_PACK(WAVEGEN_valueAtPhase(currentState->current_index,phaseAccumulator) - MIXER_MIDDLE,
+			WAVEGEN_valueAtPhase(secondChannelValues,phaseAccumulator + secondChannelOffset) - MIXER_MIDDLE);
+	/*Without gain, the synthesizer isn't taken, so its blocks aren't rendered again*/
+	if(!MIXER_sourceMixed(WAVEGEN_SYNTH_SOURCE)){
+		samplePairs[1] = 0;
+		return;
 	}
+	/*The synthesizer was rendered ahead of time, so only its next sample is taken*/
+	samplePairs[1] = MIXER_PACK(synthBlocks[synthBlock][synthSample],0);
 
-	/*Load to the DAC, the value of the pointer plus the index shift*/
-	DAC_loadValues(*(currentState->current_index + index_shift));
+	/*At the end of a block, the main loop renders it again while the other one is taken*/
+	if(++synthSample >= SYNTH_BLOCK_SIZE){
+		synthSample = 0;
+		synthReady[synthBlock] = FALSE;
+		EVENTQUEUE_push(EVENTQUEUE_SYNTH,synthBlock);
+		synthBlock ^= BIT_ON;
+		if(!synthReady[synthBlock]){
+			synthUnderruns++;
+		}
+	}
+}
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function moves the phase accumulator one sample, and returns the next value of the
+ 	 	 DAC0 channel of the mixer
+ 	 \return next value to be loaded in the DAC
+
+ */
+RAM_FUNCTION static uint16 WAVEGEN_nextValue(){
+	WAVEGEN_nextSamples();
+	return MIXER_output(MIXER_DAC0,samplePairs);
 }
 
-void WAVEGEN_indexShifting(){
-	 /*send to DAC the next value, according to the pointer and the index shift*/
+RAM_FUNCTION void WAVEGEN_sendToDac(){
+	if(outputMode == WAVEGEN_DUAL_MODE){
+		/*Both channels are mixed before any store, so only a store separates both outputs*/
+		WAVEGEN_nextSamples();
+		DAC_fastLoadValues(MIXER_output(MIXER_DAC0,samplePairs),MIXER_output(MIXER_DAC1,samplePairs));
+	} else {
+		/*Load to the DAC, the next value of the signal*/
+		DAC_fastLoadValue(DAC_0,WAVEGEN_nextValue());
+	}
+}
+
+RAM_FUNCTION void WAVEGEN_indexShifting(){
+	 /*send to DAC the next value, according to the phase accumulator; The PIT reloads the sample clock delay
+	  * by itself, so it isn't loaded again*/
 	 WAVEGEN_sendToDac();
-	 /*Set the delay again on the PIT*/
-	 PIT_delay(PIT_0,SYSTEM_CLOCK,DELAY);
 }
 
-void PORTA_IRQHandler()
-{
+RAM_FUNCTION void WAVEGEN_bufferRefill(uint8 flags){
+	/*index of the buffer to be loaded*/
+	uint8 bufferIndex;
+
+	/*Read pointer at zero; the upper half was already sent*/
+	if(flags & DAC_BUFFER_TOP){
+		for(bufferIndex = DAC_BUFFER_HALF; bufferIndex < DAC_BUFFER_SIZE; bufferIndex++){
+			DAC_fastBufferLoadValue(DAC_0,bufferIndex,WAVEGEN_nextValue());
+		}
+	}
+	/*Read pointer at the watermark; the lower half was already sent*/
+	if(flags & DAC_BUFFER_WATERMARK){
+		for(bufferIndex = 0; bufferIndex < DAC_BUFFER_HALF; bufferIndex++){
+			DAC_fastBufferLoadValue(DAC_0,bufferIndex,WAVEGEN_nextValue());
+		}
+	}
+}
+
+void WAVEGEN_switchPressed(uint8 pin){
 	/*Invoke the function for Wave Output Sequence*/
 	currentState->fptrWaveOutput();
+}
+
+void PORTA_IRQHandler()
+{
+	PROFILER_START(PROFILER_PORTA);
+	/*The press is attended in the main loop (WAVEGEN_switchPressed), if the edge isn't a bounce*/
+	if(GPIO_debounceAccept(GPIOA,BIT4)){
+		EVENTQUEUE_push(EVENTQUEUE_SW3,BIT4);
+	}
 	/*Clear interruption flags for PORT A*/
 	GPIO_clearInterrupt(GPIOA);
-	/*Digital debouncer*/
-	delay(30000);
-
+	PROFILER_STOP(PROFILER_PORTA);
 }
@@ -33,6 +33,55 @@
  * values in the triangle signal values*/
 #define TRIANGLE_SIGNAL_INDEX &triangleSignalValues[0]
 
+/*Number of values in a period of the square/sine/triangle signal arrays*/
+#define WAVEGEN_NUMBER_OF_SAMPLES 41
+/*The last value of the arrays is the same as the first one, so a full period has one value less*/
+#define WAVEGEN_TABLE_PERIOD (WAVEGEN_NUMBER_OF_SAMPLES - 1)
+/*Fixed sample clock (Hz) of the phase accumulator, in the ISR and buffered modes*/
+#define WAVEGEN_SAMPLE_RATE 2000
+/*Tuning word for a frequency in mHz; The phase accumulator (32 bits) completes a period each
+ * 2^32/tuningWord samples*/
+#define WAVEGEN_TUNING_WORD(milliHertz) ((uint32)(((uint64)(milliHertz) << 32)/(WAVEGEN_SAMPLE_RATE*1000ULL)))
+/*Output frequencies (mHz) must be below half of the sample rate*/
+#define WAVEGEN_MAX_FREQUENCY (WAVEGEN_SAMPLE_RATE*500)
+/*Default output frequency, 5Hz*/
+#define WAVEGEN_DEFAULT_FREQUENCY 5000
+/*Phase offset for an angle in degrees; A full period of the phase accumulator is 2^32*/
+#define WAVEGEN_PHASE_DEGREES(degrees) ((uint32)(((uint64)(degrees) << 32)/360))
+
+/*! These constants are used to select a signal of the wave generator*/
+typedef enum {WAVEGEN_SQUARE,  /*!< Square signal */
+			  WAVEGEN_SINE,    /*!< Sine signal */
+			  WAVEGEN_TRIANGLE /*!< Triangle signal */
+			 }WAVEGEN_SignalType;
+
+/*! These constants are used to select how the signal values reach the DAC; Except in the DMA mode, the
+ * values go through the mixer (MIXR.h), that sets the gain and offset of each DAC*/
+typedef enum {WAVEGEN_ISR_MODE, /*!< Each PIT channel 0 interruption loads the next value to the DAC */
+			  WAVEGEN_DMA_MODE, /*!< Each PIT channel 0 period triggers DMA channel 0, that copies the next value to the DAC */
+			  WAVEGEN_BUFFERED_MODE, /*!< The PDB moves the DAC buffer read pointer, and half of the buffer is loaded per DAC0 interruption */
+			  WAVEGEN_DUAL_MODE /*!< Each PIT channel 0 interruption loads the next value of the signal to the DAC0, and of the second channel to the DAC1 */
+			 }WAVEGEN_OutputModeType;
+
+/*Output mode after the reset, until WAVEGEN_setOutputMode is called; It can be given at build time*/
+#ifndef WAVEGEN_OUTPUT_MODE
+#define WAVEGEN_OUTPUT_MODE WAVEGEN_ISR_MODE
+#endif
+/*Signal and phase offset (degrees) of the second channel after the reset, until
+ * WAVEGEN_setSecondChannel is called; They can be given at build time*/
+#ifndef WAVEGEN_SECOND_SIGNAL
+#define WAVEGEN_SECOND_SIGNAL WAVEGEN_SINE
+#endif
+#ifndef WAVEGEN_SECOND_PHASE
+#define WAVEGEN_SECOND_PHASE 90
+#endif
+/*Mixer source of the synthesizer, and its gain (Q15) in the DAC0 after the reset; With 0, the
+ * synthesizer isn't rendered until MIXER_setGain gives it a gain. It can be given at build time*/
+#define WAVEGEN_SYNTH_SOURCE 2
+#ifndef WAVEGEN_SYNTH_GAIN
+#define WAVEGEN_SYNTH_GAIN 0
+#endif
+
 /*State machine definition; Linked state machine*/
 typedef struct state{
 	/*Pointer to a state machine 'next'; This pointer, has the direction of the next
@@ -47,6 +96,9 @@ typedef struct state{
 	 * for this state. It's constant, as it will always point to the same direction. Using
 	 * another counter, and by using pointers artihmetic, we can shift the index in the array*/
 	const uint16* current_index;
+	/*tuningWord, is the value added to the phase accumulator each sample; It sets the output frequency
+	 * of this state*/
+	uint32 tuningWord;
 	/*LED1_state; state of LED1 (ON or OFF)*/
 	uint8 LED1_state :1;
 	/*LED2_state; state of LED2 (ON or OFF)*/
@@ -90,6 +142,97 @@ static void WAVEGEN_ledSequence();
  */
 void WAVEGEN_enable();
 
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function selects how the signal values are sent to the DAC. The mode is taken on account
+ 	 	 the next time WAVEGEN_enable() is called.
+ 	 \param[in] outputMode WAVEGEN_ISR_MODE, WAVEGEN_DMA_MODE, WAVEGEN_BUFFERED_MODE or WAVEGEN_DUAL_MODE
+ 	 \return void
+
+ */
+void WAVEGEN_setOutputMode(WAVEGEN_OutputModeType outputMode);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function configures the second channel, the source 1 of the mixer, that is sent to the
+ 	 	 DAC1 in the dual mode (or mixed in the DAC0, with MIXER_setGain). It uses the same sample
+ 	 	 clock and phase accumulator as the signal of the sequence (source 0), so both have the
+ 	 	 frequency of the current state, and it can be changed while the signal is being produced. By
+ 	 	 default, it is a sine signal with a phase offset of 90 degrees, so with the sine signal of the
+ 	 	 sequence both outputs are in quadrature (sine and cosine).
+ 	 \param[in] signal WAVEGEN_SQUARE, WAVEGEN_SINE or WAVEGEN_TRIANGLE
+ 	 \param[in] phaseOffset phase of the second channel minus the phase of the DAC0 (WAVEGEN_PHASE_DEGREES)
+ 	 \return void
+
+ */
+void WAVEGEN_setSecondChannel(WAVEGEN_SignalType signal, uint32 phaseOffset);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function sets a voice of the additive synthesizer, the source 2 of the mixer (SNTH.h). The
+ 	 	 voices are rendered in blocks in the main loop, with the frequency of the current signal as the
+ 	 	 fundamental, so a change is heard up to two blocks later. It is called from the main loop. The
+ 	 	 voices are only rendered while a channel mixes the synthesizer with a gain other than 0
+ 	 	 (WAVEGEN_SYNTH_GAIN); To send it alone to the DAC0: MIXER_setGain(MIXER_DAC0,0,0) and
+ 	 	 MIXER_setGain(MIXER_DAC0,WAVEGEN_SYNTH_SOURCE,MIXER_UNITY_GAIN).
+ 	 \param[in] voice Voice (0 to SYNTH_VOICES - 1)
+ 	 \param[in] ratio Frequency of the voice over the fundamental (SYNTH_RATIO)
+ 	 \param[in] amplitude Q15 amplitude (MIXER_Q15)
+ 	 \return void
+
+ */
+void WAVEGEN_setVoice(uint8 voice, uint16 ratio, sint16 amplitude);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function sets the number of voices of the additive synthesizer that are rendered; It is
+ 	 	 called from the main loop.
+ 	 \param[in] voices Number of voices (1 to SYNTH_VOICES)
+ 	 \return void
+
+ */
+void WAVEGEN_setVoices(uint8 voices);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function returns the number of blocks of the synthesizer that the sample path started to
+ 	 	 take before the main loop rendered them (the previous samples of the block were sent again).
+ 	 \return Number of underruns
+
+ */
+uint32 WAVEGEN_synthUnderruns();
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function sets the output frequency of a signal, by changing its tuning word. The phase
+ 	 	 of the output isn't changed, so the change is done without glitches, even if the signal is
+ 	 	 being produced. It isn't taken on account in the DMA mode, where the arrays are sent as they are.
+ 	 \param[in] signal WAVEGEN_SQUARE, WAVEGEN_SINE or WAVEGEN_TRIANGLE
+ 	 \param[in] milliHertz output frequency in mHz, below half of WAVEGEN_SAMPLE_RATE
+ 	 	 (WAVEGEN_MAX_FREQUENCY)
+ 	 \return TRUE if the frequency was set; FALSE for an unknown signal, or a frequency out of range
+
+ */
+BooleanType WAVEGEN_setFrequency(WAVEGEN_SignalType signal, uint32 milliHertz);
+
 /********************************************************************************************/
 /********************************************************************************************/
 /********************************************************************************************/
@@ -119,8 +262,9 @@ void WAVEGEN_changeSequence();
 /********************************************************************************************/
 /*!
  	 \brief
- 	 	 This function manages the index shifting, in order to send to the DAC (load in the
- 	 	 DAC registers) the proper value from the array of values.
+ 	 	 This function moves the phase accumulator, in order to send to the DAC (load in the
+ 	 	 DAC registers) the proper value from the array of values. In the dual mode, both values
+ 	 	 are computed before, and loaded to the DAC0 and the DAC1 in consecutive stores.
  	 \return void
 
  */
@@ -131,11 +275,38 @@ void WAVEGEN_sendToDac();
 /********************************************************************************************/
 /*!
  	 \brief
- 	 	 This function is manages the index shifting, and PIT delay loading. Invokes
- 	 	 WAVEGEN_sendToDac() function, and sets the delay in PIT.
+ 	 	 This function is invoked from the PIT channel 0 interruption, in the ISR mode. Invokes
+ 	 	 WAVEGEN_sendToDac() function.
  	 \return void
 
  */
 void WAVEGEN_indexShifting();
 
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function is invoked from the DAC0 interruption in the buffered mode. It loads the half
+ 	 	 of the DAC buffer that was already sent to the output, with the next values of the signal.
+ 	 \param[in] flags DAC buffer flags that caused the interruption (DAC_BUFFER_TOP: the upper half
+ 	 	 was sent; DAC_BUFFER_WATERMARK: the lower half was sent)
+ 	 \return void
+
+ */
+void WAVEGEN_bufferRefill(uint8 flags);
+
+/********************************************************************************************/
+/********************************************************************************************/
+/********************************************************************************************/
+/*!
+ 	 \brief
+ 	 	 This function is invoked from the main loop, when the SW3 has been pressed. Invokes the
+ 	 	 function of the current state that changes the signal.
+ 	 \param[in] pin Pin of the switch (BIT4)
+ 	 \return void
+
+ */
+void WAVEGEN_switchPressed(uint8 pin);
+
 #endif /* SOURCES_WVGN_H_ */
@@ -36,6 +36,14 @@
 #include "WVGN.h"
 #include "PSSWRD.h"
 #include "MTRCTRL.h"
+#include "PRFL.h"
+#include "EVNTQ.h"
+#include "TMRWHL.h"
+#include "MTRSCH.h"
+#include "IDLMGR.h"
+#include "BRDCFG.h"
+#include "CLKMGR.h"
+#include "PWRGOV.h"
 
 //static int i = 0;
 
@@ -43,35 +51,45 @@ int main(void)
 {
     /* Write your code here */
 
-	/*Configurations for LED RGB*/
-	GPIO_clockGating(GPIOB);
-	GPIO_clockGating(GPIOE);
-	GPIO_pinControlRegisterType pinControlRegisterPORTB = GPIO_MUX1;
-	GPIO_pinControlRegisterType pinControlRegisterPORTE = GPIO_MUX1;
-	GPIO_pinControlRegister(GPIOB,BIT21,&pinControlRegisterPORTB);
-	GPIO_pinControlRegister(GPIOB,BIT22,&pinControlRegisterPORTB);
-	GPIO_pinControlRegister(GPIOE,BIT26,&pinControlRegisterPORTE);
-	GPIO_setPIN(GPIOB,BIT21); //LED RGB AZUL
-	GPIO_setPIN(GPIOB,BIT22); //LED RGB ROJO
-	GPIO_setPIN(GPIOE,BIT26); //LED RGB VERDE
- 	GPIO_dataDirectionPIN(GPIOB,GPIO_OUTPUT,BIT21);
-	GPIO_dataDirectionPIN(GPIOB,GPIO_OUTPUT,BIT22);
-	GPIO_dataDirectionPIN(GPIOE,GPIO_OUTPUT,BIT26);
+	/*Pins (LED RGB, keyboard, switches, LEDs and motor), clocks and interruptions of the board*/
+	BOARDCONFIG_init();
+	/*PLL: 120MHz core, 60MHz bus and 24MHz flash; The timers take the bus clock from here*/
+	CLOCKMANAGER_init(CLOCKMANAGER_PEE_120MHZ);
+
+	/*Sleep modes, and the LPTMR time base used by the debouncing*/
+	IDLEMANAGER_init();
+	/*Input events from the interruptions to the main loop*/
+	EVENTQUEUE_init();
+	/*Logical timers of the processes, on PIT channel 2*/
+	TIMERWHEEL_init();
+	/*Programs of the motors, on PIT channel 3*/
+	MOTORSCHEDULER_init();
 
 	/*initialize the three processes*/
 	WAVEGEN_init();
 	PASSWORD_init();
 	MOTORCONTROL_init();
 
+	/*Cycle counter for the interruption profiler (only with PROFILER_ENABLE)*/
+	PROFILER_init();
+
+	/*No process is enabled yet, so the MCU runs in VLPR until the password process enables one*/
+	POWERGOVERNOR_init();
+
+	/*Boot time, from BOARDCONFIG_init*/
+	BOARDCONFIG_ready();
+
 	/*Sets the threshold*/
 	NVIC_setBASEPRI_threshold(PRIORITY_15);
 
 	/*Enables the interruptions*/
 	EnableInterrupts;
 
-    /* This for loop should be replaced. By default this loop allows a single stepping. */
+    /* The inputs (keyboard, SW2, SW3) are attended here, out of the interruptions; Then
+     * the MCU sleeps until the next interruption */
     for (;;) {
-
+    	EVENTQUEUE_dispatch();
+    	IDLEMANAGER_idle();
     }
     /* Never leave main */
     return 0;